@@ -5,6 +5,7 @@
 
 #include "ExternalAI/Interface/AISEvents.h"
 #include "ExternalAI/Interface/AISCommands.h"
+#include "ExternalAI/Interface/SSkirmishAICallback.h"
 
 // generated by the C++ Wrapper scripts
 #include "OOAICallback.h"
@@ -14,9 +15,16 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <chrono>
 
-cpptestai::CCppTestAI::CCppTestAI(springai::OOAICallback* callback):
+// how often the unit-state benchmark runs, in frames
+static const int BENCHMARK_INTERVAL = 30 * 30;
+static const int BENCHMARK_ROUNDS = 10;
+
+cpptestai::CCppTestAI::CCppTestAI(springai::OOAICallback* callback, const struct SSkirmishAICallback* innerCallback):
 		callback(callback),
+		innerCallback(innerCallback),
 		skirmishAIId(callback != NULL ? callback->GetSkirmishAIId() : -1)
 		{}
 
@@ -28,9 +36,69 @@ static inline std::string IntToString(int i, const std::string& format = "%i")
 	SNPRINTF(buf, sizeof(buf), format.c_str(), i);
 	return std::string(buf);
 }
+
+void cpptestai::CCppTestAI::BenchmarkUnitsState() {
+	typedef std::chrono::steady_clock Clock;
+
+	if (innerCallback == NULL || innerCallback->getUnitsState == NULL)
+		return;
+
+	std::vector<int> unitIds(innerCallback->Unit_getMax(skirmishAIId));
+	int numUnitIds = 0;
+
+	numUnitIds += innerCallback->getFriendlyUnits(skirmishAIId, &unitIds[numUnitIds], unitIds.size() - numUnitIds);
+	numUnitIds += innerCallback->getEnemyUnitsInRadarAndLos(skirmishAIId, &unitIds[numUnitIds], unitIds.size() - numUnitIds);
+
+	if (numUnitIds == 0)
+		return;
+
+	std::vector<float> positions(numUnitIds * 3);
+	std::vector<float> healths(numUnitIds);
+	std::vector<int> unitDefIds(numUnitIds);
+	std::vector<int> losStates(numUnitIds);
+
+	// keeps the per-unit results from being optimized away
+	float checkSum = 0.0f;
+
+	const Clock::time_point t0 = Clock::now();
+
+	for (int r = 0; r < BENCHMARK_ROUNDS; ++r) {
+		for (int i = 0; i < numUnitIds; ++i) {
+			innerCallback->Unit_getPos(skirmishAIId, unitIds[i], &positions[i * 3]);
+			healths[i] = innerCallback->Unit_getHealth(skirmishAIId, unitIds[i]);
+			unitDefIds[i] = innerCallback->Unit_getDef(skirmishAIId, unitIds[i]);
+		}
+		checkSum += healths[r % numUnitIds];
+	}
+
+	const Clock::time_point t1 = Clock::now();
+
+	for (int r = 0; r < BENCHMARK_ROUNDS; ++r) {
+		innerCallback->getUnitsState(skirmishAIId, &unitIds[0], numUnitIds, &positions[0], &healths[0], &unitDefIds[0], &losStates[0]);
+		checkSum += healths[r % numUnitIds];
+	}
+
+	const Clock::time_point t2 = Clock::now();
+
+	const long long perUnitTime = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+	const long long bulkTime = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+	char msg[256];
+	SNPRINTF(msg, sizeof(msg), "[CppTestAI] unit-state of %i units x%i: per-unit %lldus, bulk %lldus (checksum %f)", numUnitIds, BENCHMARK_ROUNDS, perUnitTime, bulkTime, checkSum);
+	innerCallback->Log_log(skirmishAIId, msg);
+}
+
 int cpptestai::CCppTestAI::HandleEvent(int topic, const void* data) {
 
 	switch (topic) {
+		case EVENT_UPDATE: {
+			const struct SUpdateEvent* evt = (const struct SUpdateEvent*) data;
+
+			if (evt->frame > 0 && (evt->frame % BENCHMARK_INTERVAL) == 0)
+				BenchmarkUnitsState();
+
+			break;
+		}
 		case EVENT_UNIT_CREATED: {
 			//struct SUnitCreatedEvent* evt = (struct SUnitCreatedEvent*) data;
 			//int unitId = evt->unit;
@@ -6,6 +6,8 @@
 // generated by the C++ Wrapper scripts
 #include "OOAICallback.h"
 
+struct SSkirmishAICallback;
+
 namespace cpptestai {
 
 /**
@@ -17,10 +19,17 @@ class CCppTestAI {
 
 private:
 	springai::OOAICallback* callback;
+	const struct SSkirmishAICallback* innerCallback;
 	int skirmishAIId;
 
+	/**
+	 * Compares the per-unit getters against the bulk getUnitsState
+	 * callback for all units known to this AI, and logs the timings.
+	 */
+	void BenchmarkUnitsState();
+
 public:
-	CCppTestAI(springai::OOAICallback* callback);
+	CCppTestAI(springai::OOAICallback* callback, const struct SSkirmishAICallback* innerCallback = NULL);
 	~CCppTestAI();
 
 	int HandleEvent(int topic, const void* data);
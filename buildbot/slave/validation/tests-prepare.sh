@@ -15,6 +15,7 @@ $PRDL --download-map "$MAP"
 echo "Creating script: test/validation/prepare.sh \"$GAME1\" \"$MAP\" \"$AI\" \"$AIVER\""
 ${SOURCEDIR}/test/validation/prepare.sh "$GAME1" "$MAP" "$AI" "$AIVER" 8452 > ${CONTENT_DIR}/script.txt
 ${SOURCEDIR}/test/validation/prepare-client.sh ValidationClient localhost 8452 >${CONTENT_DIR}/connect.txt
+${SOURCEDIR}/test/validation/prepare-snapshot.sh "$GAME1" "$MAP" "$AI" "$AIVER" > ${CONTENT_DIR}/snapshot.txt
 
 #install required files into spring dir
 cd ${SOURCEDIR}
@@ -30,6 +31,8 @@ done
 #copy widget + config
 cp -suv ${SOURCEDIR}/test/validation/LuaUI/Widgets/test.lua ${CONTENT_DIR}/LuaUI/Widgets/test.lua
 cp -suv ${SOURCEDIR}/test/validation/LuaUI/Widgets/test.lua ${CONTENT_DIR}/LuaUI/Widgets_BA/test.lua
+cp -suv ${SOURCEDIR}/test/validation/LuaUI/Widgets/snapshot.lua ${CONTENT_DIR}/LuaUI/Widgets/snapshot.lua
+cp -suv ${SOURCEDIR}/test/validation/LuaUI/Widgets/snapshot.lua ${CONTENT_DIR}/LuaUI/Widgets_BA/snapshot.lua
 cp -v ${SOURCEDIR}/test/validation/LuaUI/Config/ZK_data.lua ${CONTENT_DIR}/LuaUI/Config/ZK_data.lua
 cp -v ${SOURCEDIR}/test/validation/LuaUI/Config/ZK_data.lua ${CONTENT_DIR}/LuaUI/Config/BA.lua
 
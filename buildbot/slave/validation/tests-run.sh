@@ -8,5 +8,11 @@ set -e
 set +e
 #run test
 HOME=${TESTDIR} GAME=${GAME} ${SOURCEDIR}/test/validation/run.sh ${TESTDIR}/usr/local/bin/spring-headless script.txt
+EXIT=$?
+
+#run snapshot test
+HOME=${TESTDIR} ${SOURCEDIR}/test/validation/run-snapshot.sh ${TESTDIR}/usr/local/bin/spring-headless snapshot.txt || EXIT=$?
+
+exit $EXIT
 
 
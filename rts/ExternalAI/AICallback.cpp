@@ -808,7 +808,8 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 }
 
 
-static int myAllyTeamId = -1;
+// per-thread, asynchronous AIs filter concurrently with synchronous ones
+static _threadlocal int myAllyTeamId = -1;
 
 /// You have to set myAllyTeamId before calling this function. NOT thread safe!
 static inline bool unit_IsEnemy(const CUnit* unit) {
@@ -868,6 +869,7 @@ int CAICallback::GetEnemyUnits(int* unitIds, const float3& pos, float radius, bo
 {
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
 	myAllyTeamId = teamHandler.AllyTeam(team);
 	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsEnemyAndInLos);
@@ -886,6 +888,7 @@ int CAICallback::GetFriendlyUnits(int* unitIds, const float3& pos, float radius,
 {
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
 	myAllyTeamId = teamHandler.AllyTeam(team);
 	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsFriendly);
@@ -904,12 +907,68 @@ int CAICallback::GetNeutralUnits(int* unitIds, const float3& pos, float radius,
 {
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
 	myAllyTeamId = teamHandler.AllyTeam(team);
 	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsNeutralAndInLosOrRadar);
 }
 
 
+int CAICallback::GetUnitsState(const int* unitIds, int numUnitIds, float* positions, float* healths, int* unitDefIds, int* losStates)
+{
+	verify();
+
+	const int allyTeam = teamHandler.AllyTeam(team);
+	const unsigned short prevMask = (LOS_PREVLOS | LOS_CONTRADAR);
+	const unsigned short fullMask = (LOS_INLOS | LOS_INRADAR | prevMask);
+
+	int numVisible = 0;
+
+	// same visibility rules as the per-unit getters, resolved once per unit
+	for (int i = 0; i < numUnitIds; i++) {
+		const CUnit* unit = GetUnit(unitIds[i]);
+
+		float3 pos;
+		float health = -1.0f;
+		int unitDefId = -1;
+		unsigned short losStatus = 0;
+
+		if (unit != nullptr) {
+			const UnitDef* unitDef = unit->unitDef;
+			const UnitDef* decoyDef = unitDef->decoyDef;
+
+			if (teamHandler.Ally(unit->allyteam, allyTeam)) {
+				losStatus = fullMask;
+				decoyDef = nullptr;
+			} else {
+				losStatus = unit->losStatus[allyTeam] & fullMask;
+			}
+
+			if ((losStatus & (LOS_INLOS | LOS_INRADAR)) != 0) {
+				pos = unit->GetErrorPos(allyTeam);
+				numVisible += 1;
+			}
+
+			if ((losStatus & LOS_INLOS) != 0)
+				health = (decoyDef == nullptr)? unit->health: (unit->health * (decoyDef->health / unitDef->health));
+
+			if ((losStatus & LOS_INLOS) != 0 || (losStatus & prevMask) == prevMask)
+				unitDefId = (decoyDef == nullptr)? unitDef->id: decoyDef->id;
+		}
+
+		if (positions != nullptr)
+			pos.copyInto(&positions[i * 3]);
+		if (healths != nullptr)
+			healths[i] = health;
+		if (unitDefIds != nullptr)
+			unitDefIds[i] = unitDefId;
+		if (losStates != nullptr)
+			losStates[i] = losStatus;
+	}
+
+	return numVisible;
+}
+
 
 
 int CAICallback::GetMapWidth()
@@ -1235,6 +1294,7 @@ int CAICallback::GetFeatures(int* featureIds, int maxFeatureIDs, const float3& p
 
 	verify();
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetFeaturesExact(qfQuery, pos, radius, spherical);
 	const int allyteam = teamHandler.AllyTeam(team);
 
@@ -129,6 +129,7 @@ public:
 	int GetFriendlyUnits(int* unitIds, const float3& pos, float radius, bool spherical = true, int unitIds_max = -1);
 	int GetNeutralUnits(int* unitIds, int unitIds_max = -1);
 	int GetNeutralUnits(int* unitIds, const float3& pos, float radius, bool spherical = true, int unitIds_max = -1);
+	int GetUnitsState(const int* unitIds, int numUnitIds, float* positions, float* healths, int* unitDefIds, int* losStates);
 
 
 	int GetMapWidth();
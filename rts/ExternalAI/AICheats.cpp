@@ -5,6 +5,7 @@
 #include "ExternalAI/SkirmishAIWrapper.h"
 #include "Game/TraceRay.h"
 #include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitDef.h"
 #include "Sim/Units/CommandAI/CommandAI.h"
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/GlobalConstants.h" // needed for MAX_UNITS
@@ -150,7 +151,8 @@ static inline bool unit_IsNeutral(CUnit* unit) {
 	return unit->IsNeutral();
 }
 
-static int myAllyTeamId = -1;
+// per-thread, asynchronous AIs filter concurrently with synchronous ones
+static _threadlocal int myAllyTeamId = -1;
 
 /// You have to set myAllyTeamId before callign this function. NOT thread safe!
 static inline bool unit_IsEnemy(CUnit* unit) {
@@ -168,6 +170,7 @@ int CAICheats::GetEnemyUnits(int* unitIds, const float3& pos, float radius, bool
 		int unitIds_max)
 {
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
 	myAllyTeamId = teamHandler.AllyTeam(ai->GetTeamId());
 	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsEnemy);
@@ -182,10 +185,44 @@ int CAICheats::GetNeutralUnits(int* unitIds, const float3& pos, float radius, bo
 		int unitIds_max)
 {
 	QuadFieldQuery qfQuery;
+	qfQuery.threadOwner = ThreadPool::GetThreadNum();
 	quadField.GetUnitsExact(qfQuery, pos, radius, spherical);
 	return FilterUnitsVector(*qfQuery.units, unitIds, unitIds_max, &unit_IsNeutral);
 }
 
+int CAICheats::GetUnitsState(const int* unitIds, int numUnitIds, float* positions, float* healths, int* unitDefIds, int* losStates)
+{
+	int numVisible = 0;
+
+	for (int i = 0; i < numUnitIds; i++) {
+		const CUnit* unit = GetUnit(unitIds[i]);
+
+		float3 pos;
+		float health = -1.0f;
+		int unitDefId = -1;
+		int losStatus = 0;
+
+		if (unit != nullptr) {
+			pos = unit->midPos;
+			health = unit->health;
+			unitDefId = unit->unitDef->id;
+			losStatus = (LOS_INLOS | LOS_INRADAR | LOS_PREVLOS | LOS_CONTRADAR);
+			numVisible += 1;
+		}
+
+		if (positions != nullptr)
+			pos.copyInto(&positions[i * 3]);
+		if (healths != nullptr)
+			healths[i] = health;
+		if (unitDefIds != nullptr)
+			unitDefIds[i] = unitDefId;
+		if (losStates != nullptr)
+			losStates[i] = losStatus;
+	}
+
+	return numVisible;
+}
+
 int CAICheats::GetFeatures(int* features, int max) const {
 	// this method is never called anyway, see SSkirmishAICallbackImpl.cpp
 	return 0;
@@ -43,6 +43,7 @@ public:
 	int GetEnemyUnits(int* unitIds, const float3& pos, float radius, bool spherical = true, int unitIds_max = -1);
 	int GetNeutralUnits(int* unitIds, int unitIds_max = -1);
 	int GetNeutralUnits(int* unitIds, const float3& pos, float radius, bool spherical = true, int unitIds_max = -1);
+	int GetUnitsState(const int* unitIds, int numUnitIds, float* positions, float* healths, int* unitDefIds, int* losStates);
 
 	int GetFeatures(int* features, int max) const;
 	int GetFeatures(int* features, int max, const float3& pos, float radius, bool spherical) const;
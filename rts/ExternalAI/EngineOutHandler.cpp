@@ -12,6 +12,7 @@
 #include "Game/Players/PlayerHandler.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/LosHandler.h"
+#include "Sim/Misc/ResourceHandler.h"
 #include "Sim/Misc/Team.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Units/Unit.h"
@@ -19,9 +20,17 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Weapons/WeaponDef.h"
 #include "Net/Protocol/NetProtocol.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
+#include "System/MainDefines.h"
 #include "System/TimeProfiler.h"
 #include "System/SafeUtil.h"
+#include "System/Platform/Threading.h"
+#include "System/Threading/ThreadPool.h"
+
+#include <algorithm>
+
+CONFIG(bool, AsyncSkirmishAI).defaultValue(false).description("Whether native Skirmish AIs handle their events on a separate thread while the simulation waits for the next frame. Commands are unaffected since they are always deferred through the network.");
 
 
 CR_BIND(CEngineOutHandler, )
@@ -29,6 +38,12 @@ CR_REG_METADATA(CEngineOutHandler, (
 	CR_IGNORED(hostSkirmishAIs),
 	CR_IGNORED(teamSkirmishAIs),
 	CR_IGNORED(activeSkirmishAIs),
+	CR_IGNORED(asyncSkirmishAIs),
+	CR_IGNORED(asyncThread),
+	CR_IGNORED(asyncMutex),
+	CR_IGNORED(asyncCond),
+	CR_IGNORED(asyncBatchPending),
+	CR_IGNORED(asyncThreadExit),
 
 	CR_POSTLOAD(PostLoad)
 ))
@@ -47,6 +62,8 @@ static inline bool IsUnitInLosOrRadarOfAllyTeam(const CUnit& unit, const int all
 static CEngineOutHandler singleton;
 static unsigned int numInstances = 0;
 
+static _threadlocal bool isAsyncSkirmishAIThread = false;
+
 CEngineOutHandler* CEngineOutHandler::GetInstance() {
 	// if more than one instance, some code called eoh->func()
 	// and created another after Destroy was already executed
@@ -90,17 +107,20 @@ void CEngineOutHandler::Destroy() {
 
 void CEngineOutHandler::PostLoad()
 {
+	WaitForAsyncSkirmishAIs();
 	AI_SCOPED_TIMER();
 	DO_FOR_SKIRMISH_AIS(PostLoad())
 }
 
 void CEngineOutHandler::PreDestroy() {
+	WaitForAsyncSkirmishAIs();
 	AI_SCOPED_TIMER();
 	DO_FOR_SKIRMISH_AIS(PreDestroy())
 }
 
 
 void CEngineOutHandler::Load(std::istream* s, const uint8_t skirmishAIId) {
+	WaitForAsyncSkirmishAIs();
 	AI_SCOPED_TIMER();
 	LOG_L(L_INFO, "[EOH::%s(id=%u)] active=%d", __func__, skirmishAIId, hostSkirmishAIs[skirmishAIId].Active());
 
@@ -113,6 +133,7 @@ void CEngineOutHandler::Load(std::istream* s, const uint8_t skirmishAIId) {
 }
 
 void CEngineOutHandler::Save(std::ostream* s, const uint8_t skirmishAIId) {
+	WaitForAsyncSkirmishAIs();
 	AI_SCOPED_TIMER();
 	LOG_L(L_INFO, "[EOH::%s(id=%u)] active=%d", __func__, skirmishAIId, hostSkirmishAIs[skirmishAIId].Active());
 
@@ -131,6 +152,83 @@ void CEngineOutHandler::Update() {
 }
 
 
+bool CEngineOutHandler::IsAsyncSkirmishAIThread() { return isAsyncSkirmishAIThread; }
+
+void CEngineOutHandler::RunAsyncSkirmishAIs() {
+	if (asyncSkirmishAIs.empty())
+		return;
+
+	const auto HasQueuedEvents = [&](uint8_t aiID) { return (hostSkirmishAIs[aiID].HasQueuedEvents()); };
+
+	if (std::none_of(asyncSkirmishAIs.begin(), asyncSkirmishAIs.end(), HasQueuedEvents))
+		return;
+
+	{
+		std::lock_guard<spring::mutex> lock(asyncMutex);
+		asyncBatchPending = true;
+	}
+
+	asyncCond.notify_all();
+}
+
+void CEngineOutHandler::WaitForAsyncSkirmishAIs() {
+	if (asyncSkirmishAIs.empty())
+		return;
+
+	SCOPED_TIMER("AI");
+
+	std::unique_lock<spring::mutex> lock(asyncMutex);
+	asyncCond.wait(lock, [&]() { return (!asyncBatchPending); });
+}
+
+void CEngineOutHandler::AsyncSkirmishAIThreadFunc() {
+	Threading::SetThreadName("skirmishai");
+
+	// claim the per-thread scratch slot reserved for us, the callback reaches QuadField queries
+	ThreadPool::SetAuxThreadNum();
+
+	isAsyncSkirmishAIThread = true;
+
+	while (true) {
+		{
+			std::unique_lock<spring::mutex> lock(asyncMutex);
+			asyncCond.wait(lock, [&]() { return (asyncBatchPending || asyncThreadExit); });
+
+			if (asyncThreadExit)
+				break;
+		}
+
+		// AIs are run one after another, which keeps their callbacks' shared state safe
+		for (uint8_t aiID: asyncSkirmishAIs) {
+			hostSkirmishAIs[aiID].ProcessQueuedEvents();
+		}
+
+		{
+			std::lock_guard<spring::mutex> lock(asyncMutex);
+			asyncBatchPending = false;
+		}
+
+		asyncCond.notify_all();
+	}
+}
+
+void CEngineOutHandler::StopAsyncSkirmishAIThread() {
+	if (!asyncThread.joinable())
+		return;
+
+	{
+		std::lock_guard<spring::mutex> lock(asyncMutex);
+		asyncThreadExit = true;
+	}
+
+	asyncCond.notify_all();
+	asyncThread.join();
+
+	asyncBatchPending = false;
+	asyncThreadExit = false;
+}
+
+
 
 // Do only if the unit is not allied, in which case we know
 // everything about it anyway, and do not need to be informed
@@ -482,6 +580,7 @@ void CEngineOutHandler::SendChatMessage(const char* msg, int fromPlayerId) {
 }
 
 bool CEngineOutHandler::SendLuaMessages(int aiTeam, const char* inData, std::vector<const char*>& outData) {
+	WaitForAsyncSkirmishAIs();
 	SCOPED_TIMER("AI");
 
 	if (activeSkirmishAIs.empty())
@@ -554,6 +653,17 @@ void CEngineOutHandler::CreateSkirmishAI(const uint8_t skirmishAIId, bool savedG
 	if (!savedGame)
 		aiInst.PostLoad();
 
+	if (configHandler->GetBool("AsyncSkirmishAI") && ThreadPool::HasThreads()) {
+		// the lazy analyzer Init uses for_mt and writes a cache file, do it here on the sim thread
+		resourceHandler->InitResourceMapAnalyzers();
+
+		aiInst.SetAsyncEvents(true);
+		asyncSkirmishAIs.push_back(skirmishAIId);
+
+		if (!asyncThread.joinable())
+			asyncThread = spring::thread(&CEngineOutHandler::AsyncSkirmishAIThreadFunc, this);
+	}
+
 	clientNet->Send(CBaseNetProtocol::Get().SendAIStateChanged(gu->myPlayerNum, skirmishAIId, SKIRMAISTATE_ALIVE));
 }
 
@@ -567,9 +677,17 @@ void CEngineOutHandler::PostLoadSkirmishAI(const uint8_t skirmishAIId) {
 }
 
 void CEngineOutHandler::DestroySkirmishAI(const uint8_t skirmishAIId) {
+	WaitForAsyncSkirmishAIs();
 	SCOPED_TIMER("AI");
 	LOG_L(L_INFO, "[EOH::%s(id=%u)]", __func__, skirmishAIId);
 
+	{
+		const auto kt = std::find(asyncSkirmishAIs.begin(), asyncSkirmishAIs.end(), skirmishAIId);
+
+		if (kt != asyncSkirmishAIs.end())
+			asyncSkirmishAIs.erase(kt);
+	}
+
 	const int teamID = hostSkirmishAIs[skirmishAIId].GetTeamId();
 
 	const auto it = std::find(teamSkirmishAIs[teamID].begin(), teamSkirmishAIs[teamID].end(), skirmishAIId);
@@ -6,6 +6,7 @@
 #include "SkirmishAIWrapper.h"
 #include "System/Object.h"
 #include "Sim/Misc/GlobalConstants.h"
+#include "System/Threading/SpringThreading.h"
 
 #include <array>
 #include <vector>
@@ -34,6 +35,7 @@ public:
 	void Init() { activeSkirmishAIs.reserve(16); }
 	void Kill() {
 		PreDestroy();
+		StopAsyncSkirmishAIThread();
 
 		// release leftover active AI's
 		while (!activeSkirmishAIs.empty()) {
@@ -49,6 +51,16 @@ public:
 
 	void Update();
 
+	/**
+	 * Lets the asynchronous AI thread handle all events queued since the
+	 * last call; must only be called while the simulation is not running.
+	 */
+	void RunAsyncSkirmishAIs();
+	/** Blocks until the asynchronous AI thread has processed its batch. */
+	void WaitForAsyncSkirmishAIs();
+
+	static bool IsAsyncSkirmishAIThread();
+
 	/** Group should return false if it doenst want the unit for some reason. */
 	bool UnitAddedToGroup(const CUnit& unit, const CGroup& group);
 	/** No way to refuse giving up a unit. */
@@ -106,6 +118,10 @@ public:
 	void Load(std::istream* s, const uint8_t skirmishAIId);
 	void Save(std::ostream* s, const uint8_t skirmishAIId);
 
+private:
+	void AsyncSkirmishAIThreadFunc();
+	void StopAsyncSkirmishAIThread();
+
 private:
 	/// Contains all local Skirmish AIs, indexed by their ID
 	std::array<CSkirmishAIWrapper, MAX_AIS > hostSkirmishAIs;
@@ -117,6 +133,15 @@ private:
 	std::array<std::vector<uint8_t>, MAX_TEAMS> teamSkirmishAIs;
 
 	std::vector<uint8_t> activeSkirmishAIs;
+	/// subset of activeSkirmishAIs whose events are handled by asyncThread
+	std::vector<uint8_t> asyncSkirmishAIs;
+
+	spring::thread asyncThread;
+	spring::mutex asyncMutex;
+	spring::condition_variable asyncCond;
+
+	bool asyncBatchPending = false;
+	bool asyncThreadExit = false;
 };
 
 #define eoh CEngineOutHandler::GetInstance()
@@ -2256,6 +2256,21 @@ struct SSkirmishAICallback {
 
 	bool              (CALLING_CONV *Debug_GraphDrawer_isEnabled)(int skirmishAIId);
 
+	/**
+	 * Bulk variant of Unit_getPos, Unit_getHealth and Unit_getDef, which
+	 * resolves the visibility of each unit only once.
+	 * Entry i of each output array belongs to unitIds[i]; positions holds
+	 * 3 floats per unit. Any output array may be NULL to skip it.
+	 * Units not visible to this AI get a zero position, health -1 and def -1.
+	 * losStates receives the unit's LOS-bits for this AI's ally-team:
+	 * 1 = in LOS, 2 = in radar, 4 = previously in LOS,
+	 * 8 = continuously in radar since last in LOS;
+	 * allied units (and all units when cheating) report all bits set.
+	 * Appended at the end of this struct to keep it binary compatible.
+	 * @return the number of units whose position is known
+	 */
+	int               (CALLING_CONV *getUnitsState)(int skirmishAIId, int* unitIds, int unitIds_size, float* positions, float* healths, int* unitDefIds, int* losStates);
+
 };
 
 #if	defined(__cplusplus)
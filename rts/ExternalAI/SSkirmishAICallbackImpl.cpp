@@ -3,6 +3,7 @@
 #include "ExternalAI/AICallback.h"
 #include "ExternalAI/AICheats.h"
 #include "ExternalAI/AILibraryManager.h"
+#include "ExternalAI/EngineOutHandler.h"
 #include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/SkirmishAILibraryInfo.h"
 #include "ExternalAI/SkirmishAIWrapper.h"
@@ -108,6 +109,11 @@ static bool isControlledByLocalPlayer(int skirmishAIId) {
 	return (gu->myTeam == AI_TEAM_IDS[skirmishAIId]);
 }
 
+/// selection, UI groups and the GUI order preview are mutated by the main thread while async AIs run
+static bool isUIStateReadable() {
+	return (!CEngineOutHandler::IsAsyncSkirmishAIThread());
+}
+
 
 static const CUnit* getUnit(int unitId) {
 	return (unitHandler.GetUnit(unitId));
@@ -207,14 +213,13 @@ static float getRulesParamFloatValueByName(
 	float defaultValue
 ) {
 	float value = defaultValue;
-	const std::string key(rulesParamName);
-	const auto it = params.find(key);
+	const LuaRulesParams::Param* param = params.Find(rulesParamName);
 
-	if (it == params.end())
+	if (param == nullptr)
 		return value;
 
-	if (modParamIsVisible(it->second, losMask))
-		value = it->second.valueInt;
+	if (modParamIsVisible(*param, losMask))
+		value = param->valueInt;
 
 	return value;
 }
@@ -226,14 +231,13 @@ static const char* getRulesParamStringValueByName(
 	const char* defaultValue
 ) {
 	const char* value = defaultValue;
-	const std::string key(rulesParamName);
-	const auto it = params.find(key);
+	const LuaRulesParams::Param* param = params.Find(rulesParamName);
 
-	if (it == params.end())
+	if (param == nullptr)
 		return value;
 
-	if (modParamIsVisible(it->second, losMask))
-		value = it->second.valueString.c_str();
+	if (modParamIsVisible(*param, losMask))
+		value = params.IsString(*param)? params.GetString(*param).c_str(): "";
 
 	return value;
 }
@@ -261,6 +265,38 @@ static inline const FeatureDef* getFeatureDefById(int skirmishAIId, int featureD
 }
 
 
+/// commands touching state owned by the main thread (Lua, drawers, paths, UI groups, cheats)
+static bool IsMainThreadCommand(int commandTopic) {
+	switch (commandTopic) {
+		case COMMAND_CHEATS_SET_MY_INCOME_MULTIPLIER:
+		case COMMAND_CHEATS_GIVE_ME_RESOURCE:
+		case COMMAND_CHEATS_GIVE_ME_NEW_UNIT:
+		case COMMAND_SET_LAST_POS_MESSAGE:
+		case COMMAND_GROUP_CREATE:
+		case COMMAND_GROUP_ERASE:
+		case COMMAND_GROUP_ADD_UNIT:
+		case COMMAND_GROUP_REMOVE_UNIT:
+		case COMMAND_UNIT_GROUP_ADD:
+		case COMMAND_UNIT_GROUP_CLEAR:
+		case COMMAND_PATH_INIT:
+		case COMMAND_PATH_GET_APPROXIMATE_LENGTH:
+		case COMMAND_PATH_GET_NEXT_WAYPOINT:
+		case COMMAND_PATH_FREE:
+		case COMMAND_CALL_LUA_RULES:
+		case COMMAND_CALL_LUA_UI:
+		case COMMAND_TRACE_RAY:
+		case COMMAND_TRACE_RAY_FEATURE: {
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	// notifications, unit/path drawers, figures and the debug drawer
+	return ((commandTopic >= COMMAND_DRAWER_ADD_NOTIFICATION && commandTopic <= COMMAND_DRAWER_FIGURE_DELETE) ||
+	        (commandTopic >= COMMAND_DEBUG_DRAWER_GRAPH_SET_POS && commandTopic <= COMMAND_DEBUG_DRAWER_OVERLAYTEXTURE_SET_LABEL));
+}
+
 //FIXME: get rid of this function (=call functions directly)
 static int wrapper_HandleCommand(CAICallback* clb, CAICheats* clbCheat, int cmdId, void* cmdData) {
 	if (clbCheat != nullptr) {
@@ -647,6 +683,11 @@ EXPORT(int) skirmishAiCallback_Engine_handleCommand(
 ) {
 	int ret = 0;
 
+	if (CEngineOutHandler::IsAsyncSkirmishAIThread() && IsMainThreadCommand(commandTopic)) {
+		LOG_L(L_WARNING, "[%s][AI=%d] command-topic %d is not available to asynchronous AIs", __func__, skirmishAIId, commandTopic);
+		return -1;
+	}
+
 	CAICallback* clb = GetCallBack(skirmishAIId);
 	// if this is not NULL, cheating is enabled
 	CAICheats* clbCheat = nullptr;
@@ -2006,6 +2047,10 @@ EXPORT(int) skirmishAiCallback_Map_getResourceMapRaw(
 }
 
 static inline const CResourceMapAnalyzer* getResourceMapAnalyzer(int resourceId) {
+	// analyzers are built by EngineOutHandler before async AIs start; never run Init off the sim thread
+	if (CEngineOutHandler::IsAsyncSkirmishAIThread())
+		return resourceHandler->GetInitedResourceMapAnalyzer(resourceId);
+
 	return resourceHandler->GetResourceMapAnalyzer(resourceId);
 }
 
@@ -2015,7 +2060,12 @@ EXPORT(int) skirmishAiCallback_Map_getResourceMapSpotsPositions(
 	float* spots,
 	int spotsMaxSize
 ) {
-	const std::vector<float3>& intSpots = getResourceMapAnalyzer(resourceId)->GetSpots();
+	const CResourceMapAnalyzer* rma = getResourceMapAnalyzer(resourceId);
+
+	if (rma == nullptr)
+		return 0;
+
+	const std::vector<float3>& intSpots = rma->GetSpots();
 	const int spotsRealSize = intSpots.size() * 3;
 
 	size_t spotsSize = spotsRealSize;
@@ -2035,7 +2085,12 @@ EXPORT(int) skirmishAiCallback_Map_getResourceMapSpotsPositions(
 }
 
 EXPORT(float) skirmishAiCallback_Map_getResourceMapSpotsAverageIncome(int skirmishAIId, int resourceId) {
-	return getResourceMapAnalyzer(resourceId)->GetAverageIncome();
+	const CResourceMapAnalyzer* rma = getResourceMapAnalyzer(resourceId);
+
+	if (rma == nullptr)
+		return -1.0f;
+
+	return rma->GetAverageIncome();
 }
 
 EXPORT(void) skirmishAiCallback_Map_getResourceMapSpotsNearest(
@@ -2044,7 +2099,15 @@ EXPORT(void) skirmishAiCallback_Map_getResourceMapSpotsNearest(
 	float* pos_posF3,
 	float* return_posF3_out
 ) {
-	getResourceMapAnalyzer(resourceId)->GetNearestSpot(pos_posF3, AI_TEAM_IDS[skirmishAIId]).copyInto(return_posF3_out);
+	const CResourceMapAnalyzer* rma = getResourceMapAnalyzer(resourceId);
+
+	if (rma == nullptr) {
+		// same sentinel the analyzer returns when no spot was found
+		float3(-1.0f, 0.0f, 0.0f).copyInto(return_posF3_out);
+		return;
+	}
+
+	rma->GetNearestSpot(pos_posF3, AI_TEAM_IDS[skirmishAIId]).copyInto(return_posF3_out);
 }
 
 EXPORT(int) skirmishAiCallback_Map_getHash(int skirmishAIId) {
@@ -3926,6 +3989,9 @@ EXPORT(int) skirmishAiCallback_getNeutralUnitsIn(int skirmishAIId, float* pos_po
 }
 
 EXPORT(int) skirmishAiCallback_getSelectedUnits(int skirmishAIId, int* unitIds, int unitIdsMaxSize) {
+	if (!isUIStateReadable())
+		return 0;
+
 	return GetCallBack(skirmishAIId)->GetSelectedUnits(unitIds, unitIdsMaxSize);
 }
 
@@ -4191,6 +4257,7 @@ EXPORT(int) skirmishAiCallback_getFeaturesIn(int skirmishAIId, float* pos_posF3,
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		// cheating
 		QuadFieldQuery qfQuery;
+		qfQuery.threadOwner = ThreadPool::GetThreadNum();
 		quadField.GetFeaturesExact(qfQuery, pos_posF3, radius, spherical);
 		const int featureIdsRealSize = qfQuery.features->size();
 
@@ -4905,7 +4972,17 @@ EXPORT(bool) skirmishAiCallback_Debug_GraphDrawer_isEnabled(int skirmishAIId) {
 	return GetCallBack(skirmishAIId)->IsDebugDrawerEnabled();
 }
 
+EXPORT(int) skirmishAiCallback_getUnitsState(int skirmishAIId, int* unitIds, int unitIds_size, float* positions, float* healths, int* unitDefIds, int* losStates) {
+	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId))
+		return GetCheatCallBack(skirmishAIId)->GetUnitsState(unitIds, unitIds_size, positions, healths, unitDefIds, losStates);
+
+	return GetCallBack(skirmishAIId)->GetUnitsState(unitIds, unitIds_size, positions, healths, unitDefIds, losStates);
+}
+
 EXPORT(int) skirmishAiCallback_getGroups(int skirmishAIId, int* groupIds, int maxGroups) {
+	if (!isUIStateReadable())
+		return 0;
+
 	const CGroupHandler& gh = uiGroupHandlers[ AI_TEAM_IDS[skirmishAIId] ];
 	const std::vector<CGroup>& gs = gh.GetGroups();
 
@@ -4969,28 +5046,28 @@ EXPORT(int) skirmishAiCallback_Group_SupportedCommand_getParams(
 }
 
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getId(int skirmishAIId, int groupId) {
-	if (!isControlledByLocalPlayer(skirmishAIId))
+	if (!isControlledByLocalPlayer(skirmishAIId) || !isUIStateReadable())
 		return -1;
 
 	return (guihandler->GetOrderPreview()).GetID();
 }
 
 EXPORT(short) skirmishAiCallback_Group_OrderPreview_getOptions(int skirmishAIId, int groupId) {
-	if (!isControlledByLocalPlayer(skirmishAIId))
+	if (!isControlledByLocalPlayer(skirmishAIId) || !isUIStateReadable())
 		return 0;
 
 	return (guihandler->GetOrderPreview()).GetOpts();
 }
 
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getTag(int skirmishAIId, int groupId) {
-	if (!isControlledByLocalPlayer(skirmishAIId))
+	if (!isControlledByLocalPlayer(skirmishAIId) || !isUIStateReadable())
 		return 0;
 
 	return (guihandler->GetOrderPreview()).GetTag();
 }
 
 EXPORT(int) skirmishAiCallback_Group_OrderPreview_getTimeOut(int skirmishAIId, int groupId) {
-	if (!isControlledByLocalPlayer(skirmishAIId))
+	if (!isControlledByLocalPlayer(skirmishAIId) || !isUIStateReadable())
 		return -1;
 
 	return (guihandler->GetOrderPreview()).GetTimeOut();
@@ -5002,7 +5079,7 @@ EXPORT(int) skirmishAiCallback_Group_OrderPreview_getParams(
 	float* params,
 	int maxNumParams
 ) {
-	if (!isControlledByLocalPlayer(skirmishAIId))
+	if (!isControlledByLocalPlayer(skirmishAIId) || !isUIStateReadable())
 		return 0;
 
 	const Command& guiCommand = guihandler->GetOrderPreview();
@@ -5022,7 +5099,7 @@ EXPORT(int) skirmishAiCallback_Group_OrderPreview_getParams(
 }
 
 EXPORT(bool) skirmishAiCallback_Group_isSelected(int skirmishAIId, int groupId) {
-	if (!isControlledByLocalPlayer(skirmishAIId))
+	if (!isControlledByLocalPlayer(skirmishAIId) || !isUIStateReadable())
 		return false;
 
 	return (selectedUnitsHandler.IsGroupSelected(groupId));
@@ -5628,6 +5705,7 @@ static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
 	callback->Unit_Weapon_isShieldEnabled = &skirmishAiCallback_Unit_Weapon_isShieldEnabled;
 	callback->Unit_Weapon_getShieldPower = &skirmishAiCallback_Unit_Weapon_getShieldPower;
 	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
+	callback->getUnitsState = &skirmishAiCallback_getUnitsState;
 }
 
 SSkirmishAICallback* skirmishAiCallback_GetInstance(CSkirmishAIWrapper* ai)
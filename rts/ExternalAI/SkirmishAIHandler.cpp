@@ -31,7 +31,6 @@ CR_REG_METADATA(CSkirmishAIHandler, (
 		CR_IGNORED(skirmishAIDataMap),
 		CR_IGNORED(luaAIShortNames),
 
-		CR_IGNORED(currentAIId),
 		CR_IGNORED(numSkirmishAIs),
 
 		CR_IGNORED(gameInitialized),
@@ -43,6 +42,8 @@ CR_REG_METADATA(CSkirmishAIHandler, (
 
 CSkirmishAIHandler skirmishAIHandler;
 
+_threadlocal uint8_t CSkirmishAIHandler::currentAIId = MAX_AIS;
+
 
 void CSkirmishAIHandler::SerializeSkirmishAIHandler(creg::ISerializer* s)
 {
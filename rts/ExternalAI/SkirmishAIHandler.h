@@ -8,6 +8,7 @@
 #include "ExternalAI/SkirmishAIData.h"
 #include "ExternalAI/SkirmishAIKey.h"
 #include "Sim/Misc/GlobalConstants.h"
+#include "System/MainDefines.h"
 #include "System/creg/creg_cond.h"
 #include "System/UnorderedMap.hpp"
 #include "System/UnorderedSet.hpp"
@@ -200,8 +201,9 @@ private:
 	spring::unordered_map<uint8_t, const SkirmishAIData*> skirmishAIDataMap;
 	spring::unordered_set<std::string> luaAIShortNames;
 
-	// the current local AI ID that is executing, MAX_AIS if none (e.g. LuaUI)
-	uint8_t currentAIId = MAX_AIS;
+	// the current local AI ID that is executing on this thread, MAX_AIS if none (e.g. LuaUI)
+	// per-thread since asynchronous AIs execute concurrently with LuaUI and synchronous AIs
+	static _threadlocal uint8_t currentAIId;
 	uint8_t numSkirmishAIs = 0;
 
 	bool gameInitialized = false;
@@ -2,6 +2,9 @@
 
 #include "SkirmishAIWrapper.h"
 
+// must precede anything defining the likely/unlikely macros
+#include "System/ConcurrentQueue.h"
+
 #include "AILibraryManager.h"
 #include "SkirmishAIHandler.h"
 #include "SkirmishAILibrary.h"
@@ -25,6 +28,7 @@
 #include "System/TimeProfiler.h"
 #include "System/StringUtil.h"
 
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -38,6 +42,7 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 
 	CR_IGNORED(library),
 	CR_IGNORED(callback),
+	CR_IGNORED(eventQueue),
 
 	CR_MEMBER(timerName),
 
@@ -56,6 +61,25 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 	CR_POSTLOAD(PostLoad)
 ))
 
+struct CSkirmishAIWrapper::QueuedEvent {
+	int topic;
+
+	// copy of the S*Event struct; pointer members are redirected to the payload on dispatch
+	alignas(void*) uint8_t data[48];
+
+	float3 vec;
+	std::vector<int> ids;
+	std::string text;
+};
+
+// written by the sim thread, drained by the AI thread
+struct CSkirmishAIWrapper::EventQueue: public moodycamel::ConcurrentQueue<QueuedEvent> {
+};
+
+
+CSkirmishAIWrapper::CSkirmishAIWrapper() = default;
+CSkirmishAIWrapper::~CSkirmishAIWrapper() = default;
+
 void CSkirmishAIWrapper::PreInit(int aiID)
 {
 	const SkirmishAIData* aiData = skirmishAIHandler.GetSkirmishAI(aiID);
@@ -74,6 +98,8 @@ void CSkirmishAIWrapper::PreInit(int aiID)
 
 		cheatEvents = false;
 		blockEvents = false;
+
+		eventQueue.reset();
 	}
 	{
 		const std::string& kn = key.GetShortName();
@@ -165,6 +191,9 @@ void CSkirmishAIWrapper::Kill()
 	{
 		library = nullptr;
 		callback = nullptr;
+
+		// events still queued for an asynchronous AI are dropped
+		eventQueue.reset();
 	}
 	{
 		// mark as inactive for EngineOutHandler::{Load,Save}; AI data
@@ -306,22 +335,22 @@ void CSkirmishAIWrapper::Save(std::ostream* saveStream)
 
 void CSkirmishAIWrapper::UnitIdle(int unitId) {
 	const SUnitIdleEvent evtData = {unitId};
-	HandleEvent(EVENT_UNIT_IDLE, &evtData);
+	SendEvent(EVENT_UNIT_IDLE, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::UnitCreated(int unitId, int builderId) {
 	const SUnitCreatedEvent evtData = {unitId, builderId};
-	HandleEvent(EVENT_UNIT_CREATED, &evtData);
+	SendEvent(EVENT_UNIT_CREATED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::UnitFinished(int unitId) {
 	const SUnitFinishedEvent evtData = {unitId};
-	HandleEvent(EVENT_UNIT_FINISHED, &evtData);
+	SendEvent(EVENT_UNIT_FINISHED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::UnitDestroyed(int unitId, int attackerUnitId) {
 	const SUnitDestroyedEvent evtData = {unitId, attackerUnitId};
-	HandleEvent(EVENT_UNIT_DESTROYED, &evtData);
+	SendEvent(EVENT_UNIT_DESTROYED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::UnitDamaged(
@@ -335,58 +364,58 @@ void CSkirmishAIWrapper::UnitDamaged(
 	float3 cpyDir = dir;
 	const SUnitDamagedEvent evtData = {unitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
 
-	HandleEvent(EVENT_UNIT_DAMAGED, &evtData);
+	SendEvent(EVENT_UNIT_DAMAGED, &evtData, sizeof(evtData), &cpyDir);
 }
 
 void CSkirmishAIWrapper::UnitMoveFailed(int unitId) {
 	const SUnitMoveFailedEvent evtData = {unitId};
-	HandleEvent(EVENT_UNIT_MOVE_FAILED, &evtData);
+	SendEvent(EVENT_UNIT_MOVE_FAILED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::UnitGiven(int unitId, int oldTeam, int newTeam) {
 	const SUnitGivenEvent evtData = {unitId, oldTeam, newTeam};
-	HandleEvent(EVENT_UNIT_GIVEN, &evtData);
+	SendEvent(EVENT_UNIT_GIVEN, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::UnitCaptured(int unitId, int oldTeam, int newTeam) {
 	const SUnitCapturedEvent evtData = {unitId, oldTeam, newTeam};
-	HandleEvent(EVENT_UNIT_CAPTURED, &evtData);
+	SendEvent(EVENT_UNIT_CAPTURED, &evtData, sizeof(evtData));
 }
 
 
 void CSkirmishAIWrapper::EnemyCreated(int unitId) {
 	const SEnemyCreatedEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_CREATED, &evtData);
+	SendEvent(EVENT_ENEMY_CREATED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyFinished(int unitId) {
 	const SEnemyFinishedEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_FINISHED, &evtData);
+	SendEvent(EVENT_ENEMY_FINISHED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyEnterLOS(int unitId) {
 	const SEnemyEnterLOSEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_ENTER_LOS, &evtData);
+	SendEvent(EVENT_ENEMY_ENTER_LOS, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyLeaveLOS(int unitId) {
 	const SEnemyLeaveLOSEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_LEAVE_LOS, &evtData);
+	SendEvent(EVENT_ENEMY_LEAVE_LOS, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyEnterRadar(int unitId) {
 	const SEnemyEnterRadarEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_ENTER_RADAR, &evtData);
+	SendEvent(EVENT_ENEMY_ENTER_RADAR, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyLeaveRadar(int unitId) {
 	const SEnemyLeaveRadarEvent evtData = {unitId};
-	HandleEvent(EVENT_ENEMY_LEAVE_RADAR, &evtData);
+	SendEvent(EVENT_ENEMY_LEAVE_RADAR, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyDestroyed(int enemyUnitId, int attackerUnitId) {
 	const SEnemyDestroyedEvent evtData = {enemyUnitId, attackerUnitId};
-	HandleEvent(EVENT_ENEMY_DESTROYED, &evtData);
+	SendEvent(EVENT_ENEMY_DESTROYED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::EnemyDamaged(
@@ -400,17 +429,17 @@ void CSkirmishAIWrapper::EnemyDamaged(
 	float3 cpyDir = dir;
 	const SEnemyDamagedEvent evtData = {enemyUnitId, attackerUnitId, damage, &cpyDir[0], weaponDefId, paralyzer};
 
-	HandleEvent(EVENT_ENEMY_DAMAGED, &evtData);
+	SendEvent(EVENT_ENEMY_DAMAGED, &evtData, sizeof(evtData), &cpyDir);
 }
 
 void CSkirmishAIWrapper::Update(int frame) {
 	const SUpdateEvent evtData = {frame};
-	HandleEvent(EVENT_UPDATE, &evtData);
+	SendEvent(EVENT_UPDATE, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::SendChatMessage(const char* msg, int fromPlayerId) {
 	const SMessageEvent evtData = {fromPlayerId, msg};
-	HandleEvent(EVENT_MESSAGE, &evtData);
+	SendEvent(EVENT_MESSAGE, &evtData, sizeof(evtData), nullptr, nullptr, msg);
 }
 
 void CSkirmishAIWrapper::SendLuaMessage(const char* inData, const char** outData) {
@@ -420,7 +449,7 @@ void CSkirmishAIWrapper::SendLuaMessage(const char* inData, const char** outData
 
 void CSkirmishAIWrapper::WeaponFired(int unitId, int weaponDefId) {
 	const SWeaponFiredEvent evtData = {unitId, weaponDefId};
-	HandleEvent(EVENT_WEAPON_FIRED, &evtData);
+	SendEvent(EVENT_WEAPON_FIRED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::PlayerCommandGiven(
@@ -433,12 +462,12 @@ void CSkirmishAIWrapper::PlayerCommandGiven(
 	const int cCommandId = extractAICommandTopic(&c, unitHandler.MaxUnits());
 	const SPlayerCommandEvent evtData = {&unitIds[0], static_cast<int>(playerSelectedUnits.size()), cCommandId, playerId};
 
-	HandleEvent(EVENT_PLAYER_COMMAND, &evtData);
+	SendEvent(EVENT_PLAYER_COMMAND, &evtData, sizeof(evtData), nullptr, &unitIds);
 }
 
 void CSkirmishAIWrapper::CommandFinished(int unitId, int commandId, int commandTopicId) {
 	const SCommandFinishedEvent evtData = {unitId, commandId, commandTopicId};
-	HandleEvent(EVENT_COMMAND_FINISHED, &evtData);
+	SendEvent(EVENT_COMMAND_FINISHED, &evtData, sizeof(evtData));
 }
 
 void CSkirmishAIWrapper::SeismicPing(
@@ -450,13 +479,77 @@ void CSkirmishAIWrapper::SeismicPing(
 	/*const*/ float3 cpyPos = pos;
 	const SSeismicPingEvent evtData = {&cpyPos[0], strength};
 
-	HandleEvent(EVENT_SEISMIC_PING, &evtData);
+	SendEvent(EVENT_SEISMIC_PING, &evtData, sizeof(evtData), &cpyPos);
+}
+
+
+void CSkirmishAIWrapper::SetAsyncEvents(bool enable) {
+	if (enable == AsyncEventsEnabled())
+		return;
+
+	if (enable) {
+		eventQueue.reset(new EventQueue());
+	} else {
+		eventQueue.reset();
+	}
+}
+
+bool CSkirmishAIWrapper::HasQueuedEvents() const {
+	return (eventQueue != nullptr && eventQueue->size_approx() != 0);
 }
 
+void CSkirmishAIWrapper::ProcessQueuedEvents() {
+	if (eventQueue == nullptr)
+		return;
+
+	// the profiler's scoped timers are not thread-safe
+	ScopedMtTimer timer(GetTimerNameHash());
+	QueuedEvent evt;
+
+	while (eventQueue->try_dequeue(evt)) {
+		switch (evt.topic) {
+			case EVENT_UNIT_DAMAGED  : { reinterpret_cast<SUnitDamagedEvent*  >(evt.data)->dir_posF3 = &evt.vec[0]; } break;
+			case EVENT_ENEMY_DAMAGED : { reinterpret_cast<SEnemyDamagedEvent* >(evt.data)->dir_posF3 = &evt.vec[0]; } break;
+			case EVENT_SEISMIC_PING  : { reinterpret_cast<SSeismicPingEvent*  >(evt.data)->pos_posF3 = &evt.vec[0]; } break;
+			case EVENT_PLAYER_COMMAND: { reinterpret_cast<SPlayerCommandEvent*>(evt.data)->unitIds   = evt.ids.data(); } break;
+			case EVENT_MESSAGE       : { reinterpret_cast<SMessageEvent*      >(evt.data)->message   = evt.text.c_str(); } break;
+			default: {} break;
+		}
+
+		DispatchEvent(evt.topic, evt.data);
+	}
+}
+
+
+void CSkirmishAIWrapper::SendEvent(int topic, const void* data, size_t size, const float3* vec, const std::vector<int>* ids, const char* text) {
+	if (eventQueue == nullptr) {
+		HandleEvent(topic, data);
+		return;
+	}
+
+	QueuedEvent evt;
+
+	assert(size <= sizeof(evt.data));
+
+	evt.topic = topic;
+	std::memcpy(evt.data, data, size);
+
+	if (vec != nullptr)
+		evt.vec = *vec;
+	if (ids != nullptr)
+		evt.ids = *ids;
+	if (text != nullptr)
+		evt.text = text;
+
+	eventQueue->enqueue(std::move(evt));
+}
 
 int CSkirmishAIWrapper::HandleEvent(int topic, const void* data) const {
 	ScopedTimer timer(GetTimerNameHash());
+	return (DispatchEvent(topic, data));
+}
 
+int CSkirmishAIWrapper::DispatchEvent(int topic, const void* data) const {
 	if (!blockEvents || (topic == EVENT_RELEASE))
 		return library->HandleEvent(skirmishAIId, topic, data);
 
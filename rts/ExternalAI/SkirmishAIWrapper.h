@@ -5,6 +5,9 @@
 
 #include "SkirmishAIKey.h"
 
+#include <memory>
+#include <vector>
+
 class CSkirmishAILibrary;
 struct SSkirmishAICallback;
 
@@ -23,7 +26,8 @@ private:
 
 public:
 	/// used only by creg
-	CSkirmishAIWrapper() = default;
+	CSkirmishAIWrapper();
+	~CSkirmishAIWrapper();
 
 	CSkirmishAIWrapper(const CSkirmishAIWrapper& w) = delete;
 	CSkirmishAIWrapper(CSkirmishAIWrapper&& w) = delete;
@@ -92,8 +96,18 @@ public:
 	 */
 	void SetBlockEvents(bool enable) { blockEvents = enable; }
 	void SetCheatEvents(bool enable) { cheatEvents = enable; }
+	/**
+	 * Asynchronous AIs only queue their regular events, which are
+	 * handled on the AI thread by ProcessQueuedEvents. Init, Release,
+	 * Load, Save and Lua messages are always handled synchronously.
+	 * @see CEngineOutHandler::RunAsyncSkirmishAIs()
+	 */
+	void SetAsyncEvents(bool enable);
+	void ProcessQueuedEvents();
 
 	bool CheatEventsEnabled() const { return cheatEvents; }
+	bool AsyncEventsEnabled() const { return (eventQueue != nullptr); }
+	bool HasQueuedEvents() const;
 
 	bool Active() const { return (skirmishAIId != -1); }
 
@@ -110,6 +124,13 @@ private:
 	 * CAUTION: takes C AI Interface events, not engine C++ ones!
 	 */
 	int HandleEvent(int topic, const void* data) const;
+	int DispatchEvent(int topic, const void* data) const;
+
+	/**
+	 * Handles the event directly, or queues a copy of it for asynchronous AIs.
+	 * Data referenced by pointer members of the event has to be passed along.
+	 */
+	void SendEvent(int topic, const void* data, size_t size, const float3* vec = nullptr, const std::vector<int>* ids = nullptr, const char* text = nullptr);
 
 	uint32_t GetTimerNameHash() const { return *reinterpret_cast<const uint32_t*>(&timerName[0]); }
 
@@ -117,11 +138,17 @@ private:
 	      char* GetTimerName()       { return (timerName + sizeof(uint32_t)); }
 
 private:
+	struct QueuedEvent;
+	struct EventQueue;
+
 	SkirmishAIKey key;
 
 	const CSkirmishAILibrary* library = nullptr;
 	const SSkirmishAICallback* callback = nullptr;
 
+	// non-null iff events are handled asynchronously
+	std::unique_ptr<EventQueue> eventQueue;
+
 	// first 4 bytes store hash(timerName + 4)
 	char timerName[sizeof(uint32_t) + 60] = {0};
 
@@ -0,0 +1,188 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "DefsSnapshot.h"
+#include "Game/GameSetup.h"
+#include "Lua/LuaParser.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+#include "System/StringUtil.h"
+#include "System/Sync/SHA512.hpp"
+
+#include <tracy/Tracy.hpp>
+
+CONFIG(bool, UseDefsSnapshot).defaultValue(false).description("Whether the table returned by gamedata/defs.lua is stored in the cache directory and restored on later loads of the same game, map and options, instead of executing the defs.");
+
+
+static constexpr uint32_t SNAPSHOT_MAGIC   = 0x534E5344; // "DSNS"
+static constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+struct SnapshotHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t dataSize;
+
+	sha512::raw_digest keyDigest;
+	sha512::raw_digest dataDigest;
+};
+
+
+std::string CDefsSnapshot::GetKey()
+{
+	std::string key;
+
+	const auto AddChecksum = [&key](const std::string& name) {
+		const sha512::raw_digest& checksum = archiveScanner->GetArchiveCompleteChecksumBytes(archiveScanner->ArchiveFromName(name));
+		key.append(reinterpret_cast<const char*>(checksum.data()), checksum.size());
+	};
+	const auto AddOptions = [&key](const spring::unordered_map<std::string, std::string>& options) {
+		std::vector<std::pair<std::string, std::string>> sorted(options.begin(), options.end());
+		std::sort(sorted.begin(), sorted.end());
+
+		for (const auto& p: sorted) {
+			key += p.first;
+			key += '=';
+			key += p.second;
+			key += ';';
+		}
+
+		key += '\n';
+	};
+
+	AddChecksum(gameSetup->modName);
+	AddChecksum(gameSetup->mapName);
+	AddOptions(gameSetup->GetModOptionsCont());
+	AddOptions(gameSetup->GetMapOptionsCont());
+
+	// setup values visible to defs through the Game table
+	key += IntToString(gameSetup->startPosType);
+	key += IntToString(gameSetup->ghostedBuildings);
+	key += IntToString(gameSetup->maxUnitsPerTeam);
+	key += IntToString(gameSetup->GetTeamStartingDataCont().size());
+
+	return key;
+}
+
+std::string CDefsSnapshot::GetFileName(const std::string& key)
+{
+	sha512::raw_digest keyDigest;
+	sha512::hex_digest keyHexDigest;
+
+	sha512::calc_digest(reinterpret_cast<const uint8_t*>(key.data()), key.size(), keyDigest.data());
+	sha512::dump_digest(keyDigest, keyHexDigest);
+
+	// 64 bits of the digest suffice to tell entries apart, the full key is verified on load
+	return (FileSystem::GetCacheDir() + "/defs/" + std::string(keyHexDigest.data(), 16) + ".sds");
+}
+
+
+bool CDefsSnapshot::Load(LuaParser* defsParser)
+{
+	if (!configHandler->GetBool("UseDefsSnapshot"))
+		return false;
+
+	ZoneScoped;
+
+	const std::string& key = GetKey();
+	const std::string& absFileName = dataDirsAccess.LocateFile(GetFileName(key));
+
+	SnapshotHeader header;
+	sha512::raw_digest keyDigest;
+	sha512::raw_digest dataDigest;
+	std::vector<uint8_t> data;
+
+	{
+		FILE* file = fopen(absFileName.c_str(), "rb");
+
+		if (file == nullptr)
+			return false;
+
+		bool readOk = (fread(&header, sizeof(header), 1, file) == 1);
+
+		readOk = readOk && (header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION);
+
+		if (readOk) {
+			data.resize(header.dataSize);
+			readOk = (fread(data.data(), 1, data.size(), file) == data.size());
+		}
+
+		fclose(file);
+
+		if (!readOk)
+			return false;
+	}
+
+	sha512::calc_digest(reinterpret_cast<const uint8_t*>(key.data()), key.size(), keyDigest.data());
+	sha512::calc_digest(data.data(), data.size(), dataDigest.data());
+
+	if (header.keyDigest != keyDigest)
+		return false;
+
+	// a damaged snapshot would otherwise silently desync us
+	if (header.dataDigest != dataDigest) {
+		LOG_L(L_WARNING, "[DefsSnapshot::%s] ignoring corrupted snapshot \"%s\"", __func__, absFileName.c_str());
+		return false;
+	}
+
+	if (!defsParser->ExecuteSnapshot(data)) {
+		LOG_L(L_WARNING, "[DefsSnapshot::%s] failed to restore snapshot \"%s\": %s", __func__, absFileName.c_str(), defsParser->GetErrorLog().c_str());
+		return false;
+	}
+
+	LOG("[DefsSnapshot::%s] restored gamedata definitions from \"%s\"", __func__, absFileName.c_str());
+	return true;
+}
+
+void CDefsSnapshot::Save(LuaParser* defsParser)
+{
+	if (!configHandler->GetBool("UseDefsSnapshot"))
+		return;
+
+	ZoneScoped;
+
+	const std::string& key = GetKey();
+
+	SnapshotHeader header;
+	std::vector<uint8_t> data;
+
+	if (!defsParser->GetRootSnapshot(data))
+		return;
+
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.dataSize = data.size();
+
+	sha512::calc_digest(reinterpret_cast<const uint8_t*>(key.data()), key.size(), header.keyDigest.data());
+	sha512::calc_digest(data.data(), data.size(), header.dataDigest.data());
+
+	if (!FileSystem::CreateDirectory(FileSystem::GetCacheDir() + "/defs/"))
+		return;
+
+	// write to a temporary file first so a concurrently starting client never sees partial data
+	const std::string& absFileName = dataDirsAccess.LocateFile(GetFileName(key), FileQueryFlags::WRITE);
+	const std::string& tmpFileName = absFileName + ".tmp";
+
+	FILE* file = fopen(tmpFileName.c_str(), "wb");
+
+	if (file == nullptr)
+		return;
+
+	bool writeOk = true;
+	writeOk = writeOk && (fwrite(&header, sizeof(header), 1, file) == 1);
+	writeOk = writeOk && (fwrite(data.data(), 1, data.size(), file) == data.size());
+
+	fclose(file);
+
+	if (!writeOk || std::rename(tmpFileName.c_str(), absFileName.c_str()) != 0) {
+		LOG_L(L_WARNING, "[DefsSnapshot::%s] failed to write \"%s\"", __func__, absFileName.c_str());
+		std::remove(tmpFileName.c_str());
+	}
+}
@@ -0,0 +1,30 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEFS_SNAPSHOT_H
+#define DEFS_SNAPSHOT_H
+
+#include <string>
+
+class LuaParser;
+
+/**
+ * Stores the table returned by gamedata/defs.lua in the (engine-versioned)
+ * cache directory, so later loads of the same game and map can restore it
+ * without executing any defs code.
+ *
+ * Snapshots are keyed by the complete game and map checksums, the game and
+ * map options, and the few setup values exposed to defs through Game.*; a
+ * snapshot is only written if the defs did not consume synced randomness.
+ */
+class CDefsSnapshot
+{
+public:
+	static bool Load(LuaParser* defsParser);
+	static void Save(LuaParser* defsParser);
+
+private:
+	static std::string GetKey();
+	static std::string GetFileName(const std::string& key);
+};
+
+#endif // DEFS_SNAPSHOT_H
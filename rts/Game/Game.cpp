@@ -22,6 +22,7 @@
 #include "SyncedGameCommands.h"
 #include "UnsyncedActionExecutor.h"
 #include "UnsyncedGameCommands.h"
+#include "DefsSnapshot.h"
 #include "Game/Players/Player.h"
 #include "Game/Players/PlayerHandler.h"
 #include "Game/UI/PlayerRoster.h"
@@ -550,9 +551,17 @@ void CGame::LoadDefs(LuaParser* defsParser)
 		defsParser->AddFunc("GetMapOptions", LuaSyncedRead::GetMapOptions);
 		defsParser->EndTable();
 
-		// run the parser
-		if (!defsParser->Execute())
-			throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+		if (!CDefsSnapshot::Load(defsParser)) {
+			const auto rngState = gsRNG.GetGenState();
+
+			// run the parser
+			if (!defsParser->Execute())
+				throw content_error("Defs-Parser: " + defsParser->GetErrorLog());
+
+			// defs consuming synced random numbers can not be reproduced from a snapshot
+			if (gsRNG.GetGenState() == rngState)
+				CDefsSnapshot::Save(defsParser);
+		}
 
 		const LuaTable& root = defsParser->GetRoot();
 
@@ -1161,6 +1170,9 @@ bool CGame::Update()
 	if (playing && gameServer != nullptr && videoCapturing->AllowRecord())
 		gameServer->CreateNewFrame(false, true);
 
+	// asynchronous AIs must be done with the previous frame before the next one is simulated
+	eoh->WaitForAsyncSkirmishAIs();
+
 	ENTER_SYNCED_CODE();
 	SendClientProcUsage();
 	ClientReadNet(); // issues new SimFrame()s
@@ -1175,6 +1187,9 @@ bool CGame::Update()
 
 	LEAVE_SYNCED_CODE();
 
+	// runs concurrently with drawing until the next Update
+	eoh->RunAsyncSkirmishAIs();
+
 	{
 		SLuaAllocError error = {};
 
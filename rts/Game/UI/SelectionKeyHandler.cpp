@@ -199,18 +199,28 @@ namespace {
 		groupNum = -1;
 	)
 
-	DECLARE_FILTER_EX(RulesParamEquals, 2, unit->modParams.find(param) != unit->modParams.end() &&
-			((wantedValueStr.empty()) ? unit->modParams.find(param)->second.valueInt == wantedValue
-			: unit->modParams.find(param)->second.valueString == wantedValueStr),
-		std::string param;
+	DECLARE_FILTER_EX(RulesParamEquals, 2, ParamEquals(unit->modParams),
+		// resolved once per use of the filter, not per unit
+		int paramKeyID;
 		std::string wantedValueStr;
 
 		float wantedValue;
 
+		bool ParamEquals(const LuaRulesParams::Params& params) const {
+			const LuaRulesParams::Param* p = params.Find(paramKeyID);
+
+			if (p == nullptr)
+				return false;
+			if (wantedValueStr.empty())
+				return (p->valueInt == wantedValue);
+
+			return (params.IsString(*p) && params.GetString(*p) == wantedValueStr);
+		}
+
 		void SetParam(int index, const std::string& value) override {
 			switch (index) {
 				case 0: {
-					param = value;
+					paramKeyID = LuaRulesParams::FindKeyID(value);
 				} break;
 				case 1: {
 					const char* cstr = value.c_str();
@@ -220,6 +230,7 @@ namespace {
 				} break;
 			}
 		},
+		paramKeyID = -1;
 		wantedValue = 0.0f;
 	)
 
@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 #include <array>
 #include <functional>
+#include <sstream>
 #include <tuple>
 
 #include "UnsyncedGameCommands.h"
@@ -101,6 +102,7 @@
 #include "System/SafeUtil.h"
 #include "System/TimeProfiler.h"
 #include "System/Log/ILog.h"
+#include "System/LoadSave/CregLoadSaveHandler.h"
 #include "System/Config/ConfigHandler.h"
 #include "System/FileSystem/SimpleParser.h"
 #include "System/Sound/ISound.h"
@@ -3532,6 +3534,67 @@ private:
 
 
 
+class SnapshotActionExecutor : public IUnsyncedActionExecutor {
+public:
+	SnapshotActionExecutor() : IUnsyncedActionExecutor(
+		"Snapshot",
+		"Keep an uncompressed copy of the game state in memory under the given name, see RestoreSnapshot"
+	) {
+	}
+
+	bool Execute(const UnsyncedAction& action) const final {
+		const std::vector<std::string> args = CSimpleParser::Tokenize(action.GetArgs());
+
+		if (args.size() != 1)
+			return false;
+
+		// taken between frames like any other save, replaces an older snapshot of the same name
+		game->Save(args[0] + ".ssnap", "-y");
+		return true;
+	}
+};
+
+class RestoreSnapshotActionExecutor : public IUnsyncedActionExecutor {
+public:
+	RestoreSnapshotActionExecutor() : IUnsyncedActionExecutor(
+		"RestoreSnapshot",
+		"Restart the (local) game from a snapshot taken with /snapshot"
+	) {
+	}
+
+	bool Execute(const UnsyncedAction& action) const final {
+		const std::vector<std::string> args = CSimpleParser::Tokenize(action.GetArgs());
+
+		if (args.size() != 1)
+			return false;
+
+		if (gameServer == nullptr) {
+			LOG_L(L_WARNING, "[RestoreSnapshotAction] only the host can restore a snapshot");
+			return true;
+		}
+
+		const std::string snapshotName = args[0] + ".ssnap";
+
+		if (!CCregLoadSaveHandler::HasSnapshot(snapshotName)) {
+			LOG_L(L_WARNING, "[RestoreSnapshotAction] no snapshot named \"%s\"", args[0].c_str());
+			return true;
+		}
+
+		std::ostringstream script;
+		script << "[GAME]\n{\n";
+		script << "\tSaveFile=" << snapshotName << ";\n";
+		script << "\tIsHost=1;\n";
+		script << "\tMyPlayerName=" << playerHandler.Player(gu->myPlayerNum)->name << ";\n";
+		script << "}\n";
+
+		// same path as loading a save-file, minus reading and inflating it
+		gameSetup->reloadScript = script.str();
+		gu->globalReload = true;
+		return true;
+	}
+};
+
+
 class ReloadShadersActionExecutor : public IUnsyncedActionExecutor {
 public:
 	ReloadShadersActionExecutor() : IUnsyncedActionExecutor("ReloadShaders", "Reloads all engine shaders") {
@@ -4010,6 +4073,8 @@ void UnsyncedGameCommands::AddDefaultActionExecutors()
 	AddActionExecutor(AllocActionExecutor<DumpRNGActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<SaveActionExecutor>(true));
 	AddActionExecutor(AllocActionExecutor<SaveActionExecutor>(false));
+	AddActionExecutor(AllocActionExecutor<SnapshotActionExecutor>());
+	AddActionExecutor(AllocActionExecutor<RestoreSnapshotActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<ReloadShadersActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<ReloadTexturesActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<DumpAtlasActionExecutor>());
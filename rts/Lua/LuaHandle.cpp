@@ -107,6 +107,19 @@ static void LUA_ERASE_CONTEXT(const luaContextData* D, const spring::unsynced_se
 	const_cast<  spring::unsynced_set<const luaContextData*>*  >(S)->erase(D);
 }
 
+static bool UseSharedMemPool(const std::string& name)
+{
+	// no shared pool for LuaIntro to protect against LoadingMT=1
+	// do not use it for LuaMenu either; too many blocks allocated
+	// by *other* states end up not being recycled which presently
+	// forces clearing the shared pool on reload
+	// LuaUI and LuaRules get their own pool as well s.t. closing
+	// them (e.g. on /luaui reload) hands back all of their pages
+	// at once, instead of only when every other user of the shared
+	// pool is gone
+	return (name != "LuaIntro" && name != "LuaMenu" && name != "LuaUI" && name != "LuaRules");
+}
+
 static int handlepanic(lua_State* L)
 {
 	throw content_error(luaL_optsstring(L, 1, "lua paniced"));
@@ -118,11 +131,7 @@ CLuaHandle::CLuaHandle(const string& _name, int _order, bool _userMode, bool _sy
 	: CEventClient(_name, _order, _synced)
 	, userMode(_userMode)
 	, killMe(false)
-	// no shared pool for LuaIntro to protect against LoadingMT=1
-	// do not use it for LuaMenu either; too many blocks allocated
-	// by *other* states end up not being recycled which presently
-	// forces clearing the shared pool on reload
-	, D(_name != "LuaIntro" && name != "LuaMenu", true)
+	, D(UseSharedMemPool(_name), true)
 {
 	D.owner = this;
 	D.synced = _synced;
@@ -2,6 +2,8 @@
 
 #include "LuaHandleSynced.h"
 
+#include <cstring>
+
 #include "LuaInclude.h"
 
 #include "LuaUtils.h"
@@ -111,6 +113,7 @@ bool CUnsyncedLuaHandle::Init(std::string code, const std::string& file)
 
 	LuaPushNamedCFunc(L, "loadstring", CSplitLuaHandle::LoadStringData);
 	LuaPushNamedCFunc(L, "CallAsTeam", CSplitLuaHandle::CallAsTeam);
+	LuaPushNamedCFunc(L, "GetPackedFromSynced", GetPackedFromSynced);
 	LuaPushNamedNumber(L, "COBSCALE",  COBSCALE);
 
 	// load our libraries
@@ -201,6 +204,74 @@ void CUnsyncedLuaHandle::RecvFromSynced(lua_State* srcState, int args)
 	RunCallIn(L, cmdStr, args, 0);
 }
 
+void CUnsyncedLuaHandle::QueuePackedFromSynced(lua_State* srcState, int first, int last)
+{
+	// bounded so a handle that stops draining can not grow without limit; the
+	// overflow is not reported back since synced code must not observe unsynced
+	// state, only logged once until the queue is drained again
+	static constexpr size_t MAX_BUFFER_SIZE = 16 * 1024 * 1024;
+
+	if (!IsValid())
+		return;
+
+	// nothing is queued for handles that never called GetPackedFromSynced
+	if (!packedMsgEnabled)
+		return;
+
+	size_t msgSize = 0;
+
+	for (int i = first; i <= last; i++) {
+		msgSize += lua_strlen(srcState, i);
+	}
+
+	const size_t offset = packedMsgBuffer.size();
+	const std::uint32_t recSize = static_cast<std::uint32_t>(msgSize);
+
+	if ((offset + sizeof(recSize) + msgSize) > MAX_BUFFER_SIZE) {
+		if (!packedMsgDropped)
+			LOG_L(L_WARNING, "[%s][%s] packed message queue is full, dropping messages until GetPackedFromSynced is called (frame %d)", __func__, GetName().c_str(), gs->frameNum);
+
+		packedMsgDropped = true;
+		return;
+	}
+
+	packedMsgBuffer.resize(offset + sizeof(recSize) + msgSize);
+	std::memcpy(&packedMsgBuffer[offset], &recSize, sizeof(recSize));
+
+	size_t pos = offset + sizeof(recSize);
+
+	for (int i = first; i <= last; i++) {
+		size_t len = 0;
+		const char* str = lua_tolstring(srcState, i, &len);
+
+		std::memcpy(&packedMsgBuffer[pos], str, len);
+		pos += len;
+	}
+
+	packedMsgCount += 1;
+}
+
+
+// returns all records queued by synced SendPackedToUnsynced since the last
+// call as one string plus the record count, and empties the queue; records
+// are laid out as <uint32 size><bytes> and can be walked with VFS.UnpackU32
+// (queueing starts with the first call, earlier messages are not kept)
+int CUnsyncedLuaHandle::GetPackedFromSynced(lua_State* L)
+{
+	CUnsyncedLuaHandle* ulh = CSplitLuaHandle::GetUnsyncedHandle(L);
+
+	lua_pushlstring(L, reinterpret_cast<const char*>(ulh->packedMsgBuffer.data()), ulh->packedMsgBuffer.size());
+	lua_pushnumber(L, ulh->packedMsgCount);
+
+	// keep the capacity; queue sizes are usually similar between frames
+	ulh->packedMsgBuffer.clear();
+	ulh->packedMsgCount = 0;
+	ulh->packedMsgEnabled = true;
+	ulh->packedMsgDropped = false;
+	return 2;
+}
+
+
 /*** Custom Object Rendering
  *
  * For the following calls drawMode can be one of the following, notDrawing = 0, normalDraw = 1, shadowDraw = 2, reflectionDraw = 3, refractionDraw = 4, and finally gameDeferredDraw = 5 which was added in 102.0.
@@ -489,6 +560,7 @@ bool CSyncedLuaHandle::Init(std::string code, const std::string& file)
 
 	// add the custom file loader
 	LuaPushNamedCFunc(L, "SendToUnsynced", SendToUnsynced);
+	LuaPushNamedCFunc(L, "SendPackedToUnsynced", SendPackedToUnsynced);
 	LuaPushNamedCFunc(L, "CallAsTeam",     CSplitLuaHandle::CallAsTeam);
 	LuaPushNamedNumber(L, "COBSCALE",      COBSCALE);
 
@@ -1947,6 +2019,29 @@ int CSyncedLuaHandle::SendToUnsynced(lua_State* L)
 }
 
 
+// binary variant of SendToUnsynced; arguments must be strings (e.g. made
+// with VFS.Pack*) and are appended as one concatenated record to a queue
+// without touching the unsynced Lua state, which drains it in bulk through
+// GetPackedFromSynced
+int CSyncedLuaHandle::SendPackedToUnsynced(lua_State* L)
+{
+	const int args = lua_gettop(L);
+
+	if (args <= 0)
+		luaL_error(L, "Incorrect arguments to SendPackedToUnsynced()");
+
+	// check everything first, a message is either queued whole or not at all
+	for (int i = 1; i <= args; i++) {
+		if (lua_type(L, i) != LUA_TSTRING)
+			luaL_error(L, "Incorrect data type for SendPackedToUnsynced(), arg %d", i);
+	}
+
+	CUnsyncedLuaHandle* ulh = CSplitLuaHandle::GetUnsyncedHandle(L);
+	ulh->QueuePackedFromSynced(L, 1, args);
+	return 0;
+}
+
+
 int CSyncedLuaHandle::AddSyncedActionFallback(lua_State* L)
 {
 	std::string cmdRaw = "/" + std::string(luaL_checkstring(L, 1));
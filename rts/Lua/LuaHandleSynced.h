@@ -3,7 +3,9 @@
 #ifndef LUA_HANDLE_SYNCED
 #define LUA_HANDLE_SYNCED
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "LuaHandle.h"
 #include "LuaRulesParams.h"
@@ -29,6 +31,11 @@ class CUnsyncedLuaHandle : public CLuaHandle
 	public: // all non-eventhandler callins
 		void RecvFromSynced(lua_State* srcState, int args); // not an engine call-in
 
+	public:
+		// appends one length-prefixed record to the synced->unsynced queue, holding
+		// the (pre-validated) strings at stack indices [first, last] of <srcState>
+		void QueuePackedFromSynced(lua_State* srcState, int first, int last);
+
 	protected:
 		CUnsyncedLuaHandle(CSplitLuaHandle* base, const std::string& name, int order);
 		virtual ~CUnsyncedLuaHandle();
@@ -42,6 +49,20 @@ class CUnsyncedLuaHandle : public CLuaHandle
 
 	protected:
 		CSplitLuaHandle& base;
+
+	private: // call-outs
+		static int GetPackedFromSynced(lua_State* L);
+
+	private:
+		// records queued by SendPackedToUnsynced, drained by GetPackedFromSynced;
+		// each is a uint32 byte-count followed by that many bytes of payload
+		std::vector<std::uint8_t> packedMsgBuffer;
+		std::uint32_t packedMsgCount = 0;
+
+		// set by the first GetPackedFromSynced call, handles that never drain do not queue
+		bool packedMsgEnabled = false;
+		// whether a message was dropped because the queue was full since the last drain
+		bool packedMsgDropped = false;
 };
 
 
@@ -146,6 +167,7 @@ class CSyncedLuaHandle : public CLuaHandle
 		static int SyncedPairs(lua_State* L);
 
 		static int SendToUnsynced(lua_State* L);
+		static int SendPackedToUnsynced(lua_State* L);
 
 		static int AddSyncedActionFallback(lua_State* L);
 		static int RemoveSyncedActionFallback(lua_State* L);
@@ -268,7 +290,7 @@ class CSplitLuaHandle
 		CUnsyncedLuaHandle unsyncedLuaHandle;
 
 	public:
-		static void ClearGameParams() { spring::clear_unordered_map(gameParams); }
+		static void ClearGameParams() { gameParams.clear(); }
 		static const LuaRulesParams::Params& GetGameParams() { return gameParams; }
 
 	private:
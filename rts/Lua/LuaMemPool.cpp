@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include <algorithm> // std::min
+#include <cassert>
 #include <cstdint> // std::uint8_t
 #include <cstring> // std::mem{cpy,set}
 #include <new>
@@ -23,6 +24,49 @@ static std::vector<size_t> gIndcs;
 static std::atomic<size_t> gCount = {0};
 static spring::mutex gMutex;
 
+// pages released by cleared pools, reused by any other pool (i.e. across
+// handles); the cache is bounded so a single burst can not pin memory
+static std::vector<uint8_t*> gFreePages;
+static constexpr size_t MAX_CACHED_PAGES = (64 * 1024 * 1024) / LuaMemPool::PAGE_SIZE;
+
+
+static uint8_t* AcquirePage()
+{
+	{
+		std::lock_guard<spring::mutex> lock(gMutex);
+
+		if (!gFreePages.empty()) {
+			uint8_t* page = gFreePages.back();
+			gFreePages.pop_back();
+			return page;
+		}
+	}
+
+	return (static_cast<uint8_t*>(::operator new(LuaMemPool::PAGE_SIZE)));
+}
+
+static void ReleasePages(std::vector<uint8_t*>& pages)
+{
+	if (pages.empty())
+		return;
+
+	{
+		std::lock_guard<spring::mutex> lock(gMutex);
+
+		while (!pages.empty() && gFreePages.size() < MAX_CACHED_PAGES) {
+			gFreePages.push_back(pages.back());
+			pages.pop_back();
+		}
+	}
+
+	for (uint8_t* page: pages) {
+		::operator delete(page);
+	}
+
+	pages.clear();
+}
+
+
 
 size_t LuaMemPool::GetPoolCount() { return (gCount.load()); }
 
@@ -61,10 +105,18 @@ void LuaMemPool::ReleasePtr(LuaMemPool* p, const CLuaHandle* o)
 	gCount -= (o != nullptr);
 
 	if (p == GetSharedPtr()) {
-		p->GetSharedCount() -= 1;
+		// last user gone, no chunks can be alive anymore
+		if ((p->GetSharedCount() -= 1) == 0)
+			p->Clear();
+
 		return;
 	}
 
+	// the owning state has been closed at this point, so hand all
+	// pages back at once (e.g. on /luaui reload) instead of keeping
+	// them tied to an idle pool
+	p->Clear();
+
 	gMutex.lock();
 	gIndcs.push_back(p->GetGlobalIndex());
 	gMutex.unlock();
@@ -82,6 +134,12 @@ void LuaMemPool::KillStatic()
 	gIndcs.clear();
 
 	spring::SafeDestruct(gSharedPool);
+
+	for (uint8_t* page: gFreePages) {
+		::operator delete(page);
+	}
+
+	gFreePages.clear();
 }
 
 
@@ -92,17 +150,67 @@ LuaMemPool::LuaMemPool(size_t lmpIndex): globalIndex(lmpIndex)
 	if (!LuaMemPool::enabled)
 		return;
 
-	luaMemPoolImpl = std::make_unique<LuaMemPool::LuaMemPoolImpl>();
+	pages.reserve(64);
 }
 
 void LuaMemPool::Clear()
 {
+	ReleasePages(pages);
+
+	buckets = {};
 	//allocStats = {};
 }
 
+
+void* LuaMemPool::AllocChunk(uint32_t bucketIndex)
+{
+	BucketState& bucket = buckets[bucketIndex];
+
+	if (bucket.freeList != nullptr) {
+		FreeChunkNode* node = bucket.freeList;
+		bucket.freeList = node->next;
+
+		allocStats[STAT_NAI] += 1;
+		allocStats[STAT_NBI] += BucketSize(bucketIndex);
+		return node;
+	}
+
+	if ((bucket.pageCurr + BucketSize(bucketIndex)) > bucket.pageEnd) {
+		// current page exhausted; chunks are never returned to a page, so
+		// the tail (< bucket size) is simply abandoned until Clear
+		const auto t0 = spring_now();
+
+		pages.push_back(AcquirePage());
+
+		bucket.pageCurr = pages.back();
+		bucket.pageEnd = bucket.pageCurr + PAGE_SIZE;
+
+		allocStats[STAT_NAF] += 1;
+		allocStats[STAT_NBF] += BucketSize(bucketIndex);
+		allocStats[STAT_NTF] += (spring_now() - t0).toMicroSecsi();
+	} else {
+		allocStats[STAT_NAI] += 1;
+		allocStats[STAT_NBI] += BucketSize(bucketIndex);
+	}
+
+	void* ptr = bucket.pageCurr;
+	bucket.pageCurr += BucketSize(bucketIndex);
+	return ptr;
+}
+
+void LuaMemPool::FreeChunk(void* ptr, uint32_t bucketIndex)
+{
+	FreeChunkNode* node = static_cast<FreeChunkNode*>(ptr);
+	BucketState& bucket = buckets[bucketIndex];
+
+	node->next = bucket.freeList;
+	bucket.freeList = node;
+}
+
+
 void* LuaMemPool::Alloc(size_t size)
 {
-	if (!LuaMemPool::enabled) {
+	if (!LuaMemPool::enabled || size > MAX_BUCKET_SIZE) {
 		allocStats[STAT_NAE] += 1 * (size > 0);
 		allocStats[STAT_NBE] += size;
 		auto t0 = spring_now();
@@ -111,24 +219,7 @@ void* LuaMemPool::Alloc(size_t size)
 		return ptr;
 	}
 
-	auto t0 = spring_now();
-	auto* ptr = luaMemPoolImpl->allocMem(size);
-	
-	if (size > NUM_BUCKETS * BUCKET_STEP) {
-		allocStats[STAT_NAE] += 1 * (size > 0);
-		allocStats[STAT_NBE] += size;
-		allocStats[STAT_NTE] += (spring_now() - t0).toMicroSecsi();
-	} else if (luaMemPoolImpl->isAllocInternal(ptr)) {
-		allocStats[STAT_NAI] += 1 * (size > 0);
-		allocStats[STAT_NBI] += size;
-		allocStats[STAT_NTI] += (spring_now() - t0).toMicroSecsi();
-	} else {
-		allocStats[STAT_NAF] += 1 * (size > 0);
-		allocStats[STAT_NBF] += size;
-		allocStats[STAT_NTF] += (spring_now() - t0).toMicroSecsi();
-	}
-
-	return ptr;
+	return (AllocChunk(BucketIndex(size)));
 }
 
 void* LuaMemPool::Realloc(void* ptr, size_t nsize, size_t osize)
@@ -136,63 +227,42 @@ void* LuaMemPool::Realloc(void* ptr, size_t nsize, size_t osize)
 	if (ptr == nullptr || osize == 0)
 		return Alloc(nsize);
 
-	if (!LuaMemPool::enabled) {
-		void* newPtr = ::operator new(nsize);
+	// shrinking or growing within the same size-class is free
+	if (LuaMemPool::enabled && nsize <= MAX_BUCKET_SIZE && osize <= MAX_BUCKET_SIZE && BucketIndex(nsize) == BucketIndex(osize))
+		return ptr;
 
-		if (newPtr == nullptr)
-			return nullptr;
+	void* newPtr = Alloc(nsize);
 
-		allocStats[STAT_NBE] -= osize;
-		allocStats[STAT_NBE] += nsize;
+	if (newPtr == nullptr)
+		return nullptr;
 
-		auto t0 = spring_now();
-		std::memcpy(newPtr, ptr, std::min(nsize, osize));
-		std::memset(ptr, 0, osize);
-		::operator delete(ptr);
-		allocStats[STAT_NTE] += (spring_now() - t0).toMicroSecsi();
-
-		return newPtr;
-	}
+	std::memcpy(newPtr, ptr, std::min(nsize, osize));
+	Free(ptr, osize);
 
-	auto t0 = spring_now();
-	auto* ret = luaMemPoolImpl->reAllocMem(ptr, nsize);
-	if (nsize > NUM_BUCKETS * BUCKET_STEP) {
-		allocStats[STAT_NAE] += 1 * (nsize > 0);
-		allocStats[STAT_NBE] += nsize;
-		allocStats[STAT_NTE] += (spring_now() - t0).toMicroSecsi();
-	}
-	else if (luaMemPoolImpl->isAllocInternal(ret)) {
-		allocStats[STAT_NAI] += 1 * (nsize > 0);
-		allocStats[STAT_NBI] += nsize;
-		allocStats[STAT_NTI] += (spring_now() - t0).toMicroSecsi();
-	}
-	else {
-		allocStats[STAT_NAF] += 1 * (nsize > 0);
-		allocStats[STAT_NBF] += nsize;
-		allocStats[STAT_NTF] += (spring_now() - t0).toMicroSecsi();
-	}
-	return ret;
+	return newPtr;
 }
 
 void LuaMemPool::Free(void* ptr, size_t size)
 {
-	if (!LuaMemPool::enabled) {
-		spring::SafeDelete(ptr);
+	if (ptr == nullptr)
+		return;
+
+	if (!LuaMemPool::enabled || size > MAX_BUCKET_SIZE) {
+		::operator delete(ptr);
 		return;
 	}
 
-	luaMemPoolImpl->freeMem(ptr);
+	FreeChunk(ptr, BucketIndex(size));
 }
 
 void LuaMemPool::LogStats(const char* handle, const char* lctype)
 {
 	static constexpr auto one = uint64_t(1);
 	const float intPerc = 100.0f * static_cast<float>(allocStats[STAT_NAI]) / static_cast<float>(std::max(allocStats[STAT_NAI] + allocStats[STAT_NAF] + allocStats[STAT_NAE], one));
-	const float avgAllocTimeI = static_cast<float>(allocStats[STAT_NTI]) / static_cast<float>(std::max(allocStats[STAT_NAI], one));
 	const float avgAllocTimeF = static_cast<float>(allocStats[STAT_NTF]) / static_cast<float>(std::max(allocStats[STAT_NAF], one));
 	const float avgAllocTimeE = static_cast<float>(allocStats[STAT_NTE]) / static_cast<float>(std::max(allocStats[STAT_NAE], one));
 	std::string msg = fmt::sprintf(
-		"[LuaMemPool::%s][handle=%s (%s)] index=%u numAllocs{int+, int-, ext, int_p}={%u, %u, %u, %.1f} allocedSize{int+, int-, ext}={%u, %u, %u}, avgAllocTime{int+, int-, ext}={%.4f, %.4f, %.4f}",
+		"[LuaMemPool::%s][handle=%s (%s)] index=%u numAllocs{int+, int-, ext, int_p}={%u, %u, %u, %.1f} allocedSize{int+, int-, ext}={%u, %u, %u}, avgAllocTime{int-, ext}={%.4f, %.4f}",
 		__func__,
 		handle,
 		lctype,
@@ -204,7 +274,6 @@ void LuaMemPool::LogStats(const char* handle, const char* lctype)
 		allocStats[STAT_NBI],
 		allocStats[STAT_NBF],
 		allocStats[STAT_NBE],
-		avgAllocTimeI,
 		avgAllocTimeF,
 		avgAllocTimeE
 	);
@@ -2,15 +2,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <memory>
-
-#include "System/bitops.h"
-#include "System/MemPoolTypes.h"
-#include "System/UnorderedMap.hpp"
-
-#define LMP_USE_CHUNK_TABLE 0
 
 class CLuaHandle;
 class LuaMemPool {
@@ -18,14 +13,7 @@ public:
 	explicit LuaMemPool(bool isEnabled);
 	explicit LuaMemPool(size_t lmpIndex);
 
-	~LuaMemPool() {
-		Clear();
-
-		if (!LuaMemPool::enabled)
-			return;
-
-		luaMemPoolImpl = nullptr;
-	}
+	~LuaMemPool() { Clear(); }
 
 	LuaMemPool(const LuaMemPool& p) = delete;
 	LuaMemPool(LuaMemPool&& p) = delete;
@@ -45,6 +33,8 @@ public:
 	static void KillStatic();
 
 public:
+	// returns all pages to the global page cache in O(#pages); must only
+	// be called when no allocations made from this pool are still alive
 	void Clear();
 	void* Alloc(size_t size);
 	void* Realloc(void* ptr, size_t nsize, size_t osize);
@@ -58,26 +48,50 @@ public:
 
 public:
 	static bool enabled;
-private:
+
 	static constexpr uint32_t NUM_BUCKETS = 32;
 	static constexpr uint32_t BUCKET_STEP = 16;
-	using LuaMemPoolImpl = PassThroughPool<NUM_BUCKETS, 4 * (1024 * 1024)>;
-	std::unique_ptr<LuaMemPoolImpl> luaMemPoolImpl;
+	static constexpr uint32_t MAX_BUCKET_SIZE = NUM_BUCKETS * BUCKET_STEP;
+	// pages are carved into chunks of a single size-class
+	static constexpr uint32_t PAGE_SIZE = 64 * 1024;
+
+private:
+	// Lua always passes the original block size back to the allocator,
+	// so the size-class can be derived without any per-chunk header
+	static constexpr uint32_t BucketIndex(size_t size) { return ((size + BUCKET_STEP - 1) / BUCKET_STEP - 1); }
+	static constexpr uint32_t BucketSize(uint32_t index) { return ((index + 1) * BUCKET_STEP); }
+
+	void* AllocChunk(uint32_t bucketIndex);
+	void FreeChunk(void* ptr, uint32_t bucketIndex);
+
+private:
+	struct FreeChunkNode {
+		FreeChunkNode* next;
+	};
+	struct BucketState {
+		FreeChunkNode* freeList = nullptr;
+
+		// bump-allocation range inside the most recently acquired page
+		uint8_t* pageCurr = nullptr;
+		uint8_t* pageEnd = nullptr;
+	};
+
+	std::array<BucketState, NUM_BUCKETS> buckets;
+	std::vector<uint8_t*> pages;
 
 	enum {
 		STAT_NAI = 0, // number of internal allocs
-		STAT_NAF = 1, // number of int fail allocs
+		STAT_NAF = 1, // number of int allocs that needed a new page
 		STAT_NAE = 2, // number of external allocs
 		STAT_NBI = 3, // number of bytes alloced (internal)
-		STAT_NBF = 4, // number of bytes alloced (int fail)
+		STAT_NBF = 4, // number of bytes alloced (int new page)
 		STAT_NBE = 5, // number of bytes alloced (external)
-		STAT_NTI = 6, // cumulative time spent on internal allocs
-		STAT_NTF = 7, // cumulative time spent on int fail allocs
-		STAT_NTE = 8, // cumulative time spent on external allocs
+		STAT_NTF = 6, // cumulative time spent on acquiring pages
+		STAT_NTE = 7, // cumulative time spent on external allocs
 	};
 
-	std::array<uint64_t, 9> allocStats = { 0, 0, 0, 0, 0 };
+	std::array<uint64_t, 8> allocStats = { 0, 0, 0, 0, 0 };
 
 	size_t globalIndex = 0;
 	size_t sharedCount = 0;
-};
\ No newline at end of file
+};
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstring>
 
 #include "lib/streflop/streflop_cond.h"
 
@@ -24,6 +25,7 @@
 #include "System/Misc/SpringTime.h"
 #include "System/ContainerUtil.h"
 #include "System/TimeProfiler.h"
+#include "System/UnorderedSet.hpp"
 #include "System/ScopedFPUSettings.h"
 #include "System/StringUtil.h"
 
@@ -292,6 +294,205 @@ bool LuaParser::Execute()
 }
 
 
+// generous for defs, keeps the recursive (de)serializers off the C stack limit
+static constexpr int MAX_SNAPSHOT_DEPTH = 64;
+
+// fails on anything the byte-stream can not reproduce exactly: functions and
+// other non-plain values, metatables, and tables referenced more than once
+// (restoring those would yield separate copies instead of a shared table)
+static bool WriteSnapshotValue(lua_State* L, int index, int depth, spring::unordered_set<const void*>& tables, std::vector<uint8_t>& buf)
+{
+	const auto WriteRaw = [&buf](const void* p, size_t n) {
+		buf.insert(buf.end(), reinterpret_cast<const uint8_t*>(p), reinterpret_cast<const uint8_t*>(p) + n);
+	};
+
+	const int type = lua_type(L, index);
+
+	buf.push_back(static_cast<uint8_t>(type));
+
+	switch (type) {
+		case LUA_TBOOLEAN: {
+			buf.push_back(lua_toboolean(L, index));
+			return true;
+		} break;
+		case LUA_TNUMBER: {
+			const lua_Number num = lua_tonumber(L, index);
+			WriteRaw(&num, sizeof(num));
+			return true;
+		} break;
+		case LUA_TSTRING: {
+			size_t len = 0;
+			const char* str = lua_tolstring(L, index, &len);
+			const uint32_t len32 = len;
+			WriteRaw(&len32, sizeof(len32));
+			WriteRaw(str, len);
+			return true;
+		} break;
+		case LUA_TTABLE: {
+			if (depth >= MAX_SNAPSHOT_DEPTH)
+				return false;
+			if (!tables.insert(lua_topointer(L, index)).second)
+				return false;
+
+			if (lua_getmetatable(L, index)) {
+				lua_pop(L, 1);
+				return false;
+			}
+
+			if (!lua_checkstack(L, 3))
+				return false;
+
+			const int tableIdx = (index > 0)? index: (lua_gettop(L) + index + 1);
+			const size_t cntPos = buf.size();
+
+			uint32_t cnt = 0;
+			WriteRaw(&cnt, sizeof(cnt));
+
+			// on failure key and value are left on the stack, GetRootSnapshot resets it
+			for (lua_pushnil(L); lua_next(L, tableIdx) != 0; lua_pop(L, 1)) {
+				if (!WriteSnapshotValue(L, -2, depth + 1, tables, buf))
+					return false;
+				if (!WriteSnapshotValue(L, -1, depth + 1, tables, buf))
+					return false;
+
+				cnt++;
+			}
+
+			std::memcpy(&buf[cntPos], &cnt, sizeof(cnt));
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	return false;
+}
+
+// pushes the value on success, the caller resets the stack on failure
+static bool ReadSnapshotValue(lua_State* L, const std::vector<uint8_t>& buf, size_t& pos, int depth)
+{
+	const auto ReadRaw = [&buf, &pos](void* p, size_t n) {
+		if ((pos + n) > buf.size())
+			return false;
+
+		std::memcpy(p, &buf[pos], n);
+		pos += n;
+		return true;
+	};
+
+	uint8_t type = 0;
+	uint32_t len = 0;
+
+	if (!ReadRaw(&type, sizeof(type)))
+		return false;
+
+	switch (type) {
+		case LUA_TBOOLEAN: {
+			uint8_t bol = 0;
+
+			if (!ReadRaw(&bol, sizeof(bol)))
+				return false;
+
+			lua_pushboolean(L, bol != 0);
+			return true;
+		} break;
+		case LUA_TNUMBER: {
+			lua_Number num = 0;
+
+			if (!ReadRaw(&num, sizeof(num)))
+				return false;
+
+			lua_pushnumber(L, num);
+			return true;
+		} break;
+		case LUA_TSTRING: {
+			if (!ReadRaw(&len, sizeof(len)) || (pos + len) > buf.size())
+				return false;
+
+			lua_pushlstring(L, reinterpret_cast<const char*>(&buf[pos]), len);
+			pos += len;
+			return true;
+		} break;
+		case LUA_TTABLE: {
+			if (depth >= MAX_SNAPSHOT_DEPTH || !lua_checkstack(L, 3))
+				return false;
+			if (!ReadRaw(&len, sizeof(len)) || (pos + len * 2) > buf.size())
+				return false;
+
+			lua_newtable(L);
+
+			for (uint32_t i = 0; i < len; i++) {
+				if (!ReadSnapshotValue(L, buf, pos, depth + 1))
+					return false;
+				if (!ReadSnapshotValue(L, buf, pos, depth + 1))
+					return false;
+
+				lua_rawset(L, -3);
+			}
+
+			return true;
+		} break;
+		default: {
+		} break;
+	}
+
+	return false;
+}
+
+
+bool LuaParser::ExecuteSnapshot(const std::vector<uint8_t>& snapshot)
+{
+	if (!IsValid()) {
+		errorLog = "could not initialize Lua library";
+		return false;
+	}
+
+	assert(rootRef == LUA_NOREF);
+	assert(initDepth == 0);
+
+	const int top = lua_gettop(L);
+	size_t pos = 0;
+
+	// leave the state untouched on failure, callers can still fall back to Execute
+	if (!ReadSnapshotValue(L, snapshot, pos, 0) || !lua_istable(L, -1) || pos != snapshot.size()) {
+		lua_settop(L, top);
+		errorLog = "invalid snapshot data";
+		return false;
+	}
+
+	initDepth = -1;
+
+	rootRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	lua_settop(L, 0);
+
+	return (valid = true);
+}
+
+bool LuaParser::GetRootSnapshot(std::vector<uint8_t>& snapshot)
+{
+	if (!IsValid() || rootRef == LUA_NOREF)
+		return false;
+
+	spring::unordered_set<const void*> tables;
+
+	const int top = lua_gettop(L);
+
+	snapshot.clear();
+	lua_rawgeti(L, LUA_REGISTRYINDEX, rootRef);
+
+	const bool ret = WriteSnapshotValue(L, -1, 0, tables, snapshot);
+
+	lua_settop(L, top);
+
+	if (!ret) {
+		LOG_L(L_WARNING, "[LuaParser::%s] defs table of \"%s\" holds data that can not be snapshotted exactly", __func__, fileName.c_str());
+		snapshot.clear();
+	}
+
+	return ret;
+}
+
+
 void LuaParser::AddTable(LuaTable* tbl) { spring::VectorInsertUnique(tables, tbl); }
 void LuaParser::RemoveTable(LuaTable* tbl) { spring::VectorErase(tables, tbl); }
 
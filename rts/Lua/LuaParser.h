@@ -132,6 +132,12 @@ public:
 	void SetupLua(bool isSyncedCtxt, bool isDefsParser);
 
 	bool Execute();
+	// rebuilds the root table from GetRootSnapshot output instead of running code;
+	// GetRootSnapshot fails unless the table is plain data (unshared tables without
+	// metatables, strings, numbers, booleans) that round-trips exactly
+	bool ExecuteSnapshot(const std::vector<uint8_t>& snapshot);
+	bool GetRootSnapshot(std::vector<uint8_t>& snapshot);
+
 	bool IsValid() const { return (L != nullptr); } // true if nothing failed during Execute
 	bool NoTable() const { return (errorLog.find("no return table") == 0); } // parser is still valid if true
 
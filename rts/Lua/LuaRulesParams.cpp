@@ -1,12 +1,312 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
 #include "LuaRulesParams.h"
+#include "System/UnorderedMap.hpp"
 
 using namespace LuaRulesParams;
 
-CR_BIND(Param,)
-CR_REG_METADATA(Param, (
-	CR_MEMBER(los),
-	CR_MEMBER(valueInt),
-	CR_MEMBER(valueString)
+CR_BIND(Params,)
+CR_REG_METADATA(Params, (
+	CR_IGNORED(params),
+	CR_IGNORED(valueStrings),
+	CR_IGNORED(version),
+	CR_SERIALIZER(Serialize)
 ))
+
+
+struct KeyTable {
+	spring::unordered_map<std::string, int> keyIDs;
+	// deque so references returned by GetKeyName stay valid
+	std::deque<std::string> keyNames;
+	std::vector<int> refCounts;
+	std::vector<int> freeIDs;
+
+	// not locked: keys (like the params themselves) are only acquired and
+	// released by synced code on the sim thread, and the other readers (the
+	// async AI thread) only run while the sim is not updating, so reads and
+	// writes never overlap
+};
+
+// never destroyed; static Params (e.g. the game params) release their keys on exit
+static KeyTable& GetKeyTable()
+{
+	static KeyTable* keyTable = new KeyTable();
+	return *keyTable;
+}
+
+
+int LuaRulesParams::AcquireKeyID(const std::string& name)
+{
+	KeyTable& kt = GetKeyTable();
+
+	const auto it = kt.keyIDs.find(name);
+
+	if (it != kt.keyIDs.end()) {
+		kt.refCounts[it->second] += 1;
+		return it->second;
+	}
+
+	int keyID = static_cast<int>(kt.keyNames.size());
+
+	if (kt.freeIDs.empty()) {
+		kt.keyNames.push_back(name);
+		kt.refCounts.push_back(1);
+	} else {
+		keyID = kt.freeIDs.back();
+		kt.freeIDs.pop_back();
+
+		kt.keyNames[keyID] = name;
+		kt.refCounts[keyID] = 1;
+	}
+
+	kt.keyIDs.emplace(name, keyID);
+	return keyID;
+}
+
+static void AddKeyRef(int keyID)
+{
+	KeyTable& kt = GetKeyTable();
+
+	assert(kt.refCounts[keyID] > 0);
+	kt.refCounts[keyID] += 1;
+}
+
+void LuaRulesParams::ReleaseKeyID(int keyID)
+{
+	KeyTable& kt = GetKeyTable();
+
+	assert(kt.refCounts[keyID] > 0);
+
+	if ((kt.refCounts[keyID] -= 1) > 0)
+		return;
+
+	kt.keyIDs.erase(kt.keyNames[keyID]);
+	kt.keyNames[keyID].clear();
+	kt.keyNames[keyID].shrink_to_fit();
+	kt.freeIDs.push_back(keyID);
+}
+
+int LuaRulesParams::FindKeyID(const std::string& name)
+{
+	KeyTable& kt = GetKeyTable();
+
+	const auto it = kt.keyIDs.find(name);
+
+	if (it == kt.keyIDs.end())
+		return -1;
+
+	return it->second;
+}
+
+const std::string& LuaRulesParams::GetKeyName(int keyID)
+{
+	KeyTable& kt = GetKeyTable();
+	return kt.keyNames[keyID];
+}
+
+static bool ParamKeyCmp(const Param& p, int keyID) { return (p.keyID < keyID); }
+
+const Param* Params::Find(int keyID) const
+{
+	if (keyID < 0)
+		return nullptr;
+
+	const auto it = std::lower_bound(params.begin(), params.end(), keyID, ParamKeyCmp);
+
+	if (it == params.end() || it->keyID != keyID)
+		return nullptr;
+
+	return &(*it);
+}
+
+Params& Params::operator = (const Params& p)
+{
+	if (this == &p)
+		return *this;
+
+	clear();
+
+	params = p.params;
+	valueStrings = p.valueStrings;
+
+	for (const Param& q: params) {
+		AddKeyRef(q.keyID);
+	}
+
+	version += 1;
+	return *this;
+}
+
+
+Param& Params::Insert(const std::string& name, bool& inserted)
+{
+	const int keyID = FindKeyID(name);
+	const auto it = std::lower_bound(params.begin(), params.end(), keyID, ParamKeyCmp);
+
+	if ((inserted = (keyID < 0 || it == params.end() || it->keyID != keyID))) {
+		const int newKeyID = AcquireKeyID(name);
+		const auto pos = std::lower_bound(params.begin(), params.end(), newKeyID, ParamKeyCmp);
+
+		Param& p = *params.insert(pos, Param{});
+		p.keyID = newKeyID;
+		return p;
+	}
+
+	return *it;
+}
+
+
+Param& Params::SetNumber(const std::string& name, float value)
+{
+	bool changed = false;
+	Param& p = Insert(name, changed);
+
+	changed |= IsString(p);
+	changed |= (p.valueInt != value);
+
+	EraseString(p);
+	p.valueInt = value;
+
+	version += changed;
+	return p;
+}
+
+Param& Params::SetString(const std::string& name, const std::string& value)
+{
+	bool changed = false;
+	Param& p = Insert(name, changed);
+
+	// empty strings were never distinguishable from numeric params
+	if (value.empty()) {
+		changed |= IsString(p);
+		EraseString(p);
+
+		version += changed;
+		return p;
+	}
+
+	if (p.valueStrIdx < 0) {
+		p.valueStrIdx = static_cast<int>(valueStrings.size());
+		valueStrings.emplace_back();
+		changed = true;
+	}
+
+	changed |= (valueStrings[p.valueStrIdx] != value);
+	valueStrings[p.valueStrIdx] = value;
+
+	version += changed;
+	return p;
+}
+
+void Params::Erase(const std::string& name)
+{
+	const int keyID = FindKeyID(name);
+	const auto it = std::lower_bound(params.begin(), params.end(), keyID, ParamKeyCmp);
+
+	if (keyID < 0 || it == params.end() || it->keyID != keyID)
+		return;
+
+	EraseString(*it);
+	ReleaseKeyID(keyID);
+	params.erase(it);
+
+	version += 1;
+}
+
+void Params::EraseString(Param& p)
+{
+	if (p.valueStrIdx < 0)
+		return;
+
+	// swap-remove; re-point the param that owned the moved string
+	const int lastIdx = static_cast<int>(valueStrings.size()) - 1;
+
+	if (p.valueStrIdx != lastIdx) {
+		for (Param& q: params) {
+			if (q.valueStrIdx != lastIdx)
+				continue;
+
+			q.valueStrIdx = p.valueStrIdx;
+			break;
+		}
+
+		valueStrings[p.valueStrIdx] = std::move(valueStrings[lastIdx]);
+	}
+
+	valueStrings.pop_back();
+	p.valueStrIdx = -1;
+}
+
+void Params::clear()
+{
+	version += (!params.empty());
+
+	for (const Param& p: params) {
+		ReleaseKeyID(p.keyID);
+	}
+
+	params.clear();
+	valueStrings.clear();
+}
+
+
+void Params::Serialize(creg::ISerializer* s)
+{
+	// key-IDs depend on the order params were first used in this process,
+	// so entries are stored by name
+	std::string name;
+	std::string valueString;
+
+	if (s->IsWriting()) {
+		int numParams = static_cast<int>(params.size());
+		s->SerializeInt(&numParams, sizeof(numParams));
+
+		for (Param& p: params) {
+			name = GetKeyName(p.keyID);
+			valueString = IsString(p)? GetString(p): "";
+
+			int nameSize = static_cast<int>(name.size());
+			int valueSize = static_cast<int>(valueString.size());
+			int isString = IsString(p);
+
+			s->SerializeInt(&nameSize, sizeof(nameSize));
+			s->Serialize(&name[0], nameSize);
+			s->SerializeInt(&p.los, sizeof(p.los));
+			s->Serialize(&p.valueInt, sizeof(p.valueInt));
+			s->SerializeInt(&isString, sizeof(isString));
+			s->SerializeInt(&valueSize, sizeof(valueSize));
+			s->Serialize(&valueString[0], valueSize);
+		}
+	} else {
+		int numParams = 0;
+		s->SerializeInt(&numParams, sizeof(numParams));
+
+		clear();
+
+		for (int i = 0; i < numParams; i++) {
+			int nameSize = 0;
+			int valueSize = 0;
+			int isString = 0;
+			int los = RULESPARAMLOS_PRIVATE;
+			float valueInt = 0.0f;
+
+			s->SerializeInt(&nameSize, sizeof(nameSize));
+			name.resize(nameSize);
+			s->Serialize(&name[0], nameSize);
+			s->SerializeInt(&los, sizeof(los));
+			s->Serialize(&valueInt, sizeof(valueInt));
+			s->SerializeInt(&isString, sizeof(isString));
+			s->SerializeInt(&valueSize, sizeof(valueSize));
+			valueString.resize(valueSize);
+			s->Serialize(&valueString[0], valueSize);
+
+			Param& p = isString? SetString(name, valueString): SetNumber(name, valueInt);
+			p.los = los;
+			p.valueInt = valueInt;
+		}
+	}
+}
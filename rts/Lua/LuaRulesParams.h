@@ -3,9 +3,10 @@
 #ifndef LUA_RULESPARAMS_H
 #define LUA_RULESPARAMS_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
-#include "System/UnorderedMap.hpp"
 #include "System/creg/creg_cond.h"
 
 namespace LuaRulesParams
@@ -27,15 +28,69 @@ namespace LuaRulesParams
 		RULESPARAMLOS_PUBLIC_MASK  = RULESPARAMLOS_PUBLIC
 	};
 
-	struct Param {
-		CR_DECLARE_STRUCT(Param)
+	// param names are interned into process-wide IDs, shared by all objects;
+	// IDs are assigned in order of first use and are never serialized. Each
+	// param holds a reference to its key, the ID of a key no param refers to
+	// anymore is recycled. Only the sim thread may acquire or release keys.
+	int AcquireKeyID(const std::string& name);
+	void ReleaseKeyID(int keyID);
+	int FindKeyID(const std::string& name);
+	const std::string& GetKeyName(int keyID);
 
+	struct Param {
+		int   keyID = -1;
 		int   los = RULESPARAMLOS_PRIVATE;
 		float valueInt = 0.0f;
-		std::string valueString;
+		int   valueStrIdx = -1; // index into Params::valueStrings if string-valued
 	};
 
-	typedef spring::unordered_map<std::string, Param> Params;
+	// flat per-object table, sorted by key-ID
+	class Params {
+		CR_DECLARE_STRUCT(Params)
+
+	public:
+		Params() = default;
+		Params(const Params& p) { *this = p; }
+		~Params() { clear(); }
+
+		Params& operator = (const Params& p);
+
+	public:
+		const Param* Find(const std::string& name) const { return (Find(FindKeyID(name))); }
+		const Param* Find(int keyID) const;
+
+		bool IsString(const Param& p) const { return (p.valueStrIdx >= 0); }
+		const std::string& GetString(const Param& p) const { return valueStrings[p.valueStrIdx]; }
+
+		Param& SetNumber(const std::string& name, float value);
+		Param& SetString(const std::string& name, const std::string& value);
+		void SetLos(Param& p, int los) { version += (p.los != los); p.los = los; }
+		void Erase(const std::string& name);
+
+		void clear();
+
+		size_t size() const { return params.size(); }
+		bool empty() const { return params.empty(); }
+
+		std::vector<Param>::const_iterator begin() const { return params.cbegin(); }
+		std::vector<Param>::const_iterator end() const { return params.cend(); }
+
+		// incremented on every change of a value, LOS-mask or the set of params;
+		// lets readers skip unchanged objects
+		std::uint32_t GetVersion() const { return version; }
+
+		void Serialize(creg::ISerializer* s);
+
+	private:
+		Param& Insert(const std::string& name, bool& inserted);
+		void EraseString(Param& p);
+
+	private:
+		std::vector<Param> params;
+		std::vector<std::string> valueStrings;
+
+		std::uint32_t version = 0;
+	};
 }
 
 #endif // LUA_RULESPARAMS_H
@@ -44,6 +44,7 @@
 #include "Sim/Misc/QuadField.h"
 #include "Sim/Misc/Wind.h"
 #include "Sim/MoveTypes/AAirMoveType.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/Projectiles/ExplosionGenerator.h"
 #include "Sim/Projectiles/Projectile.h"
@@ -1261,16 +1262,15 @@ void SetRulesParam(lua_State* L, const char* caller, int offset,
 
 	const std::string& key = luaL_checkstring(L, index);
 
-	LuaRulesParams::Param& param = params[key];
+	LuaRulesParams::Param* param = nullptr;
 
 	// set the value of the parameter
 	if (lua_israwnumber(L, valIndex)) {
-		param.valueInt = lua_tofloat(L, valIndex);
-		param.valueString.resize(0);
+		param = &params.SetNumber(key, lua_tofloat(L, valIndex));
 	} else if (lua_isstring(L, valIndex)) {
-		param.valueString = lua_tostring(L, valIndex);
+		param = &params.SetString(key, lua_tostring(L, valIndex));
 	} else if (lua_isnoneornil(L, valIndex)) {
-		params.erase(key);
+		params.Erase(key);
 		return; //no need to set los if param was erased
 	} else {
 		luaL_error(L, "Incorrect arguments to %s()", caller);
@@ -1300,9 +1300,9 @@ void SetRulesParam(lua_State* L, const char* caller, int offset,
 			}
 		}
 
-		param.los = losMask;
+		params.SetLos(*param, losMask);
 	} else {
-		param.los = luaL_optint(L, losIndex, param.los);
+		params.SetLos(*param, luaL_optint(L, losIndex, param->los));
 	}
 }
 
@@ -6134,6 +6134,7 @@ int LuaSyncedCtrl::SetMapSquareTerrainType(lua_State* L)
 	const int ntt = luaL_checkint(L, 3);
 
 	readMap->GetTypeMapSynced()[tz * mapDims.hmapx + tx] = std::max(0, std::min(ntt, (CMapInfo::NUM_TERRAIN_TYPES - 1)));
+	moveDefHandler.UpdateSpeedModGrids({hx, hz, hx, hz});
 	pathManager->TerrainChange(hx, hz,  hx + 1, hz + 1,  TERRAINCHANGE_SQUARE_TYPEMAP_INDEX);
 
 	lua_pushnumber(L, ott);
@@ -6179,8 +6180,10 @@ int LuaSyncedCtrl::SetTerrainTypeData(lua_State* L)
 	// hardness changes do not require repathing
 	if (ttHardnessChanged)
 		mapDamage->TerrainTypeHardnessChanged(tti);
-	if (ttSpeedModChanged)
+	if (ttSpeedModChanged) {
+		moveDefHandler.UpdateSpeedModGrids({0, 0, mapDims.mapxm1, mapDims.mapym1});
 		mapDamage->TerrainTypeSpeedModChanged(tti);
+	}
 
 	lua_pushboolean(L, true);
 	return 1;
@@ -118,6 +118,7 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 
 	REGISTER_LUA_CFUNC(GetGameRulesParam);
 	REGISTER_LUA_CFUNC(GetGameRulesParams);
+	REGISTER_LUA_CFUNC(GetGameRulesParamsVersion);
 
 	REGISTER_LUA_CFUNC(GetMapOptions);
 	REGISTER_LUA_CFUNC(GetModOptions);
@@ -149,6 +150,7 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 	REGISTER_LUA_CFUNC(GetTeamResourceStats);
 	REGISTER_LUA_CFUNC(GetTeamRulesParam);
 	REGISTER_LUA_CFUNC(GetTeamRulesParams);
+	REGISTER_LUA_CFUNC(GetTeamRulesParamsVersion);
 	REGISTER_LUA_CFUNC(GetTeamStatsHistory);
 	REGISTER_LUA_CFUNC(GetTeamLuaAI);
 
@@ -263,6 +265,7 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 
 	REGISTER_LUA_CFUNC(GetUnitRulesParam);
 	REGISTER_LUA_CFUNC(GetUnitRulesParams);
+	REGISTER_LUA_CFUNC(GetUnitRulesParamsVersion);
 
 	REGISTER_LUA_CFUNC(GetCEGID);
 
@@ -291,6 +294,7 @@ bool LuaSyncedRead::PushEntries(lua_State* L)
 
 	REGISTER_LUA_CFUNC(GetFeatureRulesParam);
 	REGISTER_LUA_CFUNC(GetFeatureRulesParams);
+	REGISTER_LUA_CFUNC(GetFeatureRulesParamsVersion);
 
 	REGISTER_LUA_CFUNC(GetProjectilePosition);
 	REGISTER_LUA_CFUNC(GetProjectileDirection);
@@ -669,14 +673,14 @@ static int PushRulesParams(lua_State* L, const char* caller,
 {
 	lua_createtable(L, 0, params.size());
 
-	for (auto& it: params) {
-		const std::string& name = it.first;
-		const LuaRulesParams::Param& param = it.second;
+	for (const LuaRulesParams::Param& param: params) {
 		if (!(param.los & losStatus))
 			continue;
 
-		if (!param.valueString.empty()) {
-			LuaPushNamedString(L, name, param.valueString);
+		const std::string& name = LuaRulesParams::GetKeyName(param.keyID);
+
+		if (params.IsString(param)) {
+			LuaPushNamedString(L, name, params.GetString(param));
 		} else {
 			LuaPushNamedNumber(L, name, param.valueInt);
 		}
@@ -691,17 +695,16 @@ static int GetRulesParam(lua_State* L, const char* caller, int index,
                           const int& losStatus)
 {
 	const std::string& key = luaL_checkstring(L, index);
-	const auto it = params.find(key);
-	if (it == params.end())
-		return 0;
+	const LuaRulesParams::Param* param = params.Find(key);
 
-	const LuaRulesParams::Param& param = it->second;
+	if (param == nullptr)
+		return 0;
 
-	if (param.los & losStatus) {
-		if (!param.valueString.empty()) {
-			lua_pushsstring(L, param.valueString);
+	if (param->los & losStatus) {
+		if (params.IsString(*param)) {
+			lua_pushsstring(L, params.GetString(*param));
 		} else {
-			lua_pushnumber(L, param.valueInt);
+			lua_pushnumber(L, param->valueInt);
 		}
 		return 1;
 	}
@@ -942,6 +945,31 @@ int LuaSyncedRead::GetGameRulesParams(lua_State* L)
 }
 
 
+static int GetTeamRulesParamLosMask(lua_State* L, const CTeam* team)
+{
+	if (LuaUtils::IsAlliedTeam(L, team->teamNum) || game->IsGameOver())
+		return LuaRulesParams::RULESPARAMLOS_PRIVATE_MASK;
+	if (teamHandler.AlliedTeams(team->teamNum, CLuaHandle::GetHandleReadTeam(L)))
+		return LuaRulesParams::RULESPARAMLOS_ALLIED_MASK;
+
+	return LuaRulesParams::RULESPARAMLOS_PUBLIC;
+}
+
+static int GetFeatureRulesParamLosMask(lua_State* L, const CFeature* feature)
+{
+	if (LuaUtils::IsAlliedAllyTeam(L, feature->allyteam) || game->IsGameOver())
+		return LuaRulesParams::RULESPARAMLOS_PRIVATE_MASK;
+	if (teamHandler.AlliedTeams(feature->team, CLuaHandle::GetHandleReadTeam(L)))
+		return LuaRulesParams::RULESPARAMLOS_ALLIED_MASK;
+	if (CLuaHandle::GetHandleReadAllyTeam(L) < 0)
+		return LuaRulesParams::RULESPARAMLOS_PUBLIC_MASK;
+	if (LuaUtils::IsFeatureVisible(L, feature))
+		return LuaRulesParams::RULESPARAMLOS_INLOS_MASK;
+
+	return LuaRulesParams::RULESPARAMLOS_PUBLIC_MASK;
+}
+
+
 /***
  *
  * @function Spring.GetTeamRulesParams
@@ -956,16 +984,7 @@ int LuaSyncedRead::GetTeamRulesParams(lua_State* L)
 	if (team == nullptr || game == nullptr)
 		return 0;
 
-	int losMask = LuaRulesParams::RULESPARAMLOS_PUBLIC;
-
-	if (LuaUtils::IsAlliedTeam(L, team->teamNum) || game->IsGameOver()) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_PRIVATE_MASK;
-	}
-	else if (teamHandler.AlliedTeams(team->teamNum, CLuaHandle::GetHandleReadTeam(L))) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_ALLIED_MASK;
-	}
-
-	return PushRulesParams(L, __func__, team->modParams, losMask);
+	return PushRulesParams(L, __func__, team->modParams, GetTeamRulesParamLosMask(L, team));
 }
 
 
@@ -1023,24 +1042,98 @@ int LuaSyncedRead::GetFeatureRulesParams(lua_State* L)
 	if (feature == nullptr)
 		return 0;
 
-	int losMask = LuaRulesParams::RULESPARAMLOS_PUBLIC_MASK;
+	return PushRulesParams(L, __func__, feature->modParams, GetFeatureRulesParamLosMask(L, feature));
+}
 
-	if (LuaUtils::IsAlliedAllyTeam(L, feature->allyteam) || game->IsGameOver()) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_PRIVATE_MASK;
-	}
-	else if (teamHandler.AlliedTeams(feature->team, CLuaHandle::GetHandleReadTeam(L))) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_ALLIED_MASK;
-	}
-	else if (CLuaHandle::GetHandleReadAllyTeam(L) < 0) {
-		//! NoAccessTeam
-	}
-	else if (LuaUtils::IsFeatureVisible(L, feature)) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_INLOS_MASK;
-	}
 
-	const LuaRulesParams::Params&  params = feature->modParams;
+/***
+ *
+ * @function Spring.GetGameRulesParamsVersion
+ *
+ * Incremented whenever a game rules param is set or removed, so readers can skip rereading unchanged params.
+ *
+ * @treturn number version
+ */
+int LuaSyncedRead::GetGameRulesParamsVersion(lua_State* L)
+{
+	lua_pushnumber(L, CSplitLuaHandle::GetGameParams().GetVersion());
+	return 1;
+}
+
+
+/***
+ *
+ * @function Spring.GetUnitRulesParamsVersion
+ *
+ * Incremented whenever a rules param of the unit is set or removed. Only
+ * available to readers allied with the unit, since changes to private params
+ * would otherwise leak.
+ *
+ * @number unitID
+ *
+ * @treturn nil|number version
+ */
+int LuaSyncedRead::GetUnitRulesParamsVersion(lua_State* L)
+{
+	const CUnit* unit = ParseUnit(L, __func__, 1);
+	if (unit == nullptr || game == nullptr)
+		return 0;
+
+	if ((GetUnitRulesParamLosMask(L, unit) & LuaRulesParams::RULESPARAMLOS_ALLIED) == 0)
+		return 0;
 
-	return PushRulesParams(L, __func__, params, losMask);
+	lua_pushnumber(L, unit->modParams.GetVersion());
+	return 1;
+}
+
+
+/***
+ *
+ * @function Spring.GetTeamRulesParamsVersion
+ *
+ * Incremented whenever a rules param of the team is set or removed. Only
+ * available to readers allied with the team.
+ *
+ * @number teamID
+ *
+ * @treturn nil|number version
+ */
+int LuaSyncedRead::GetTeamRulesParamsVersion(lua_State* L)
+{
+	const CTeam* team = ParseTeam(L, __func__, 1);
+	if (team == nullptr || game == nullptr)
+		return 0;
+
+	if ((GetTeamRulesParamLosMask(L, team) & LuaRulesParams::RULESPARAMLOS_ALLIED) == 0)
+		return 0;
+
+	lua_pushnumber(L, team->modParams.GetVersion());
+	return 1;
+}
+
+
+/***
+ *
+ * @function Spring.GetFeatureRulesParamsVersion
+ *
+ * Incremented whenever a rules param of the feature is set or removed. Only
+ * available to readers allied with the feature.
+ *
+ * @number featureID
+ *
+ * @treturn nil|number version
+ */
+int LuaSyncedRead::GetFeatureRulesParamsVersion(lua_State* L)
+{
+	const CFeature* feature = ParseFeature(L, __func__, 1);
+	if (feature == nullptr || game == nullptr)
+		return 0;
+
+	if ((GetFeatureRulesParamLosMask(L, feature) & LuaRulesParams::RULESPARAMLOS_ALLIED) == 0)
+		return 0;
+
+	lua_pushnumber(L, feature->modParams.GetVersion());
+	return 1;
 }
 
 
@@ -1074,16 +1167,7 @@ int LuaSyncedRead::GetTeamRulesParam(lua_State* L)
 	if (team == nullptr || game == nullptr)
 		return 0;
 
-	int losMask = LuaRulesParams::RULESPARAMLOS_PUBLIC;
-
-	if (LuaUtils::IsAlliedTeam(L, team->teamNum) || game->IsGameOver()) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_PRIVATE_MASK;
-	}
-	else if (teamHandler.AlliedTeams(team->teamNum, CLuaHandle::GetHandleReadTeam(L))) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_ALLIED_MASK;
-	}
-
-	return GetRulesParam(L, __func__, 2, team->modParams, losMask);
+	return GetRulesParam(L, __func__, 2, team->modParams, GetTeamRulesParamLosMask(L, team));
 }
 
 
@@ -1122,22 +1206,7 @@ int LuaSyncedRead::GetFeatureRulesParam(lua_State* L)
 	if (feature == nullptr)
 		return 0;
 
-	int losMask = LuaRulesParams::RULESPARAMLOS_PUBLIC_MASK;
-
-	if (LuaUtils::IsAlliedAllyTeam(L, feature->allyteam) || game->IsGameOver()) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_PRIVATE_MASK;
-	}
-	else if (teamHandler.AlliedTeams(feature->team, CLuaHandle::GetHandleReadTeam(L))) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_ALLIED_MASK;
-	}
-	else if (CLuaHandle::GetHandleReadAllyTeam(L) < 0) {
-		//! NoAccessTeam
-	}
-	else if (LuaUtils::IsFeatureVisible(L, feature)) {
-		losMask |= LuaRulesParams::RULESPARAMLOS_INLOS_MASK;
-	}
-
-	return GetRulesParam(L, __func__, 2, feature->modParams, losMask);
+	return GetRulesParam(L, __func__, 2, feature->modParams, GetFeatureRulesParamLosMask(L, feature));
 }
 
 
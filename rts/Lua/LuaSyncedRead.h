@@ -37,6 +37,7 @@ class LuaSyncedRead {
 
 		static int GetGameRulesParam(lua_State* L);
 		static int GetGameRulesParams(lua_State* L);
+		static int GetGameRulesParamsVersion(lua_State* L);
 
 		static int GetTidal(lua_State* L);
 		static int GetWind(lua_State* L);
@@ -64,6 +65,7 @@ class LuaSyncedRead {
 		static int GetTeamResourceStats(lua_State* L);
 		static int GetTeamRulesParam(lua_State* L);
 		static int GetTeamRulesParams(lua_State* L);
+		static int GetTeamRulesParamsVersion(lua_State* L);
 		static int GetTeamStatsHistory(lua_State* L);
 		static int GetTeamLuaAI(lua_State* L);
 
@@ -172,6 +174,7 @@ class LuaSyncedRead {
 
 		static int GetUnitRulesParam(lua_State* L);
 		static int GetUnitRulesParams(lua_State* L);
+		static int GetUnitRulesParamsVersion(lua_State* L);
 
 		static int GetUnitLosState(lua_State* L);
 		static int GetUnitSeparation(lua_State* L);
@@ -206,6 +209,7 @@ class LuaSyncedRead {
 
 		static int GetFeatureRulesParam(lua_State* L);
 		static int GetFeatureRulesParams(lua_State* L);
+		static int GetFeatureRulesParamsVersion(lua_State* L);
 
 		static int GetProjectilePosition(lua_State* L);
 		static int GetProjectileDirection(lua_State* L);
@@ -72,6 +72,7 @@
 #include "System/Platform/Misc.h"
 #include "System/Sound/ISoundChannels.h"
 #include "System/StringUtil.h"
+#include "System/Sync/SyncChecker.h"
 #include "System/Misc/SpringTime.h"
 #include "System/ScopedResource.h"
 
@@ -100,6 +101,7 @@ bool LuaUnsyncedRead::PushEntries(lua_State* L)
 {
 	REGISTER_LUA_CFUNC(IsReplay);
 	REGISTER_LUA_CFUNC(GetReplayLength);
+	REGISTER_LUA_CFUNC(GetSyncChecksum);
 
 	REGISTER_LUA_CFUNC(GetGameName);
 	REGISTER_LUA_CFUNC(GetMenuName);
@@ -430,6 +432,27 @@ int LuaUnsyncedRead::GetReplayLength(lua_State* L)
 	return 0;
 }
 
+/***
+ *
+ * @function Spring.GetSyncChecksum
+ *
+ * Running checksum over all synced assignments, as sent to the server after
+ * each frame; it is reset every 4096 frames.
+ *
+ * @treturn ?nil|string checksum eight hex digits, nil if the engine was built without sync checks
+ */
+int LuaUnsyncedRead::GetSyncChecksum(lua_State* L)
+{
+#ifdef SYNCCHECK
+	char buf[16];
+	SNPRINTF(buf, sizeof(buf), "%08x", CSyncChecker::GetChecksum());
+	lua_pushstring(L, buf);
+	return 1;
+#else
+	return 0;
+#endif
+}
+
 /******************************************************************************
  * Game/Menu Name
  * @section gamename
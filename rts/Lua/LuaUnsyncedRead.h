@@ -15,6 +15,7 @@ class LuaUnsyncedRead {
 	public:
 		static int IsReplay(lua_State* L);
 		static int GetReplayLength(lua_State* L);
+		static int GetSyncChecksum(lua_State* L);
 
 		static int GetGameName(lua_State* L);
 		static int GetMenuName(lua_State* L);
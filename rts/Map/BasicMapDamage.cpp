@@ -214,6 +214,13 @@ void CBasicMapDamage::Explosion(const float3& pos, float strength, float radius)
 }
 
 void CBasicMapDamage::RecalcArea(int x1, int x2, int y1, int y2)
+{
+	// external callers expect the new heights to be in effect right away
+	QueueRecalcArea(x1, x2, y1, y2);
+	FlushRecalcAreas();
+}
+
+void CBasicMapDamage::QueueRecalcArea(int x1, int x2, int y1, int y2)
 {
 	if (!readMap->GetHeightMapUpdated())
 		return;
@@ -221,22 +228,41 @@ void CBasicMapDamage::RecalcArea(int x1, int x2, int y1, int y2)
 	x1 = std::max(x1, 0); x2 = std::clamp(x2, x1, mapDims.mapx);
 	y1 = std::max(y1, 0); y2 = std::clamp(y2, y1, mapDims.mapy);
 
-	// do not bother with zero-area updates
-	const SRectangle updRect(x1, y1, x2, y2);
-	if (updRect.GetArea() <= 0)
+	// zero-area updates are skipped by push_back
+	recalcAreas.push_back(SRectangle(x1, y1, x2, y2));
+}
+
+void CBasicMapDamage::FlushRecalcAreas()
+{
+	if (recalcAreas.empty())
 		return;
 
-	readMap->UpdateHeightMapSynced(updRect);
-	featureHandler.TerrainChanged(x1, y1, x2, y2);
-	smoothGround.MapChanged(x1, y1, x2, y2);
+	// merge overlapping craters so no square is updated more than once
+	recalcAreas.Process(true);
+
+	for (const SRectangle& r: recalcAreas) {
+		readMap->UpdateHeightMapSynced(r);
+	}
+	for (const SRectangle& r: recalcAreas) {
+		featureHandler.TerrainChanged(r.x1, r.y1, r.x2, r.y2);
+		smoothGround.MapChanged(r.x1, r.y1, r.x2, r.y2);
+	}
 	{
 		SCOPED_TIMER("Sim::BasicMapDamage::Los");
-		losHandler->UpdateHeightMapSynced(updRect);
+
+		for (const SRectangle& r: recalcAreas) {
+			losHandler->UpdateHeightMapSynced(r);
+		}
 	}
 	{
 		SCOPED_TIMER("Sim::BasicMapDamage::Path");
-		pathManager->TerrainChange(x1, y1, x2, y2, TERRAINCHANGE_DAMAGE_RECALCULATION);
+
+		for (const SRectangle& r: recalcAreas) {
+			pathManager->TerrainChange(r.x1, r.y1, r.x2, r.y2, TERRAINCHANGE_DAMAGE_RECALCULATION);
+		}
 	}
+
+	recalcAreas.clear();
 }
 
 
@@ -279,9 +305,11 @@ void CBasicMapDamage::Update()
 		if (e.ttl != 0)
 			continue;
 
-		RecalcArea(e.x1 - 1, e.x2 + 1, e.y1 - 1, e.y2 + 1);
+		QueueRecalcArea(e.x1 - 1, e.x2 + 1, e.y1 - 1, e.y2 + 1);
 	}
 
+	FlushRecalcAreas();
+
 
 	// pop explosions that are no longer being processed
 	while (explUpdateQueueIdx < explosionUpdateQueue.size()) {
@@ -4,6 +4,7 @@
 #define _BASIC_MAP_DAMAGE_H
 
 #include "MapDamage.h"
+#include "System/Misc/RectangleOverlapHandler.h"
 
 #include <vector>
 
@@ -21,6 +22,9 @@ public:
 	bool Disabled() const override { return false; }
 
 private:
+	void QueueRecalcArea(int x1, int x2, int y1, int y2);
+	void FlushRecalcAreas();
+
 	void SetExplosionSquare(float v) {
 		explosionSquaresPool[explSquaresPoolIdx] = v;
 
@@ -61,6 +65,10 @@ private:
 	std::vector<float> explosionSquaresPool;
 	std::vector<Explo> explosionUpdateQueue;
 
+	// areas changed this frame, merged before being passed on to the
+	// heightmap, features, smooth-mesh, LOS and pathing in one batch
+	CRectangleOverlapHandler recalcAreas;
+
 	static constexpr unsigned int CRATER_TABLE_SIZE = 200;
 	static constexpr unsigned int EXPLOSION_LIFETIME = 10;
 
@@ -27,6 +27,7 @@
 #include "System/XSimdOps.hpp"
 #include "Game/GlobalUnsynced.h"
 #include "Sim/Misc/LosHandler.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
 
 static constexpr size_t MAX_UHM_RECTS_PER_FRAME = 128;
 
@@ -516,11 +517,17 @@ void CReadMap::UpdateHeightMapSynced(const SRectangle& hgtMapRect)
 	const SRectangle centerRect = {std::max(mins.x, 0), std::max(mins.y, 0),  std::min(maxs.x, mapDims.mapxm1),  std::min(maxs.y, mapDims.mapym1)};
 	const SRectangle cornerRect = {std::max(mins.x, 0), std::max(mins.y, 0),  std::min(maxs.x, mapDims.mapx  ),  std::min(maxs.y, mapDims.mapy  )};
 
+	// every stage is split over rows on the thread-pool; center heights and
+	// face normals only read the corner heightmap, while the mips and slopes
+	// read what the preceding stage wrote
 	UpdateCenterHeightmap(centerRect, initialize);
-	UpdateMipHeightmaps(centerRect, initialize);
 	UpdateFaceNormals(centerRect, initialize);
+	UpdateMipHeightmaps(centerRect, initialize); // must happen after UpdateCenterHeightmap()!
 	UpdateSlopemap(centerRect, initialize); // must happen after UpdateFaceNormals()!
 
+	// no-op during map initialization, MoveDefs are not yet loaded
+	moveDefHandler.UpdateSpeedModGrids(centerRect);
+
 	// push the unsynced update; initial one without LOS check
 	if (initialize) {
 		unsyncedHeightMapUpdates.push_back(cornerRect);
@@ -596,21 +603,34 @@ void CReadMap::UpdateHeightBounds()
 
 void CReadMap::UpdateCenterHeightmap(const SRectangle& rect, bool initialize) const
 {
+	using BatchType = xsimd::simd_type<float>;
+	constexpr int SIMD_SIZE = xsimd::simd_traits<float>::size;
+
 	const float* heightmapSynced = GetCornerHeightMapSynced();
 
 	for_mt_chunk(rect.z1, rect.z2 + 1, [heightmapSynced, &rect](const int y) {
-		for (int x = rect.x1; x <= rect.x2; x++) {
-			const int idxTL = (y + 0) * mapDims.mapxp1 + x + 0;
-			const int idxTR = (y + 0) * mapDims.mapxp1 + x + 1;
-			const int idxBL = (y + 1) * mapDims.mapxp1 + x + 0;
-			const int idxBR = (y + 1) * mapDims.mapxp1 + x + 1;
+		const float* rowT = heightmapSynced + (y + 0) * mapDims.mapxp1;
+		const float* rowB = heightmapSynced + (y + 1) * mapDims.mapxp1;
+		      float* rowC = centerHeightMap.data() + y * mapDims.mapx;
+
+		int x = rect.x1;
+
+		// same operation order as the scalar tail, results are bit-identical
+		for (; (x + SIMD_SIZE - 1) <= rect.x2; x += SIMD_SIZE) {
+			const BatchType hTL = xsimd::load_unaligned<float>(rowT + x + 0);
+			const BatchType hTR = xsimd::load_unaligned<float>(rowT + x + 1);
+			const BatchType hBL = xsimd::load_unaligned<float>(rowB + x + 0);
+			const BatchType hBR = xsimd::load_unaligned<float>(rowB + x + 1);
 
+			xsimd::store_unaligned(rowC + x, (((hTL + hTR) + hBL) + hBR) * BatchType(0.25f));
+		}
+		for (; x <= rect.x2; x++) {
 			const float height =
-				heightmapSynced[idxTL] +
-				heightmapSynced[idxTR] +
-				heightmapSynced[idxBL] +
-				heightmapSynced[idxBR];
-			centerHeightMap[y * mapDims.mapx + x] = height * 0.25f;
+				rowT[x + 0] +
+				rowT[x + 1] +
+				rowB[x + 0] +
+				rowB[x + 1];
+			rowC[x] = height * 0.25f;
 		}
 	}, -256);
 }
@@ -626,10 +646,13 @@ void CReadMap::UpdateMipHeightmaps(const SRectangle& rect, bool initialize)
 		const int sy = (rect.z1 >> i) & (~1);
 		const int ey = (rect.z2 >> i);
 
-		float* topMipMap = mipPointerHeightMaps[i    ];
-		float* subMipMap = mipPointerHeightMaps[i + 1];
+		const float* topMipMap = mipPointerHeightMaps[i    ];
+		      float* subMipMap = mipPointerHeightMaps[i + 1];
+
+		// each level only reads the one above it, rows of a level are independent
+		for_mt_chunk(sy >> 1, (ey + 1) >> 1, [=](const int yh) {
+			const int y = yh << 1;
 
-		for (int y = sy; y < ey; y += 2) {
 			for (int x = sx; x < ex; x += 2) {
 				const float height =
 					topMipMap[(x    ) + (y    ) * hmapx] +
@@ -638,7 +661,7 @@ void CReadMap::UpdateMipHeightmaps(const SRectangle& rect, bool initialize)
 					topMipMap[(x + 1) + (y + 1) * hmapx];
 				subMipMap[(x / 2) + (y / 2) * hmapx / 2] = height * 0.25f;
 			}
-		}
+		}, -64);
 	}
 }
 
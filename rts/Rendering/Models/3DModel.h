@@ -264,6 +264,7 @@ protected:
 	bool hasBakedMat;
 public:
 	friend class CAssParser;
+	friend class CModelsCache;
 };
 
 
@@ -136,7 +136,7 @@ public:
 
 	void Load(S3DModel& model, const std::string& name) override;
 
-	S3DOPiece* AllocPiece();
+	S3DOPiece* AllocPiece() override;
 	S3DOPiece* LoadPiece(S3DModel* model, S3DOPiece* parent, const std::vector<uint8_t>& buf, int pos);
 
 private:
@@ -208,6 +208,28 @@ void CAssParser::Kill()
 	numPoolPieces = 0;
 }
 
+std::string CAssParser::GetMetaFileName(const std::string& modelFilePath)
+{
+	const std::string& metaFileName = modelFilePath + ".lua";
+
+	if (CFileHandler::FileExists(metaFileName, SPRING_VFS_ZIP))
+		return metaFileName;
+
+	// try again without the model file extension
+	return (FileSystem::GetDirectory(modelFilePath) + FileSystem::GetBasename(modelFilePath) + ".lua");
+}
+
+void CAssParser::PreloadTextures(S3DModel& model, const std::string& modelFilePath)
+{
+	// only the texture flags are needed from the meta-file on a cache hit
+	LuaParser metaFileParser(GetMetaFileName(modelFilePath), SPRING_VFS_ZIP, SPRING_VFS_ZIP);
+	metaFileParser.Execute();
+
+	const LuaTable& modelTable = metaFileParser.GetRoot();
+
+	textureHandlerS3O.PreloadTexture(&model, modelTable.GetBool("fliptextures", true), modelTable.GetBool("invertteamcolor", true));
+}
+
 void CAssParser::Load(S3DModel& model, const std::string& modelFilePath)
 {
 	LOG_SL(LOG_SECTION_MODEL, L_INFO, "Loading model: %s", modelFilePath.c_str());
@@ -219,11 +241,8 @@ void CAssParser::Load(S3DModel& model, const std::string& modelFilePath)
 
 	std::vector<unsigned char> fileBuf;
 	// load the lua metafile containing properties unique to Spring models (must return a table)
-	std::string metaFileName = modelFilePath + ".lua";
+	const std::string& metaFileName = GetMetaFileName(modelFilePath);
 
-	// try again without the model file extension
-	if (!CFileHandler::FileExists(metaFileName, SPRING_VFS_ZIP))
-		metaFileName = modelPath + modelName + ".lua";
 	if (!CFileHandler::FileExists(metaFileName, SPRING_VFS_ZIP))
 		LOG_SL(LOG_SECTION_MODEL, L_INFO, "No meta-file '%s'. Using defaults.", metaFileName.c_str());
 
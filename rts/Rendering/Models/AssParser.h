@@ -60,8 +60,12 @@ public:
 	void Kill() override;
 
 	void Load(S3DModel& model, const std::string& name) override;
+
+	SAssPiece* AllocPiece() override;
+	void PreloadTextures(S3DModel& model, const std::string& name) override;
 private:
 	static void PreProcessFileBuffer(std::vector<unsigned char>& fileBuffer);
+	static std::string GetMetaFileName(const std::string& modelFilePath);
 
 	static void UpdatePiecesMinMaxExtents(S3DModel* model);
 	static void SetPieceName(
@@ -121,7 +125,6 @@ private:
 		const std::vector<MeshData>& meshes
 	);
 
-	SAssPiece* AllocPiece();
 	SAssPiece* LoadPiece(
 		S3DModel* model,
 		const aiNode* pieceNode,
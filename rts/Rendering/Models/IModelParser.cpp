@@ -8,6 +8,7 @@
 #include "S3OParser.h"
 #include "AssParser.h"
 #include "3DModelVAO.h"
+#include "ModelsCache.h"
 #include "ModelsLock.h"
 #include "Game/GlobalUnsynced.h"
 #include "Rendering/Textures/S3OTextureHandler.h"
@@ -139,6 +140,8 @@ void CModelLoader::Init()
 	RegisterModelFormats(parsers);
 	InitParsers();
 
+	CModelsCache::Init();
+
 	models.clear();
 	models.resize(MAX_MODEL_OBJECTS);
 
@@ -403,11 +406,16 @@ void CModelLoader::ParseModel(S3DModel& model, const std::string& name, const st
 		return;
 	}
 
+	if (CModelsCache::Load(model, path, parser))
+		return;
+
 	try {
 		parser->Load(model, path);
 		if (model.numPieces > 254)
 			throw content_error("A model has too many pieces (>254)" + path);
 
+		CModelsCache::Save(model, path);
+
 	} catch (const content_error& ex) {
 		{
 			auto lock = CModelsLock::GetScopedLock();
@@ -19,6 +19,10 @@ public:
 	virtual void Init() {}
 	virtual void Kill() {}
 	virtual void Load(S3DModel& model, const std::string& name) = 0;
+
+	// used by CModelsCache to rebuild a model without going through Load
+	virtual S3DModelPiece* AllocPiece() = 0;
+	virtual void PreloadTextures(S3DModel& model, const std::string& name) {}
 };
 
 
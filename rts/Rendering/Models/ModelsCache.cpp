@@ -0,0 +1,407 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "ModelsCache.h"
+#include "3DModel.h"
+#include "IModelParser.h"
+#include "S3OParser.h"
+#include "AssParser.h"
+#include "Sim/Misc/CollisionVolume.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+#include "System/StringUtil.h"
+#include "System/Threading/ThreadPool.h"
+
+#include <tracy/Tracy.hpp>
+
+CONFIG(bool, UseModelCache).defaultValue(true).description("Whether parsed S3O and Assimp models are cached in binary form in the cache directory.");
+
+
+static constexpr uint32_t CACHE_MAGIC   = 0x43444D53; // "SMDC"
+static constexpr uint32_t CACHE_VERSION = 2;
+
+static_assert(std::is_trivially_copyable<SVertexData>::value, "");
+
+
+namespace {
+	struct CacheWriter {
+		template<typename T> void Write(const T& v) {
+			static_assert(std::is_trivially_copyable<T>::value, "");
+			WriteRaw(&v, sizeof(T));
+		}
+		void Write(const std::string& s) {
+			Write(static_cast<uint32_t>(s.size()));
+			WriteRaw(s.data(), s.size());
+		}
+		template<typename T> void Write(const std::vector<T>& v) {
+			Write(static_cast<uint32_t>(v.size()));
+			WriteRaw(v.data(), v.size() * sizeof(T));
+		}
+
+		void WriteRaw(const void* p, size_t n) {
+			const uint8_t* b = reinterpret_cast<const uint8_t*>(p);
+			buffer.insert(buffer.end(), b, b + n);
+		}
+
+		std::vector<uint8_t> buffer;
+	};
+
+	struct CacheReader {
+		template<typename T> bool Read(T& v) {
+			static_assert(std::is_trivially_copyable<T>::value, "");
+			return ReadRaw(&v, sizeof(T));
+		}
+		bool Read(std::string& s) {
+			uint32_t n = 0;
+			if (!Read(n) || (pos + n) > buffer.size())
+				return false;
+			s.assign(reinterpret_cast<const char*>(&buffer[pos]), n);
+			pos += n;
+			return true;
+		}
+		template<typename T> bool Read(std::vector<T>& v) {
+			uint32_t n = 0;
+			if (!Read(n) || (pos + n * sizeof(T)) > buffer.size())
+				return false;
+			v.resize(n);
+			return ReadRaw(v.data(), n * sizeof(T));
+		}
+
+		bool ReadRaw(void* p, size_t n) {
+			if ((pos + n) > buffer.size())
+				return false;
+			std::memcpy(p, &buffer[pos], n);
+			pos += n;
+			return true;
+		}
+
+		std::vector<uint8_t> buffer;
+		size_t pos = 0;
+	};
+};
+
+
+// piece members not shared by all formats
+static int32_t GetPieceExtra(const S3DModel& model, const S3DModelPiece* piece)
+{
+	switch (model.type) {
+		case MODELTYPE_S3O: { return (static_cast<const SS3OPiece*>(piece)->primType); } break;
+		case MODELTYPE_ASS: { return (static_cast<const SAssPiece*>(piece)->numTexCoorChannels); } break;
+		default: {} break;
+	}
+
+	return 0;
+}
+
+static void SetPieceExtra(const S3DModel& model, S3DModelPiece* piece, int32_t extra)
+{
+	switch (model.type) {
+		case MODELTYPE_S3O: { static_cast<SS3OPiece*>(piece)->primType = extra; } break;
+		case MODELTYPE_ASS: { static_cast<SAssPiece*>(piece)->numTexCoorChannels = extra; } break;
+		default: {} break;
+	}
+}
+
+
+
+void CModelsCache::Init()
+{
+	enabled = configHandler->GetBool("UseModelCache");
+}
+
+bool CModelsCache::IsCacheable(const S3DModel& model)
+{
+	// 3DO pieces reference atlas textures from their primitives, and are cheap to parse anyway
+	return (enabled && (model.type == MODELTYPE_S3O || model.type == MODELTYPE_ASS));
+}
+
+
+std::string CModelsCache::GetCacheFileName(const std::string& path)
+{
+	std::string name = path;
+
+	for (char& c: name) {
+		if (c == '/' || c == '\\' || c == ':')
+			c = '_';
+	}
+
+	return (FileSystem::GetCacheDir() + "/models/" + name + ".smc");
+}
+
+std::string CModelsCache::GetCacheKey(const std::string& path, int modelType, const std::string& tex1, const std::string& tex2)
+{
+	// every file able to influence the parsed result; the Assimp parser also
+	// reads a meta-file and resolves texture names against the VFS
+	std::vector<std::string> inputFiles = {
+		path,
+		path + ".lua",
+		FileSystem::GetDirectory(path) + FileSystem::GetBasename(path) + ".lua",
+	};
+
+	if (modelType == MODELTYPE_ASS) {
+		inputFiles.push_back(tex1);
+		inputFiles.push_back(tex2);
+	}
+
+	std::vector<std::string> archiveFiles;
+	std::vector<uint8_t> keyData;
+
+	for (const std::string& inputFile: inputFiles) {
+		std::string archiveName;
+
+		if (!inputFile.empty() && CFileHandler::FileExists(inputFile, SPRING_VFS_ZIP_FIRST))
+			archiveName = CFileHandler::GetArchiveContainingFile(inputFile, SPRING_VFS_ZIP);
+
+		// which inputs exist (and where) matters as much as their content
+		keyData.insert(keyData.end(), inputFile.begin(), inputFile.end());
+		keyData.push_back(0);
+		keyData.insert(keyData.end(), archiveName.begin(), archiveName.end());
+		keyData.push_back(0);
+
+		if (archiveName.empty())
+			continue;
+
+		const std::string& archiveFile = archiveScanner->ArchiveFromName(archiveName);
+		archiveFiles.push_back(archiveScanner->GetArchivePath(archiveFile) + archiveFile);
+	}
+
+	// each archive contributes its checksum once, independent of input order
+	std::sort(archiveFiles.begin(), archiveFiles.end());
+	archiveFiles.erase(std::unique(archiveFiles.begin(), archiveFiles.end()), archiveFiles.end());
+
+	for (const std::string& archiveFile: archiveFiles) {
+		const sha512::raw_digest& checksum = archiveScanner->GetArchiveSingleChecksumBytes(archiveFile);
+		keyData.insert(keyData.end(), checksum.begin(), checksum.end());
+	}
+
+	sha512::raw_digest key;
+	sha512::calc_digest(keyData, key);
+
+	return (path + std::string(reinterpret_cast<const char*>(key.data()), key.size()));
+}
+
+
+bool CModelsCache::Load(S3DModel& model, const std::string& path, IModelParser* parser)
+{
+	if (!enabled)
+		return false;
+
+	ZoneScoped;
+
+	const std::string& cacheFileName = GetCacheFileName(path);
+	const std::string& absFileName = dataDirsAccess.LocateFile(cacheFileName);
+
+	CacheReader reader;
+
+	{
+		FILE* file = fopen(absFileName.c_str(), "rb");
+
+		if (file == nullptr)
+			return false;
+
+		fseek(file, 0, SEEK_END);
+		reader.buffer.resize(ftell(file));
+		fseek(file, 0, SEEK_SET);
+
+		const bool readOk = (fread(reader.buffer.data(), 1, reader.buffer.size(), file) == reader.buffer.size());
+
+		fclose(file);
+
+		if (!readOk)
+			return false;
+	}
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	int32_t modelType = MODELTYPE_CNT;
+	int32_t numPieces = 0;
+	std::string key;
+	std::string texs[2];
+
+	if (!reader.Read(magic) || magic != CACHE_MAGIC)
+		return false;
+	if (!reader.Read(version) || version != CACHE_VERSION)
+		return false;
+	if (!reader.Read(modelType) || (modelType != MODELTYPE_S3O && modelType != MODELTYPE_ASS))
+		return false;
+
+	// the key covers the texture names, so they precede it
+	if (!reader.Read(texs[0]) || !reader.Read(texs[1]))
+		return false;
+	if (!reader.Read(key) || key != GetCacheKey(path, modelType, texs[0], texs[1]))
+		return false;
+	if (!reader.Read(numPieces) || numPieces <= 0 || numPieces > 254)
+		return false;
+
+	struct PieceData {
+		int32_t parentIndex = -1;
+		int32_t extra = 0;
+		uint8_t hasBakedMat = 0;
+
+		std::string name;
+
+		float3 offset;
+		float3 goffset;
+		float3 scales;
+		float3 mins;
+		float3 maxs;
+
+		CMatrix44f bakedMatrix;
+
+		std::vector<SVertexData> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	std::vector<PieceData> piecesData(numPieces);
+
+	bool ok = true;
+
+	ok &= reader.Read(model.name);
+	ok &= reader.Read(model.radius);
+	ok &= reader.Read(model.height);
+	ok &= reader.Read(model.mins);
+	ok &= reader.Read(model.maxs);
+	ok &= reader.Read(model.relMidPos);
+
+	// everything is read and validated before any pieces are taken from the
+	// parser pool, which can not hand them back
+	for (int32_t i = 0; ok && i < numPieces; i++) {
+		PieceData& pd = piecesData[i];
+
+		ok &= reader.Read(pd.parentIndex);
+		ok &= reader.Read(pd.name);
+		ok &= reader.Read(pd.offset);
+		ok &= reader.Read(pd.goffset);
+		ok &= reader.Read(pd.scales);
+		ok &= reader.Read(pd.mins);
+		ok &= reader.Read(pd.maxs);
+		ok &= reader.ReadRaw(&pd.bakedMatrix.m[0], sizeof(pd.bakedMatrix.m));
+		ok &= reader.Read(pd.hasBakedMat);
+		ok &= reader.Read(pd.extra);
+		ok &= reader.Read(pd.vertices);
+		ok &= reader.Read(pd.indices);
+
+		// pieces are stored in flattened (depth-first) order, parents always come first
+		ok &= (pd.parentIndex < i && (pd.parentIndex >= 0) == (i > 0));
+	}
+
+	if (!ok) {
+		LOG_L(L_WARNING, "[ModelsCache::%s] corrupted cache-file \"%s\" for model \"%s\"", __func__, cacheFileName.c_str(), path.c_str());
+		model.name.clear();
+		return false;
+	}
+
+	model.type = static_cast<ModelType>(modelType);
+	model.numPieces = numPieces;
+	model.texs[0] = std::move(texs[0]);
+	model.texs[1] = std::move(texs[1]);
+
+	std::vector<S3DModelPiece*> pieces;
+	pieces.reserve(numPieces);
+
+	for (PieceData& pd: piecesData) {
+		S3DModelPiece* piece = parser->AllocPiece();
+
+		piece->name = std::move(pd.name);
+		piece->offset = pd.offset;
+		piece->goffset = pd.goffset;
+		piece->scales = pd.scales;
+		piece->mins = pd.mins;
+		piece->maxs = pd.maxs;
+		piece->bakedMatrix = pd.bakedMatrix;
+		piece->hasBakedMat = (pd.hasBakedMat != 0);
+		piece->vertices = std::move(pd.vertices);
+		piece->indices = std::move(pd.indices);
+
+		piece->SetParentModel(&model);
+		// same volume both parsers derive from the piece extents
+		piece->SetCollisionVolume(CollisionVolume('b', 'z', piece->maxs - piece->mins, (piece->maxs + piece->mins) * 0.5f));
+		SetPieceExtra(model, piece, pd.extra);
+
+		if (pd.parentIndex >= 0) {
+			piece->parent = pieces[pd.parentIndex];
+			piece->parent->children.push_back(piece);
+		}
+
+		pieces.push_back(piece);
+	}
+
+	model.FlattenPieceTree(pieces[0]);
+
+	parser->PreloadTextures(model, path);
+	return true;
+}
+
+void CModelsCache::Save(const S3DModel& model, const std::string& path)
+{
+	if (!IsCacheable(model))
+		return;
+
+	ZoneScoped;
+
+	CacheWriter writer;
+
+	writer.Write(CACHE_MAGIC);
+	writer.Write(CACHE_VERSION);
+	writer.Write(static_cast<int32_t>(model.type));
+	writer.Write(model.texs[0]);
+	writer.Write(model.texs[1]);
+	writer.Write(GetCacheKey(path, model.type, model.texs[0], model.texs[1]));
+	writer.Write(static_cast<int32_t>(model.numPieces));
+
+	writer.Write(model.name);
+	writer.Write(model.radius);
+	writer.Write(model.height);
+	writer.Write(model.mins);
+	writer.Write(model.maxs);
+	writer.Write(model.relMidPos);
+
+	for (size_t i = 0; i < model.pieceObjects.size(); i++) {
+		const S3DModelPiece* piece = model.pieceObjects[i];
+		const auto parentIter = std::find(model.pieceObjects.begin(), model.pieceObjects.end(), piece->parent);
+
+		writer.Write(static_cast<int32_t>((piece->parent == nullptr)? -1: (parentIter - model.pieceObjects.begin())));
+		writer.Write(piece->name);
+		writer.Write(piece->offset);
+		writer.Write(piece->goffset);
+		writer.Write(piece->scales);
+		writer.Write(piece->mins);
+		writer.Write(piece->maxs);
+		writer.WriteRaw(&piece->bakedMatrix.m[0], sizeof(piece->bakedMatrix.m));
+		writer.Write(static_cast<uint8_t>(piece->hasBakedMat));
+		writer.Write(GetPieceExtra(model, piece));
+		writer.Write(piece->vertices);
+		writer.Write(piece->indices);
+	}
+
+	if (!FileSystem::CreateDirectory(FileSystem::GetCacheDir() + "/models/"))
+		return;
+
+	// write to a temporary file first so concurrent readers never see partial data
+	const std::string& absFileName = dataDirsAccess.LocateFile(GetCacheFileName(path), FileQueryFlags::WRITE);
+	const std::string& tmpFileName = absFileName + ".tmp" + IntToString(ThreadPool::GetThreadNum());
+
+	FILE* file = fopen(tmpFileName.c_str(), "wb");
+
+	if (file == nullptr)
+		return;
+
+	const bool writeOk = (fwrite(writer.buffer.data(), 1, writer.buffer.size(), file) == writer.buffer.size());
+
+	fclose(file);
+
+	if (!writeOk || std::rename(tmpFileName.c_str(), absFileName.c_str()) != 0) {
+		LOG_L(L_WARNING, "[ModelsCache::%s] failed to write cache-file for model \"%s\"", __func__, path.c_str());
+		std::remove(tmpFileName.c_str());
+	}
+}
@@ -0,0 +1,41 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef MODELS_CACHE_H
+#define MODELS_CACHE_H
+
+#include <string>
+
+struct S3DModel;
+class IModelParser;
+
+/**
+ * Binary on-disk cache of parsed S3O and Assimp models, stored in the
+ * (engine-versioned) cache directory. Entries hold the parser output
+ * (piece hierarchy, vertices and indices) and are keyed by file name
+ * and a hash over the checksums of the archives providing the model,
+ * its meta file and (Assimp) textures, so changed content is never
+ * served stale.
+ *
+ * Geometry post-processing and VAO registration still run as usual
+ * after a cache hit; only the format parsing is skipped.
+ */
+class CModelsCache
+{
+public:
+	static void Init();
+
+	static bool IsCacheable(const S3DModel& model);
+
+	// both are safe to call concurrently from preload threads
+	static bool Load(S3DModel& model, const std::string& path, IModelParser* parser);
+	static void Save(const S3DModel& model, const std::string& path);
+
+private:
+	static std::string GetCacheFileName(const std::string& path);
+	static std::string GetCacheKey(const std::string& path, int modelType, const std::string& tex1, const std::string& tex2);
+
+private:
+	static inline bool enabled = false;
+};
+
+#endif // MODELS_CACHE_H
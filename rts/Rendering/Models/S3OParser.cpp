@@ -72,6 +72,11 @@ void CS3OParser::Load(S3DModel& model, const std::string& name)
 }
 
 
+void CS3OParser::PreloadTextures(S3DModel& model, const std::string& name)
+{
+	textureHandlerS3O.PreloadTexture(&model);
+}
+
 SS3OPiece* CS3OParser::AllocPiece()
 {
 	std::lock_guard<spring::mutex> lock(poolMutex);
@@ -61,8 +61,10 @@ public:
 
 	void Load(S3DModel& model, const std::string& name) override;
 
+	SS3OPiece* AllocPiece() override;
+	void PreloadTextures(S3DModel& model, const std::string& name) override;
+
 private:
-	SS3OPiece* AllocPiece();
 	SS3OPiece* LoadPiece(S3DModel*, SS3OPiece*, std::vector<uint8_t>& buf, int offset);
 
 private:
@@ -1199,11 +1199,15 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 	if (!file.IsBuffered()) {
 		buffer.resize(file.FileSize(), 0);
 		file.Read(buffer.data(), buffer.size());
-	} else {
+	} else if (!file.IsMapped()) {
 		// steal if file was loaded from VFS
 		buffer = std::move(file.GetBuffer());
 	}
 
+	// mapped files are decoded in-place, the view stays valid while <file> is open
+	const uint8_t* fileData = file.IsMapped()? file.GetBufferData(): buffer.data();
+	const size_t fileSize = file.IsMapped()? file.FileSize(): buffer.size();
+
 
 	{
 		std::lock_guard<spring::mutex> lck(ITexMemPool::texMemPool->GetMutex());
@@ -1222,7 +1226,7 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 			// do not signal floating point exceptions in devil library
 			ScopedDisableFpuExceptions fe;
 
-			isLoaded = !!ilLoadL(IL_TYPE_UNKNOWN, buffer.data(), static_cast<ILuint>(buffer.size()));
+			isLoaded = !!ilLoadL(IL_TYPE_UNKNOWN, const_cast<uint8_t*>(fileData), static_cast<ILuint>(fileSize));
 			currFormat = ilGetInteger(IL_IMAGE_FORMAT);
 			isValid = (isLoaded && IsValidImageFormat(currFormat));
 			dataType = ilGetInteger(IL_IMAGE_TYPE);
@@ -1347,11 +1351,14 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 	if (!file.IsBuffered()) {
 		buffer.resize(file.FileSize() + 1, 0);
 		file.Read(buffer.data(), file.FileSize());
-	} else {
+	} else if (!file.IsMapped()) {
 		// steal if file was loaded from VFS
 		buffer = std::move(file.GetBuffer());
 	}
 
+	const uint8_t* fileData = file.IsMapped()? file.GetBufferData(): buffer.data();
+	const size_t fileSize = file.IsMapped()? file.FileSize(): buffer.size();
+
 	{
 		std::lock_guard<spring::mutex> lck(ITexMemPool::texMemPool->GetMutex());
 
@@ -1362,7 +1369,7 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 		ilGenImages(1, &imageID);
 		ilBindImage(imageID);
 
-		const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, buffer.data(), buffer.size());
+		const bool success = !!ilLoadL(IL_TYPE_UNKNOWN, const_cast<uint8_t*>(fileData), fileSize);
 		ilDisable(IL_ORIGIN_SET);
 
 		if (!success)
@@ -46,8 +46,9 @@ CR_REG_METADATA(CFeature, (
 	CR_MEMBER(resources),
 
 	CR_MEMBER(lastReclaimFrame),
-	CR_MEMBER(fireTime),
-	CR_MEMBER(smokeTime),
+	CR_MEMBER(fireEndFrame),
+	CR_MEMBER(smokeEndFrame),
+	CR_MEMBER(wakeupFrame),
 
 	CR_MEMBER(def),
 	CR_MEMBER(udef),
@@ -154,7 +155,7 @@ void CFeature::Initialize(const FeatureLoadParams& params)
 
 	heading = params.heading;
 	buildFacing = params.facing;
-	smokeTime = params.smokeTime;
+	smokeEndFrame = (params.smokeTime > 0)? gs->frameNum + params.smokeTime: 0;
 
 	mass = def->mass;
 	health = def->health;
@@ -229,6 +230,9 @@ void CFeature::Initialize(const FeatureLoadParams& params)
 	featureHandler.AddFeature(this);
 	quadField.AddFeature(this);
 
+	if (smokeEndFrame != 0 || def->geoThermal)
+		featureHandler.ScheduleFeatureWakeup(this, gs->frameNum + 1);
+
 	ChangeTeam(team);
 	UpdateCollidableStateBit(CSolidObject::CSTATE_BIT_SOLIDOBJECTS, def->collidable);
 	Block();
@@ -436,9 +440,14 @@ void CFeature::DoDamage(
 
 void CFeature::DependentDied(CObject *o)
 {
-	if (o == solidOnTop)
+	if (o == solidOnTop) {
 		solidOnTop = nullptr;
 
+		// an uncovered vent smokes every frame again
+		if (def->geoThermal && !deleteMe)
+			featureHandler.ScheduleFeatureWakeup(this, gs->frameNum + 1);
+	}
+
 	CSolidObject::DependentDied(o);
 }
 
@@ -597,14 +606,26 @@ bool CFeature::UpdatePosition()
 
 bool CFeature::Update()
 {
-	bool continueUpdating = UpdatePosition();
+	// smoke, fire and geothermal vents are driven by UpdateTimedEvents
+	// return true so long as we need to stay in the FH update-queue
+	return (UpdatePosition());
+}
+
 
-	continueUpdating |= (smokeTime != 0);
-	continueUpdating |= (fireTime != 0);
-	continueUpdating |= (def->geoThermal);
+int CFeature::UpdateTimedEvents()
+{
+	const int frameNum = gs->frameNum;
 
-	if (smokeTime != 0) {
-		if (!((gs->frameNum + id) & 3) && projectileHandler.GetParticleSaturation() < 0.7f) {
+	// removed at the end of this frame
+	if (deleteMe)
+		return -1;
+
+	int nextFrame = std::numeric_limits<int>::max();
+
+	if (frameNum < smokeEndFrame) {
+		const int smokeTime = smokeEndFrame - frameNum;
+
+		if (!((frameNum + id) & 3) && projectileHandler.GetParticleSaturation() < 0.7f) {
 			if (pos.y < 0.0f) {
 				projMemPool.alloc<CBubbleProjectile>(nullptr, midPos + guRNG.NextVector() * radius * 0.3f,
 					guRNG.NextVector() * 0.3f + UpVector, smokeTime / 6 + 20, 6, 0.4f, 0.5f);
@@ -613,34 +634,49 @@ bool CFeature::Update()
 					guRNG.NextVector() * 0.3f + UpVector, smokeTime / 6 + 20, 6, 0.4f, 0.5f);
 			}
 		}
+
+		// smoke is only emitted every fourth frame
+		const int smokeFrame = frameNum + 4 - ((frameNum + id) & 3);
+
+		if (smokeFrame < smokeEndFrame)
+			nextFrame = std::min(nextFrame, smokeFrame);
+	}
+
+	if (fireEndFrame != 0) {
+		if (frameNum >= fireEndFrame) {
+			featureHandler.DeleteFeature(this);
+			return -1;
+		}
+
+		nextFrame = std::min(nextFrame, fireEndFrame);
 	}
-	if (fireTime == 1)
-		featureHandler.DeleteFeature(this);
 
-	if (def->geoThermal)
-		EmitGeoSmoke();
+	if (def->geoThermal) {
+		// smoke rises every frame while the vent is uncovered, otherwise only
+		// the every-fifth-frame search for the object on top has to be done
+		const int geoFrame = frameNum + 5 - ((frameNum + id % 5) % 5);
 
-	smokeTime = std::max(smokeTime - 1, 0);
-	fireTime = std::max(fireTime - 1, 0);
+		nextFrame = std::min(nextFrame, EmitGeoSmoke()? frameNum + 1: geoFrame);
+	}
 
-	// return true so long as we need to stay in the FH update-queue
-	return continueUpdating;
+	// sim-frame at which we want to be woken up again, if any
+	return ((nextFrame != std::numeric_limits<int>::max())? nextFrame: -1);
 }
 
 
 void CFeature::StartFire()
 {
-	if (fireTime != 0 || !def->burnable)
+	if (fireEndFrame != 0 || !def->burnable)
 		return;
 
 	// burn for a few seconds
-	fireTime = 200 + gsRNG.NextInt(GAME_SPEED);
+	fireEndFrame = gs->frameNum + 200 + gsRNG.NextInt(GAME_SPEED);
 
-	featureHandler.SetFeatureUpdateable(this);
+	featureHandler.ScheduleFeatureWakeup(this, fireEndFrame);
 }
 
 
-void CFeature::EmitGeoSmoke()
+bool CFeature::EmitGeoSmoke()
 {
 	if ((gs->frameNum + id % 5) % 5 == 0) {
 		// Find the unit closest to the geothermal
@@ -674,15 +710,16 @@ void CFeature::EmitGeoSmoke()
 	const CUnit* u = dynamic_cast<CUnit*>(solidOnTop);
 
 	if (u != nullptr && u->unitDef->needGeo)
-		return;
+		return false;
 
 	if (projectileHandler.GetParticleSaturation() >= (!(gs->frameNum & 3) ? 1.0f : 0.7f))
-		return;
+		return true;
 
 	const float3 pPos = guRNG.NextVector() * 10.0f + (pos - UpVector * 10.0f);
 	const float3 pSpeed = (guRNG.NextVector() * 0.5f) + (UpVector * 2.0f);
 
 	projMemPool.alloc<CGeoThermSmokeProjectile>(pPos, pSpeed, 50 + guRNG.NextInt(7), this);
+	return true;
 }
 
 
@@ -79,6 +79,7 @@ public:
 
 	bool Update();
 	bool UpdatePosition();
+	int UpdateTimedEvents();
 	bool UpdateVelocity(const float3& dragAccel, const float3& gravAccel, const float3& movMask, const float3& velMask);
 
 	void SetTransform(const CMatrix44f& m, bool synced) { transMatrix[synced] = m; }
@@ -87,7 +88,8 @@ public:
 	void UpdateQuadFieldPosition(const float3& moveVec);
 
 	void StartFire();
-	void EmitGeoSmoke();
+	/// returns false while a geothermal unit covers the vent
+	bool EmitGeoSmoke();
 
 	void DependentDied(CObject *o);
 	void ChangeTeam(int newTeam);
@@ -124,8 +126,11 @@ public:
 	float reclaimLeft = 1.0f;
 
 	int lastReclaimFrame = 0;
-	int fireTime = 0;
-	int smokeTime = 0;
+	// absolute sim-frames at which burning and smoking stop (0 if never started)
+	int fireEndFrame = 0;
+	int smokeEndFrame = 0;
+	// frame of the pending FH wakeup for timed events, -1 if none
+	int wakeupFrame = -1;
 
 	SResourcePack defResources = {0.0f, 1.0f};
 	SResourcePack resources = {0.0f, 1.0f};
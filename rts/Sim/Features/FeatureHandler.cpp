@@ -21,7 +21,9 @@ CR_REG_METADATA(CFeatureHandler, (
 	CR_MEMBER(deletedFeatureIDs),
 	CR_MEMBER(activeFeatureIDs),
 	CR_MEMBER(features),
-	CR_MEMBER(updateFeatures)
+	CR_MEMBER(updateFeatures),
+	CR_MEMBER(featureWakeups),
+	CR_IGNORED(dueFeatureWakeups)
 ))
 
 /******************************************************************************/
@@ -52,6 +54,12 @@ void CFeatureHandler::Kill() {
 	deletedFeatureIDs.clear();
 	features.clear();
 	updateFeatures.clear();
+
+	for (auto& slot: featureWakeups) {
+		slot.clear();
+	}
+
+	dueFeatureWakeups.clear();
 }
 
 
@@ -184,6 +192,10 @@ void CFeatureHandler::Update()
 
 		deletedFeatureIDs.erase(iter, deletedFeatureIDs.end());
 	}
+
+	// before the queue so features deleted by their fire are freed this frame
+	UpdateFeatureWakeups();
+
 	{
 		const auto& pred = [this](CFeature* feature) { return (this->UpdateFeature(feature)); };
 		const auto& iter = std::remove_if(updateFeatures.begin(), updateFeatures.end(), pred);
@@ -252,6 +264,57 @@ void CFeatureHandler::SetFeatureUpdateable(CFeature* feature)
 }
 
 
+void CFeatureHandler::ScheduleFeatureWakeup(CFeature* feature, int frameNum)
+{
+	assert(frameNum > gs->frameNum);
+
+	// an earlier wakeup will reschedule the feature itself
+	if (feature->wakeupFrame >= 0 && feature->wakeupFrame <= frameNum)
+		return;
+
+	feature->wakeupFrame = frameNum;
+	featureWakeups[frameNum % NUM_WAKEUP_SLOTS].emplace_back(feature->id, frameNum);
+}
+
+
+void CFeatureHandler::UpdateFeatureWakeups()
+{
+	const int frameNum = gs->frameNum;
+
+	auto& slot = featureWakeups[frameNum % NUM_WAKEUP_SLOTS];
+
+	// features can schedule new wakeups into this slot while being woken
+	dueFeatureWakeups.clear();
+	dueFeatureWakeups.swap(slot);
+
+	for (const auto& wakeup: dueFeatureWakeups) {
+		const int featureID = wakeup.first;
+		const int wakeFrame = wakeup.second;
+
+		// more than one revolution ahead, keep it around
+		if (wakeFrame > frameNum) {
+			slot.push_back(wakeup);
+			continue;
+		}
+
+		CFeature* feature = features[featureID];
+
+		// stale entry: feature was deleted or has been rescheduled
+		if (feature == nullptr || feature->wakeupFrame != wakeFrame)
+			continue;
+
+		feature->wakeupFrame = -1;
+
+		const int nextFrame = feature->UpdateTimedEvents();
+
+		if (nextFrame < 0)
+			continue;
+
+		ScheduleFeatureWakeup(feature, std::max(nextFrame, frameNum + 1));
+	}
+}
+
+
 void CFeatureHandler::TerrainChanged(int x1, int y1, int x2, int y2)
 {
 	const float3 mins(x1 * SQUARE_SIZE, 0, y1 * SQUARE_SIZE);
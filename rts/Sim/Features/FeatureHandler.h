@@ -3,6 +3,7 @@
 #ifndef _FEATURE_HANDLER_H
 #define _FEATURE_HANDLER_H
 
+#include <array>
 #include <vector>
 
 #include "System/float3.h"
@@ -63,6 +64,7 @@ public:
 	void LoadFeaturesFromMap();
 
 	void SetFeatureUpdateable(CFeature* feature);
+	void ScheduleFeatureWakeup(CFeature* feature, int frameNum);
 	void TerrainChanged(int x1, int y1, int x2, int y2);
 
 	const spring::unordered_set<int>& GetActiveFeatureIDs() const { return activeFeatureIDs; }
@@ -80,6 +82,7 @@ private:
 	}
 
 	void InsertActiveFeature(CFeature* feature);
+	void UpdateFeatureWakeups();
 
 private:
 	SimObjectIDPool idPool;
@@ -88,6 +91,13 @@ private:
 	std::vector<int> deletedFeatureIDs;
 	std::vector<CFeature*> features;
 	std::vector<CFeature*> updateFeatures;
+
+	// timer-wheel of {featureID, frame} wakeups for smoke, fire and geo-vents
+	// slot f % NUM_WAKEUP_SLOTS holds all events for frames f, f + N, f + 2N...
+	static constexpr int NUM_WAKEUP_SLOTS = 64;
+
+	std::array<std::vector<std::pair<int, int>>, NUM_WAKEUP_SLOTS> featureWakeups;
+	std::vector<std::pair<int, int>> dueFeatureWakeups;
 };
 
 extern CFeatureHandler featureHandler;
@@ -130,3 +130,23 @@ const CResourceMapAnalyzer* CResourceHandler::GetResourceMapAnalyzer(int resourc
 	return rma;
 }
 
+const CResourceMapAnalyzer* CResourceHandler::GetInitedResourceMapAnalyzer(int resourceId) const
+{
+	if (!IsValidId(resourceId))
+		return nullptr;
+
+	const CResourceMapAnalyzer* rma = &resourceMapAnalyzers[resourceId];
+
+	if (rma->GetNumSpots() < 0)
+		return nullptr;
+
+	return rma;
+}
+
+void CResourceHandler::InitResourceMapAnalyzers()
+{
+	for (size_t i = 0; i < resourceDescriptions.size(); ++i) {
+		GetResourceMapAnalyzer(i);
+	}
+}
+
@@ -103,6 +103,10 @@ public:
 	 * Returns the resource map analyzer by index.
 	 */
 	const CResourceMapAnalyzer* GetResourceMapAnalyzer(int resourceId);
+	/// returns nullptr if the analyzer has not been initialized yet (never runs Init)
+	const CResourceMapAnalyzer* GetInitedResourceMapAnalyzer(int resourceId) const;
+	/// runs Init for every resource's analyzer; sim thread only
+	void InitResourceMapAnalyzers();
 
 	size_t GetNumResources() const { return resourceDescriptions.size(); }
 
@@ -4,6 +4,7 @@
 #define _RESOURCE_MAP_ANALYZER_H
 
 #include "System/float3.h"
+#include <string>
 #include <vector>
 
 class CResource;
@@ -37,6 +38,7 @@ private:
 	void SaveResourceMap();
 	bool LoadResourceMap();
 
+	unsigned int CalcCacheHash() const;
 	std::string GetCacheFileName() const;
 
 	int resourceId;
@@ -45,33 +47,18 @@ private:
 	float extractorRadius;
 	float averageIncome;
 
-	bool stopMe;
-
 	// if more spots than this are found the map is considered a resource-map (eg. speed-metal), tweak as needed
 	int maxSpots;
 	int mapHeight;
 	int mapWidth;
-	int totalCells;
-	int squareRadius;
-	int doubleSquareRadius;
-	int totalResources;
-	int maxResource;
-	int tempResources;
-	int coordX;
-	int coordZ;
 	// from 0-255, the minimum percentage of resources a spot needs to have from
 	// the maximum to be saved, prevents crappier spots in between taken spaces
 	// (they are still perfectly valid and will generate resources mind you!)
 	int minIncomeForSpot;
 	int xtractorRadius;
-	int doubleRadius;
-
-	float3 bufferSpot;
 
-	std::vector<unsigned char> rexArrayA;
-	std::vector<unsigned char> rexArrayB;
-	std::vector<unsigned char> rexArrayC;
-	std::vector<int> tempAverage;
+	// identifies the resource-map and settings the cached spots were found with
+	unsigned int cacheHashCode;
 
 	std::vector<float3> vectoredSpots;
 };
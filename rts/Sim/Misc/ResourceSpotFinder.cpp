@@ -0,0 +1,162 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "ResourceSpotFinder.h"
+
+#include "System/Threading/ThreadPool.h"
+#include "lib/streflop/streflop_cond.h"
+
+
+CResourceSpotFinder::CResourceSpotFinder(const unsigned char* resourceMap, int mapWidth, int mapHeight, int radius)
+	: mapWidth(mapWidth)
+	, mapHeight(mapHeight)
+	, radius(radius)
+	, rowStride(mapWidth + 1 + radius * 2)
+{
+	discWidths.resize(radius * 2 + 1);
+
+	for (int a = 0; a <= radius * 2; a++) {
+		const float z = a - radius;
+		const float squareRadius = radius * radius;
+		discWidths[a] = int(math::sqrt(squareRadius - z * z));
+	}
+
+	resources.assign(resourceMap, resourceMap + mapWidth * mapHeight);
+	rowSums.resize(mapHeight * rowStride);
+	discSums.resize(mapWidth * mapHeight);
+	spotValues.resize(mapWidth * mapHeight);
+
+	// rows are independent within each pass
+	for_mt_chunk(0, mapHeight, [&](const int z) { UpdateRowSums(z); });
+	for_mt_chunk(0, mapHeight, [&](const int z) { UpdateDiscSums(z, 0, mapWidth - 1); });
+
+	if ((maxResource = *std::max_element(discSums.begin(), discSums.end())) == 0)
+		return;
+
+	for_mt_chunk(0, mapHeight, [&](const int z) {
+		for (int x = 0; x < mapWidth; x++) {
+			spotValues[z * mapWidth + x] = CalcSpotValue(discSums[z * mapWidth + x]);
+		}
+	});
+
+	valueCounts.fill(0);
+
+	for (const unsigned char value: spotValues) {
+		valueCounts[value]++;
+	}
+}
+
+
+void CResourceSpotFinder::UpdateRowSums(int z)
+{
+	const unsigned char* row = &resources[z * mapWidth];
+	int* sums = &rowSums[z * rowStride];
+	int sum = 0;
+
+	// the padding repeats the first and last sums, s.t. discs
+	// overlapping the map edges need no clamping
+	std::fill(sums, sums + radius + 1, 0);
+
+	for (int x = 0; x < mapWidth; x++) {
+		sums[radius + 1 + x] = (sum += row[x]);
+	}
+
+	std::fill(sums + radius + 1 + mapWidth, sums + rowStride, sum);
+}
+
+void CResourceSpotFinder::UpdateDiscSums(int z, int x0, int x1)
+{
+	int* sums = &discSums[z * mapWidth];
+
+	std::fill(sums + x0, sums + x1 + 1, 0);
+
+	for (int a = 0; a <= radius * 2; a++) {
+		const int sz = z - radius + a;
+
+		if (sz < 0 || sz >= mapHeight)
+			continue;
+
+		// rowSums[i] is the sum of resources[0, i - radius - 1] in this row
+		const int* rowBeg = &rowSums[sz * rowStride + radius];
+		const int discWidth = discWidths[a];
+
+		for (int x = x0; x <= x1; x++) {
+			sums[x] += (rowBeg[x + discWidth + 1] - rowBeg[x - discWidth]);
+		}
+	}
+}
+
+void CResourceSpotFinder::UpdateSpotValues(int z, int x0, int x1)
+{
+	for (int x = x0; x <= x1; x++) {
+		const int idx = z * mapWidth + x;
+		const int value = CalcSpotValue(discSums[idx]);
+
+		valueCounts[spotValues[idx]]--;
+		valueCounts[spotValues[idx] = value]++;
+	}
+}
+
+
+void CResourceSpotFinder::WipeDisc(int cx, int cz)
+{
+	const int z0 = std::max(cz - radius, 0);
+	const int z1 = std::min(cz + radius, mapHeight - 1);
+
+	for (int z = z0; z <= z1; z++) {
+		const int discWidth = discWidths[z - cz + radius];
+		const int x0 = std::max(cx - discWidth, 0);
+		const int x1 = std::min(cx + discWidth, mapWidth - 1);
+
+		std::fill(&resources[z * mapWidth + x0], &resources[z * mapWidth + x1] + 1, 0);
+		UpdateRowSums(z);
+	}
+
+	// only discs within two radii overlap the wiped one
+	const int wz0 = std::max(cz - radius * 2, 0);
+	const int wz1 = std::min(cz + radius * 2, mapHeight - 1);
+	const int wx0 = std::max(cx - radius * 2, 0);
+	const int wx1 = std::min(cx + radius * 2, mapWidth - 1);
+
+	for (int z = wz0; z <= wz1; z++) {
+		UpdateDiscSums(z, wx0, wx1);
+		UpdateSpotValues(z, wx0, wx1);
+	}
+}
+
+
+void CResourceSpotFinder::FindSpots(int minValue, int maxSpots, std::vector<Spot>& spots)
+{
+	if (maxResource == 0)
+		return;
+
+	const unsigned char* values = spotValues.data();
+
+	size_t searchIdx = 0;
+	int bestValue = 255;
+
+	for (int n = 0; n < maxSpots; n++) {
+		// values never increase, so neither does the best one; cells before
+		// the previous pick can not hold it anymore unless it dropped
+		for (; valueCounts[bestValue] == 0; bestValue--) {
+			searchIdx = 0;
+		}
+
+		if (bestValue < minValue)
+			break;
+
+		const void* cell = std::memchr(values + searchIdx, bestValue, spotValues.size() - searchIdx);
+
+		assert(cell != nullptr);
+		searchIdx = static_cast<const unsigned char*>(cell) - values;
+
+		const int cx = searchIdx % mapWidth;
+		const int cz = searchIdx / mapWidth;
+
+		spots.push_back({cx, cz, bestValue});
+		WipeDisc(cx, cz);
+	}
+}
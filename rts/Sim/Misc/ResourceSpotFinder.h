@@ -0,0 +1,69 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _RESOURCE_SPOT_FINDER_H
+#define _RESOURCE_SPOT_FINDER_H
+
+#include <array>
+#include <vector>
+
+/**
+ * Picks extractor spots on a resource map for CResourceMapAnalyzer.
+ *
+ * Every cell is valued by the resources inside the extractor disc centered
+ * on it. Spots are picked greedily: the best cell (the first in row-major
+ * order on ties) is taken and its disc wiped, after which only the values
+ * of cells within two radii have to be redone.
+ *
+ * Disc values are sums over per-row prefix sums, one subtraction per disc
+ * row, and whole rows are handled at once so the inner loops vectorize; the
+ * initial pass over the map is spread over all threads.
+ */
+class CResourceSpotFinder {
+public:
+	struct Spot {
+		int x;
+		int z;
+		// resources within the disc relative to the best disc on the map, [0, 255]
+		int value;
+	};
+
+public:
+	// <radius> is in resource-map cells
+	CResourceSpotFinder(const unsigned char* resourceMap, int mapWidth, int mapHeight, int radius);
+
+	// picks at most <maxSpots> spots, stops at the first one valued below <minValue>
+	void FindSpots(int minValue, int maxSpots, std::vector<Spot>& spots);
+
+	// the resources within the best disc on the (unwiped) map, 0 if the map has none
+	int GetMaxResource() const { return maxResource; }
+
+private:
+	void UpdateRowSums(int z);
+	void UpdateDiscSums(int z, int x0, int x1);
+	void UpdateSpotValues(int z, int x0, int x1);
+
+	void WipeDisc(int cx, int cz);
+
+	int CalcSpotValue(int discSum) const { return static_cast<int>(discSum * 255LL / maxResource); }
+
+private:
+	int mapWidth;
+	int mapHeight;
+	int radius;
+	int maxResource = 0;
+
+	// each row of prefix sums is padded by <radius> on both sides
+	int rowStride;
+
+	// half-width of the disc per row, [0, 2 * radius]
+	std::vector<int> discWidths;
+
+	std::vector<unsigned char> resources;
+	std::vector<int> rowSums;
+	std::vector<int> discSums;
+	std::vector<unsigned char> spotValues;
+
+	std::array<int, 256> valueCounts;
+};
+
+#endif // _RESOURCE_SPOT_FINDER_H
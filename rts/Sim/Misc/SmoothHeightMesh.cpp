@@ -11,6 +11,7 @@
 #include "Sim/Misc/ModInfo.h"
 #include "System/float3.h"
 #include "System/Log/ILog.h"
+#include "System/SlidingWindowMax.hpp"
 #include "System/SpringMath.h"
 #include "System/TimeProfiler.h"
 #include "System/Threading/ThreadPool.h"
@@ -61,7 +62,8 @@ void SmoothHeightMesh::Init(int2 max, int res, int smoothRad)
 
 	enabled = modInfo.enableSmoothMesh;
 
-	// we use SSE in performance sensitive code, don't let the window size be too small.
+	// kept although the sliding-window maximum has no minimum radius,
+	// so that existing games get the same (synced) mesh as before
 	if (smoothRad < 4) smoothRad = 4;
 
 	fmaxx = max.x * SQUARE_SIZE;
@@ -193,51 +195,17 @@ inline static void FindRadialMaximum(
 	int winSize,
 	float resolution,
 	const std::vector<float>& colsMaxima,
-	      std::vector<float>& mesh
+	      std::vector<float>& mesh,
+	      std::vector<int>& windowIndices
 ) {
-	for (int x = minx; x <= maxx; ++x) {
-		float maxRowHeight = -std::numeric_limits<float>::max();
-
-		// find current maximum within radius smoothRadius
-		// (in every column stack) along the current row
-		const int startx = std::max(x - winSize, 0);
-		const int endx = std::min(x + winSize, map.x - 1);
-
-		// This may mean the last SSE max function compares some values have already been compared
-		// This is harmless and avoids needlessly messy SSE code here
-		const int endIdx = endx - 3;
-
-		// Main loop for finding maximum height values
-		__m128 best = _mm_loadu_ps(&colsMaxima[startx]);
-		for (int i = startx + 4; i < endIdx; i += 4) {
-			__m128 next = _mm_loadu_ps(&colsMaxima[i]);
-			best = _mm_max_ps(best, next);
-		}
-
-		// Check the last few height values
-		{
-			__m128 next = _mm_loadu_ps(&colsMaxima[endIdx]);
-			best = _mm_max_ps(best, next);
-		}
-
-		// This is an SSE horizontal compare
-		{
-			// split the four values into sets of two and compare
-			__m128 bestAlt = _mm_movehl_ps(best, best);
-			best = _mm_max_ps(best, bestAlt);
-
-			// split the two values and compare
-			bestAlt = _mm_shuffle_ps(best, best, _MM_SHUFFLE(0, 0, 0, 1));
-			best = _mm_max_ss(best, bestAlt);
-			_mm_store_ss(&maxRowHeight, best);
-		}
-
-		mesh[x + y * map.x] = maxRowHeight;
+	// find current maximum within radius smoothRadius
+	// (in every column stack) along the current row
+	spring::SlidingWindowMax(colsMaxima.data(), map.x, winSize, minx, maxx, &mesh[minx + y * map.x], windowIndices);
 
 #ifdef SMOOTH_MESH_DEBUG_MAXIMA
-		LOG("%s: y:%d x:%d local max: %f", __func__, y, x, maxRowHeight);
+	for (int x = minx; x <= maxx; ++x)
+		LOG("%s: y:%d x:%d local max: %f", __func__, y, x, mesh[x + y * map.x]);
 #endif
-	}
 }
 
 
@@ -524,7 +492,7 @@ LOG("%s: quad area in world space (%f,%f) (%f,%f)", __func__
 	FindMaximumColumnHeights(map, damageMin.y, min.x, max.x, winSize, resolution, colsMaxima, maximaRows);
 
 	for (int y = damageMin.y; y <= damageMax.y; ++y) {
-		FindRadialMaximum(map, y, damageMin.x, damageMax.x, winSize, resolution, colsMaxima, maximaMesh);
+		FindRadialMaximum(map, y, damageMin.x, damageMax.x, winSize, resolution, colsMaxima, maximaMesh, windowIndices);
 		AdvanceMaximas(map, y+1, min.x, max.x, winSize, resolution, colsMaxima, maximaRows);
 	}
 }
@@ -608,19 +576,38 @@ void SmoothHeightMesh::MakeSmoothMesh() {
 	int2 max{maxx-1, maxy-1};
 	int2 map{maxx, maxy};
 
- 	FindMaximumColumnHeights(map, 0, 0, max.x, winSize, resolution, colsMaxima, maximaRows);
+	// rows are split into bands, each with its own column maxima
+	// so they can be processed independently of the other bands
+	const int numBands = std::clamp(ThreadPool::GetNumThreads(), 1, maxy);
+	const int bandRows = (maxy + numBands - 1) / numBands;
+
+	for_mt(0, numBands, [&](const int band) {
+		const int minBandY = band * bandRows;
+		const int maxBandY = std::min(minBandY + bandRows, maxy) - 1;
+
+		std::vector<float> bandColsMaxima(maxx, -std::numeric_limits<float>::max());
+		std::vector<int> bandMaximaRows(maxx, -1);
+		std::vector<int> bandWindowIndices;
 
-	for (int y = 0; y <= max.y; ++y) {
-		FindRadialMaximum(map, y, 0, max.x, winSize, resolution, colsMaxima, maximaMesh);
-		AdvanceMaximas(map, y+1, 0, max.x, winSize, resolution, colsMaxima, maximaRows);
+		FindMaximumColumnHeights(map, minBandY, 0, max.x, winSize, resolution, bandColsMaxima, bandMaximaRows);
+
+		for (int y = minBandY; y <= maxBandY; ++y) {
+			FindRadialMaximum(map, y, 0, max.x, winSize, resolution, bandColsMaxima, maximaMesh, bandWindowIndices);
+			AdvanceMaximas(map, y+1, 0, max.x, winSize, resolution, bandColsMaxima, bandMaximaRows);
 
 #ifdef _DEBUG
-		CheckInvariants(y, max.x, max.y, winSize, resolution, colsMaxima, maximaRows);
+			CheckInvariants(y, max.x, max.y, winSize, resolution, bandColsMaxima, bandMaximaRows);
 #endif
-	}
-
-	BlurHorizontal(map, min, max, blurSize, resolution, maximaMesh, tempMesh);
-	BlurVertical(map, min, max, blurSize, resolution, tempMesh, mesh);
+		}
+	});
+
+	// every row (column) is blurred independently of the others
+	for_mt_chunk(min.y, max.y + 1, [&](const int y) {
+		BlurHorizontal(map, {min.x, y}, {max.x, y}, blurSize, resolution, maximaMesh, tempMesh);
+	}, -32);
+	for_mt_chunk(min.x, max.x + 1, [&](const int x) {
+		BlurVertical(map, {x, min.y}, {x, max.y}, blurSize, resolution, tempMesh, mesh);
+	}, -32);
 
 	// <mesh> now contains the final smoothed heightmap, save it in origMesh
 	std::copy(mesh.begin(), mesh.end(), origMesh.begin());
@@ -82,6 +82,7 @@ private:
 
 	std::vector<float> colsMaxima;
 	std::vector<int> maximaRows;
+	std::vector<int> windowIndices;
 
 	MapChangeTrack mapChangeTrack;
 };
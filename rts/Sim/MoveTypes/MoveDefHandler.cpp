@@ -5,6 +5,9 @@
 #include "Map/MapInfo.h"
 #include "MoveMath/MoveMath.h"
 #include "Sim/Misc/GlobalConstants.h"
+#include "System/Rectangle.h"
+#include "System/Log/ILog.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/creg/STL_Map.h"
 #include "System/Exceptions.h"
 #include "System/CRC.h"
@@ -54,7 +57,13 @@ CR_REG_METADATA(MoveDefHandler, (
 	CR_MEMBER(moveDefs),
 	CR_MEMBER(nameMap),
 	CR_MEMBER(mdCounter),
-	CR_MEMBER(mdChecksum)
+	CR_MEMBER(mdChecksum),
+
+	CR_IGNORED(speedModGrids),
+	CR_IGNORED(speedModGridIndices),
+	CR_IGNORED(gridMoveDefs),
+
+	CR_POSTLOAD(PostLoad)
 ))
 
 
@@ -138,6 +147,74 @@ void MoveDefHandler::Init(LuaParser* defsParser)
 	crc << CMoveMath::noHoverWaterMove;
 
 	mdChecksum = crc.GetDigest();
+
+	InitSpeedModGrids();
+}
+
+
+static bool HaveEqualSpeedMods(const MoveDef& a, const MoveDef& b)
+{
+	// everything CMoveMath::CalcTypeSquareSpeedMod depends on
+	if (a.speedModClass != b.speedModClass)
+		return false;
+	if (a.depth != b.depth || a.maxSlope != b.maxSlope || a.slopeMod != b.slopeMod)
+		return false;
+
+	return (std::equal(std::begin(a.depthModParams), std::end(a.depthModParams), std::begin(b.depthModParams)));
+}
+
+void MoveDefHandler::InitSpeedModGrids()
+{
+	speedModGrids.clear();
+	speedModGrids.reserve(mdCounter);
+	gridMoveDefs.clear();
+
+	for (unsigned int i = 0; i < mdCounter; i++) {
+		const auto pred = [&](unsigned int j) { return (HaveEqualSpeedMods(moveDefs[i], moveDefs[j])); };
+		const auto iter = std::find_if(gridMoveDefs.begin(), gridMoveDefs.end(), pred);
+
+		if (iter != gridMoveDefs.end()) {
+			speedModGridIndices[i] = iter - gridMoveDefs.begin();
+			continue;
+		}
+
+		speedModGridIndices[i] = gridMoveDefs.size();
+		gridMoveDefs.push_back(i);
+		speedModGrids.emplace_back(mapDims.hmapx * mapDims.hmapy, 0.0f);
+	}
+
+	for_mt(0, speedModGrids.size(), [&](const int gridIdx) {
+		const MoveDef& md = moveDefs[gridMoveDefs[gridIdx]];
+
+		for (int square = 0, n = mapDims.hmapx * mapDims.hmapy; square < n; square++) {
+			speedModGrids[gridIdx][square] = CMoveMath::CalcTypeSquareSpeedMod(md, square);
+		}
+	});
+
+	LOG("[MoveDefHandler::%s] %u speed-mod grid(s) for %u MoveDef(s)", __func__, static_cast<unsigned int>(speedModGrids.size()), mdCounter);
+}
+
+void MoveDefHandler::UpdateSpeedModGrids(const SRectangle& rect)
+{
+	if (speedModGrids.empty())
+		return;
+
+	// heightmap squares to (inclusive) typemap squares; slopes
+	// of neighboring squares depend on the changed heights too
+	const int x1 = std::max((rect.x1 >> 1) - 1, 0);
+	const int z1 = std::max((rect.z1 >> 1) - 1, 0);
+	const int x2 = std::min((rect.x2 >> 1) + 1, mapDims.hmapx - 1);
+	const int z2 = std::min((rect.z2 >> 1) + 1, mapDims.hmapy - 1);
+
+	for (size_t gridIdx = 0; gridIdx < speedModGrids.size(); gridIdx++) {
+		const MoveDef& md = moveDefs[gridMoveDefs[gridIdx]];
+
+		for (int z = z1; z <= z2; z++) {
+			for (int x = x1; x <= x2; x++) {
+				speedModGrids[gridIdx][z * mapDims.hmapx + x] = CMoveMath::CalcTypeSquareSpeedMod(md, z * mapDims.hmapx + x);
+			}
+		}
+	}
 }
 
 
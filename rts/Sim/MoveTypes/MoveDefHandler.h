@@ -5,6 +5,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 
 #include "System/float3.h"
 #include "System/type2.h"
@@ -156,6 +157,7 @@ struct MoveDef {
 
 
 class LuaParser;
+struct SRectangle;
 class MoveDefHandler
 {
 	CR_DECLARE_STRUCT(MoveDefHandler)
@@ -163,10 +165,12 @@ public:
 	void Init(LuaParser* defsParser);
 	void Kill() {
 		nameMap.clear(); // never iterated
+		speedModGrids.clear();
 
 		mdCounter = 0;
 		mdChecksum = 0;
 	}
+	void PostLoad() { InitSpeedModGrids(); }
 
 	MoveDef* GetMoveDefByPathType(unsigned int pathType) { return &moveDefs[pathType]; }
 	MoveDef* GetMoveDefByName(const std::string& name);
@@ -174,10 +178,30 @@ public:
 	unsigned int GetNumMoveDefs() const { return mdCounter; }
 	unsigned int GetCheckSum() const { return mdChecksum; }
 
+	// non-directional speed-modifiers per typemap square, see CMoveMath::GetPosSpeedMod
+	const float* GetSpeedModGrid(unsigned int pathType) const {
+		if (speedModGrids.empty())
+			return nullptr;
+
+		return (speedModGrids[speedModGridIndices[pathType]].data());
+	}
+
+	// must be called whenever heightmap or typemap data inside rect (in heightmap squares) changed
+	void UpdateSpeedModGrids(const SRectangle& rect);
+
+private:
+	void InitSpeedModGrids();
+
 private:
 	std::array<MoveDef, 256> moveDefs;
 	spring::unordered_map<unsigned int, int> nameMap;
 
+	// MoveDefs with identical terrain-related parameters share a grid
+	std::vector< std::vector<float> > speedModGrids;
+	std::array<unsigned int, 256> speedModGridIndices;
+	// index of the first MoveDef using each grid
+	std::vector<unsigned int> gridMoveDefs;
+
 	unsigned int mdCounter = 0;
 	unsigned int mdChecksum = 0;
 };
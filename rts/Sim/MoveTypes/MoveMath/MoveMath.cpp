@@ -6,6 +6,7 @@
 #include "Map/MapInfo.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/GroundBlockingObjectMap.h"
+#include "Sim/Misc/ModInfo.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
 #include "Sim/Objects/SolidObject.h"
@@ -45,13 +46,24 @@ float CMoveMath::yLevel(const MoveDef& moveDef, const float3& pos)
 
 
 
-/* calculate the local speed-modifier for this MoveDef */
+/* look up the local speed-modifier for this MoveDef */
 float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, unsigned xSquare, unsigned zSquare)
 {
 	if (xSquare >= mapDims.mapx || zSquare >= mapDims.mapy)
 		return 0.0f;
 
 	const int square = (xSquare >> 1) + ((zSquare >> 1) * mapDims.hmapx);
+	const float* speedMods = moveDefHandler.GetSpeedModGrid(moveDef.pathType);
+
+	if (speedMods != nullptr)
+		return speedMods[square];
+
+	return (CalcTypeSquareSpeedMod(moveDef, square));
+}
+
+/* calculate the local speed-modifier for this MoveDef from terrain data */
+float CMoveMath::CalcTypeSquareSpeedMod(const MoveDef& moveDef, int square)
+{
 	const int squareTerrType = readMap->GetTypeMapSynced()[square];
 
 	const float height  = readMap->GetMIPHeightMapSynced(1)[square];
@@ -75,6 +87,10 @@ float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, unsigned xSquare, unsign
 	if (xSquare >= mapDims.mapx || zSquare >= mapDims.mapy)
 		return 0.0f;
 
+	// without directional pathing only ships care about moveDir, the rest is precomputed
+	if (!modInfo.allowDirectionalPathing && moveDef.speedModClass != MoveDef::Ship)
+		return (GetPosSpeedMod(moveDef, xSquare, zSquare));
+
 	const int square = (xSquare >> 1) + ((zSquare >> 1) * mapDims.hmapx);
 	const int squareTerrType = readMap->GetTypeMapSynced()[square];
 
@@ -49,6 +49,10 @@ public:
 		return (GetPosSpeedMod(moveDef, pos.x / SQUARE_SIZE, pos.z / SQUARE_SIZE, moveDir));
 	}
 
+	// computes the non-directional speed-multiplier of a typemap (half-resolution) square;
+	// GetPosSpeedMod reads these from MoveDefHandler's precomputed grids instead
+	static float CalcTypeSquareSpeedMod(const MoveDef& moveDef, int square);
+
 	// tells whether a position is blocked (inaccessable for a given object's MoveDef)
 	static inline BlockType IsBlocked(const MoveDef& moveDef, const float3& pos, const CSolidObject* collider);
 	static inline BlockType IsBlocked(const MoveDef& moveDef, int xSquare, int zSquare, const CSolidObject* collider);
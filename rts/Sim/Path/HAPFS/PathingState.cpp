@@ -3,7 +3,6 @@
 #include "PathingState.h"
 
 #include "zlib.h"
-#include "minizip/zip.h"
 
 #include "Game/GlobalUnsynced.h"
 #include "Game/LoadScreen.h"
@@ -21,13 +20,13 @@
 #include "PathMemPool.h"
 
 #include "System/Config/ConfigHandler.h"
-#include "System/FileSystem/Archives/IArchive.h"
-#include "System/FileSystem/ArchiveLoader.h"
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/Platform/Threading.h"
 #include "System/StringUtil.h"
+#include "System/TimeProfiler.h"
+#include "System/Sync/SHA512.hpp"
 #include "System/Threading/ThreadPool.h" // for_mt
 
 #define ENABLE_NETLOG_CHECKSUM 1
@@ -49,7 +48,38 @@ static const std::string GetPathCacheDir() {
 }
 
 static const std::string GetCacheFileName(const std::string& fileHashCode, const std::string& peFileName, const std::string& mapFileName) {
-	return (GetPathCacheDir() + mapFileName + "." + peFileName + "-" + fileHashCode + ".zip");
+	return (GetPathCacheDir() + mapFileName + "." + peFileName + "-" + fileHashCode + ".pec");
+}
+
+
+// cache-files are stored uncompressed, one section per path-type;
+// all parts are 16-byte aligned s.t. the file can be mapped as-is
+static constexpr std::uint32_t CACHE_FILE_MAGIC   = 0x43455048; // "HPEC"
+static constexpr std::uint32_t CACHE_FILE_VERSION = 1;
+static constexpr std::uint32_t CACHE_FILE_ALIGN   = 16;
+
+struct CacheFileHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t hashCode;
+	std::uint32_t blockSize;
+	std::uint32_t numPathTypes;
+	std::uint32_t numBlocks;
+	std::uint32_t numVertices;
+	std::uint32_t padding;
+};
+
+struct CacheSectionHeader {
+	std::uint32_t pathType;
+	std::uint32_t checksum; // CRC32 over offsets and costs
+	std::uint32_t padding[2];
+};
+
+static_assert((sizeof(CacheFileHeader) % CACHE_FILE_ALIGN) == 0, "");
+static_assert((sizeof(CacheSectionHeader) % CACHE_FILE_ALIGN) == 0, "");
+
+static size_t GetAlignmentPadding(size_t size) {
+	return ((CACHE_FILE_ALIGN - (size % CACHE_FILE_ALIGN)) % CACHE_FILE_ALIGN);
 }
 
 void PathingState::KillStatic() { pathingStates = 0; }
@@ -160,6 +190,12 @@ void PathingState::Init(std::vector<IPathFinder*> pathFinderlist, PathingState*
 	InitEstimator(peFileName, mapFileName);
 }
 
+PathingState::~PathingState()
+{
+	if (cacheFile != nullptr)
+		fclose(cacheFile);
+}
+
 void PathingState::Terminate()
 {
 	if (pathCache[0] != nullptr)
@@ -228,22 +264,33 @@ void PathingState::InitEstimator(const std::string& peFileName, const std::strin
 		auto& nodeFlags = blockStates.nodeLinksObsoleteFlags;
 		std::for_each(nodeFlags.begin(), nodeFlags.end(), [](std::uint8_t& f){ f = PATH_DIRECTIONS_HALF_MASK; });
 
-		// note: only really needed if numExtraThreads > 0
-		spring::barrier pathBarrier(numThreads);
+		sprintf(calcMsg, fmtStrs[2], __func__, BLOCK_SIZE, peFileName.c_str(), fileHashCode);
+		loadscreen->SetLoadMessage(calcMsg, true);
 
-		for_mt(0, numThreads, [this, &pathBarrier](int i) {
-			CalcOffsetsAndPathCosts(ThreadPool::GetThreadNum(), &pathBarrier);
-		});
+		// each path-type's results are streamed to the cache-file as soon as they are done
+		const bool writeFile = BeginWriteFile(peFileName, mapFileName);
 
-		std::for_each(nodeFlags.begin(), nodeFlags.end(), [](std::uint8_t& f){ f = 0; });
+		for (unsigned int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); pathType++) {
+			// note: only really needed if numExtraThreads > 0
+			spring::barrier pathBarrier(numThreads);
 
-		sprintf(calcMsg, fmtStrs[2], __func__, BLOCK_SIZE, peFileName.c_str(), fileHashCode);
-		loadscreen->SetLoadMessage(calcMsg, true);
+			offsetBlockNum = {mapDimensionsInBlocks.x * mapDimensionsInBlocks.y};
+			costBlockNum = {mapDimensionsInBlocks.x * mapDimensionsInBlocks.y};
 
-		WriteFile(peFileName, mapFileName);
+			for_mt(0, numThreads, [this, pathType, &pathBarrier](int i) {
+				CalcOffsetsAndPathCosts(pathType, ThreadPool::GetThreadNum(), &pathBarrier);
+			});
 
-		sprintf(calcMsg, fmtStrs[3], __func__, BLOCK_SIZE, peFileName.c_str(), fileHashCode);
-		loadscreen->SetLoadMessage(calcMsg, true);
+			if (writeFile)
+				WriteFileSection(pathType);
+		}
+
+		std::for_each(nodeFlags.begin(), nodeFlags.end(), [](std::uint8_t& f){ f = 0; });
+
+		if (writeFile && EndWriteFile(peFileName, mapFileName)) {
+			sprintf(calcMsg, fmtStrs[3], __func__, BLOCK_SIZE, peFileName.c_str(), fileHashCode);
+			loadscreen->SetLoadMessage(calcMsg, true);
+		}
 	}
 
 	// calculate checksum over block-offsets and vertex-costs
@@ -265,7 +312,7 @@ void PathingState::InitBlocks()
 
 
 __FORCE_ALIGN_STACK__
-void PathingState::CalcOffsetsAndPathCosts(unsigned int threadNum, spring::barrier* pathBarrier)
+void PathingState::CalcOffsetsAndPathCosts(unsigned int pathType, unsigned int threadNum, spring::barrier* pathBarrier)
 {
 	// reset FPU state for synced computations
 	//streflop::streflop_init<streflop::Simple>();
@@ -278,33 +325,28 @@ void PathingState::CalcOffsetsAndPathCosts(unsigned int threadNum, spring::barri
 	int i;
 
 	while ((i = --offsetBlockNum) >= 0)
-		CalculateBlockOffsets(maxBlockIdx - i, threadNum);
+		CalculateBlockOffsets(pathType, maxBlockIdx - i, threadNum);
 
 	pathBarrier->wait();
 
 	while ((i = --costBlockNum) >= 0)
-		EstimatePathCosts(maxBlockIdx - i, threadNum);
+		EstimatePathCosts(pathType, maxBlockIdx - i, threadNum);
 }
 
-void PathingState::CalculateBlockOffsets(unsigned int blockIdx, unsigned int threadNum)
+void PathingState::CalculateBlockOffsets(unsigned int pathType, unsigned int blockIdx, unsigned int threadNum)
 {
 	const int2 blockPos = BlockIdxToPos(blockIdx);
+	// path-types are processed one after another, report progress over all of them
+	const unsigned int progressIdx = (pathType * blockStates.GetSize() + blockIdx) / moveDefHandler.GetNumMoveDefs();
 
-	if (threadNum == 0 && blockIdx >= nextOffsetMessageIdx) {
-		nextOffsetMessageIdx = blockIdx + blockStates.GetSize() / 16;
-		clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(BLOCK_SIZE | (blockIdx << 8)));
+	if (threadNum == 0 && progressIdx >= nextOffsetMessageIdx) {
+		nextOffsetMessageIdx = progressIdx + blockStates.GetSize() / 16;
+		clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(BLOCK_SIZE | (progressIdx << 8)));
 	}
 
-	for (unsigned int i = 0; i < moveDefHandler.GetNumMoveDefs(); i++) {
-		const MoveDef* md = moveDefHandler.GetMoveDefByPathType(i);
+	const MoveDef* md = moveDefHandler.GetMoveDefByPathType(pathType);
 
-		//LOG("TK PathingState::InitBlocks: blockStates.peNodeOffsets %d now %d looking up %d", i, blockStates.peNodeOffsets[md->pathType].size(), blockIdx);
-		blockStates.peNodeOffsets[md->pathType][blockIdx] = FindBlockPosOffset(*md, blockPos.x, blockPos.y);
-		// LOG("UPDATED blockStates.peNodeOffsets[%d][%d] = (%d, %d) : (%d, %d)"
-		// 		, md->pathType, blockIdx
-		// 		, blockStates.peNodeOffsets[md->pathType][blockIdx].x, blockStates.peNodeOffsets[md->pathType][blockIdx].y
-		// 		, blockPos.x, blockPos.y);
-	}
+	blockStates.peNodeOffsets[md->pathType][blockIdx] = FindBlockPosOffset(*md, blockPos.x, blockPos.y);
 }
 
 /**
@@ -366,25 +408,22 @@ int2 PathingState::FindBlockPosOffset(const MoveDef& moveDef, unsigned int block
 	return bestPos;
 }
 
-void PathingState::EstimatePathCosts(unsigned int blockIdx, unsigned int threadNum)
+void PathingState::EstimatePathCosts(unsigned int pathType, unsigned int blockIdx, unsigned int threadNum)
 {
 	const int2 blockPos = BlockIdxToPos(blockIdx);
+	const unsigned int progressIdx = (pathType * blockStates.GetSize() + blockIdx) / moveDefHandler.GetNumMoveDefs();
 
-	if (threadNum == 0 && blockIdx >= nextCostMessageIdx) {
-		nextCostMessageIdx = blockIdx + blockStates.GetSize() / 16;
+	if (threadNum == 0 && progressIdx >= nextCostMessageIdx) {
+		nextCostMessageIdx = progressIdx + blockStates.GetSize() / 16;
 
 		char calcMsg[128];
-		sprintf(calcMsg, "[%s] precached %d of %d blocks", __func__, blockIdx, blockStates.GetSize());
+		sprintf(calcMsg, "[%s] precached %d of %d blocks", __func__, progressIdx, blockStates.GetSize());
 
-		clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(0x1 | BLOCK_SIZE | (blockIdx << 8)));
-		loadscreen->SetLoadMessage(calcMsg, (blockIdx != 0));
+		clientNet->Send(CBaseNetProtocol::Get().SendCPUUsage(0x1 | BLOCK_SIZE | (progressIdx << 8)));
+		loadscreen->SetLoadMessage(calcMsg, (progressIdx != 0));
 	}
 
-	for (unsigned int i = 0; i < moveDefHandler.GetNumMoveDefs(); i++) {
-		const MoveDef* md = moveDefHandler.GetMoveDefByPathType(i);
-
-		CalcVertexPathCosts(*md, blockPos, threadNum);
-	}
+	CalcVertexPathCosts(*moveDefHandler.GetMoveDefByPathType(pathType), blockPos, threadNum);
 }
 
 /**
@@ -523,65 +562,68 @@ bool PathingState::ReadFile(const std::string& peFileName, const std::string& ma
 	if (!FileSystem::FileExists(cacheFileName))
 		return false;
 
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
+	FILE* file = fopen(dataDirsAccess.LocateFile(cacheFileName).c_str(), "rb");
 
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
+	if (file == nullptr)
 		return false;
-	}
 
 	char calcMsg[512];
 	sprintf(calcMsg, "Reading Estimate PathCosts [%d]", BLOCK_SIZE);
 	loadscreen->SetLoadMessage(calcMsg);
 
-	const unsigned fid = upfile->FindFile("pathinfo");
-	if (fid >= upfile->NumFiles()) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	const unsigned int numPathTypes = moveDefHandler.GetNumMoveDefs();
+	const unsigned int numVertices = blockStates.GetSize() * PATH_DIRECTION_VERTICES;
 
-	std::vector<std::uint8_t> buffer;
+	const size_t offsetsSize = blockStates.GetSize() * sizeof(short2);
+	const size_t costsSize = numVertices * sizeof(float);
 
-	if (!upfile->GetFile(fid, buffer) || buffer.size() < 4) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	CacheFileHeader header;
 
-	const unsigned int filehash = *(reinterpret_cast<unsigned int*>(&buffer[0]));
-	const unsigned int blockSize = blockStates.GetSize() * sizeof(short2);
-	unsigned int pos = sizeof(unsigned);
+	bool readOk = (fread(&header, sizeof(header), 1, file) == 1);
 
-	if (filehash != fileHashCode) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	readOk = readOk && (header.magic == CACHE_FILE_MAGIC && header.version == CACHE_FILE_VERSION);
+	readOk = readOk && (header.hashCode == fileHashCode && header.blockSize == BLOCK_SIZE);
+	readOk = readOk && (header.numPathTypes == numPathTypes && header.numBlocks == blockStates.GetSize() && header.numVertices == numVertices);
 
-	if (buffer.size() < (pos + blockSize * moveDefHandler.GetNumMoveDefs())) {
-		FileSystem::Remove(cacheFileName);
-		return false;
-	}
+	// read offsets and costs straight into their final storage, section by section
+	for (unsigned int pathType = 0; readOk && pathType < numPathTypes; ++pathType) {
+		CacheSectionHeader section;
+
+		std::uint8_t* offsets = reinterpret_cast<std::uint8_t*>(blockStates.peNodeOffsets[pathType].data());
+		std::uint8_t* costs = reinterpret_cast<std::uint8_t*>(&vertexCosts[pathType * numVertices]);
 
-	// read center-offset data
-	for (int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
-		std::memcpy(&blockStates.peNodeOffsets[pathType][0], &buffer[pos], blockSize);
-		pos += blockSize;
+		readOk = readOk && (fread(&section, sizeof(section), 1, file) == 1 && section.pathType == pathType);
+		readOk = readOk && (fread(offsets, 1, offsetsSize, file) == offsetsSize);
+		readOk = readOk && (fseek(file, GetAlignmentPadding(offsetsSize), SEEK_CUR) == 0);
+		readOk = readOk && (fread(costs, 1, costsSize, file) == costsSize);
+		readOk = readOk && (fseek(file, GetAlignmentPadding(costsSize), SEEK_CUR) == 0);
+
+		if (!readOk)
+			break;
+
+		uLong checksum = crc32(0L, Z_NULL, 0);
+		checksum = crc32(checksum, offsets, offsetsSize);
+		checksum = crc32(checksum, costs, costsSize);
+
+		readOk = (section.checksum == static_cast<std::uint32_t>(checksum));
 	}
 
-	// read vertex-cost data
-	if (buffer.size() < (pos + vertexCosts.size() * sizeof(float))) {
+	fclose(file);
+
+	if (!readOk) {
+		LOG_L(L_WARNING, "[PathEstimator::%s] discarding invalid cache-file \"%s\"", __func__, cacheFileName.c_str());
 		FileSystem::Remove(cacheFileName);
 		return false;
 	}
 
-	std::memcpy(&vertexCosts[0], &buffer[pos], vertexCosts.size() * sizeof(float));
 	return true;
 }
 
 
 /**
- * Try to write offset and vertex data to file.
+ * Create the cache-file and write its header; sections are appended by WriteFileSection.
  */
-bool PathingState::WriteFile(const std::string& peFileName, const std::string& mapFileName)
+bool PathingState::BeginWriteFile(const std::string& peFileName, const std::string& mapFileName)
 {
 	// we need this directory to exist
 	if (!FileSystem::CreateDirectory(GetPathCacheDir()))
@@ -592,38 +634,68 @@ bool PathingState::WriteFile(const std::string& peFileName, const std::string& m
 
 	LOG("[PathEstimator::%s] hash=%s file=\"%s\" (exists=%d)", __func__, hashHexString.c_str(), cacheFileName.c_str(), FileSystem::FileExists(cacheFileName));
 
-	// open file for writing in a suitable location
-	zipFile file = zipOpen(dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE).c_str(), APPEND_STATUS_CREATE);
+	// written under a temporary name, a partial file must never be picked up by ReadFile
+	const std::string tmpFileName = dataDirsAccess.LocateFile(cacheFileName, FileQueryFlags::WRITE) + ".tmp";
 
-	if (file == nullptr)
+	assert(cacheFile == nullptr);
+
+	if ((cacheFile = fopen(tmpFileName.c_str(), "wb")) == nullptr)
 		return false;
 
-	zipOpenNewFileInZip(file, "pathinfo", nullptr, nullptr, 0, nullptr, 0, nullptr, Z_DEFLATED, Z_BEST_COMPRESSION);
+	CacheFileHeader header;
+	header.magic = CACHE_FILE_MAGIC;
+	header.version = CACHE_FILE_VERSION;
+	header.hashCode = fileHashCode;
+	header.blockSize = BLOCK_SIZE;
+	header.numPathTypes = moveDefHandler.GetNumMoveDefs();
+	header.numBlocks = blockStates.GetSize();
+	header.numVertices = blockStates.GetSize() * PATH_DIRECTION_VERTICES;
+	header.padding = 0;
+
+	cacheFileWriteOk = (fwrite(&header, sizeof(header), 1, cacheFile) == 1);
+	return true;
+}
 
-	// write hash-code (NOTE: this also affects the CRC!)
-	zipWriteInFileInZip(file, (const void*) &fileHashCode, 4);
+void PathingState::WriteFileSection(unsigned int pathType)
+{
+	static constexpr std::uint8_t padding[CACHE_FILE_ALIGN] = {0};
 
-	// write center-offsets
-	for (int pathType = 0; pathType < moveDefHandler.GetNumMoveDefs(); ++pathType) {
-		zipWriteInFileInZip(file, (const void*) &blockStates.peNodeOffsets[pathType][0], blockStates.peNodeOffsets[pathType].size() * sizeof(short2));
-	}
+	const unsigned int numVertices = blockStates.GetSize() * PATH_DIRECTION_VERTICES;
 
-	// write vertex-costs
-	zipWriteInFileInZip(file, vertexCosts.data(), vertexCosts.size() * sizeof(float));
+	const size_t offsetsSize = blockStates.GetSize() * sizeof(short2);
+	const size_t costsSize = numVertices * sizeof(float);
 
-	zipCloseFileInZip(file);
-	zipClose(file, nullptr);
+	const std::uint8_t* offsets = reinterpret_cast<const std::uint8_t*>(blockStates.peNodeOffsets[pathType].data());
+	const std::uint8_t* costs = reinterpret_cast<const std::uint8_t*>(&vertexCosts[pathType * numVertices]);
 
+	uLong checksum = crc32(0L, Z_NULL, 0);
+	checksum = crc32(checksum, offsets, offsetsSize);
+	checksum = crc32(checksum, costs, costsSize);
 
-	// get the CRC over the written path data
-	std::unique_ptr<IArchive> upfile(archiveLoader.OpenArchive(dataDirsAccess.LocateFile(cacheFileName), "sdz"));
+	CacheSectionHeader section = {pathType, static_cast<std::uint32_t>(checksum), {0, 0}};
 
-	if (upfile == nullptr || !upfile->IsOpen()) {
-		FileSystem::Remove(cacheFileName);
+	cacheFileWriteOk = cacheFileWriteOk && (fwrite(&section, sizeof(section), 1, cacheFile) == 1);
+	cacheFileWriteOk = cacheFileWriteOk && (fwrite(offsets, 1, offsetsSize, cacheFile) == offsetsSize);
+	cacheFileWriteOk = cacheFileWriteOk && (fwrite(padding, 1, GetAlignmentPadding(offsetsSize), cacheFile) == GetAlignmentPadding(offsetsSize));
+	cacheFileWriteOk = cacheFileWriteOk && (fwrite(costs, 1, costsSize, cacheFile) == costsSize);
+	cacheFileWriteOk = cacheFileWriteOk && (fwrite(padding, 1, GetAlignmentPadding(costsSize), cacheFile) == GetAlignmentPadding(costsSize));
+}
+
+bool PathingState::EndWriteFile(const std::string& peFileName, const std::string& mapFileName)
+{
+	const std::string hashHexString = IntToString(fileHashCode, "%x");
+	const std::string absFileName = dataDirsAccess.LocateFile(GetCacheFileName(hashHexString, peFileName, mapFileName), FileQueryFlags::WRITE);
+	const std::string tmpFileName = absFileName + ".tmp";
+
+	cacheFileWriteOk = (fclose(cacheFile) == 0) && cacheFileWriteOk;
+	cacheFile = nullptr;
+
+	if (!cacheFileWriteOk || std::rename(tmpFileName.c_str(), absFileName.c_str()) != 0) {
+		LOG_L(L_WARNING, "[PathEstimator::%s] failed to write cache-file \"%s\"", __func__, absFileName.c_str());
+		std::remove(tmpFileName.c_str());
 		return false;
 	}
 
-	assert(upfile->FindFile("pathinfo") < upfile->NumFiles());
 	return true;
 }
 
@@ -4,6 +4,7 @@
 #define HAPFS_PATHINGSTATESYSTEM_H
 
 #include <atomic>
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@ class PathingState {
 public:
 
 	PathingState();
+	~PathingState();
 
     void Init(std::vector<IPathFinder*> pathFinderlist, PathingState* parentState, unsigned int BLOCK_SIZE, const std::string& peFileName, const std::string& mapFileName);
 
@@ -130,16 +132,18 @@ private:
     void InitEstimator(const std::string& peFileName, const std::string& mapFileName);
     void InitBlocks();
 
-    void CalcOffsetsAndPathCosts(unsigned int threadNum, spring::barrier* pathBarrier);
-    void CalculateBlockOffsets(unsigned int, unsigned int);
-    void EstimatePathCosts(unsigned int, unsigned int);
+    void CalcOffsetsAndPathCosts(unsigned int pathType, unsigned int threadNum, spring::barrier* pathBarrier);
+    void CalculateBlockOffsets(unsigned int, unsigned int, unsigned int);
+    void EstimatePathCosts(unsigned int, unsigned int, unsigned int);
 
     int2 FindBlockPosOffset(const MoveDef&, unsigned int, unsigned int) const;
     void CalcVertexPathCosts(const MoveDef&, int2, unsigned int threadNum = 0);
     void CalcVertexPathCost(const MoveDef&, int2, unsigned int pathDir, unsigned int threadNum = 0);
 
 	bool ReadFile(const std::string& peFileName, const std::string& mapFileName);
-	bool WriteFile(const std::string& peFileName, const std::string& mapFileName);
+	bool BeginWriteFile(const std::string& peFileName, const std::string& mapFileName);
+	void WriteFileSection(unsigned int pathType);
+	bool EndWriteFile(const std::string& peFileName, const std::string& mapFileName);
 
 	std::size_t getCountOfUpdates() const { return updatedBlocks.size(); }
 
@@ -164,6 +168,10 @@ private:
     unsigned int nextOffsetMessageIdx = 0;
     unsigned int nextCostMessageIdx = 0;
 
+	// cache-file being written while the estimator is precalculated
+	std::FILE* cacheFile = nullptr;
+	bool cacheFileWriteOk = false;
+
 	//IPathFinder* parentPathFinder; // parent (PF if BLOCK_SIZE is 16, PE[16] if 32)
     PathingState* nextPathState = nullptr;
 
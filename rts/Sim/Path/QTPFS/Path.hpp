@@ -18,6 +18,9 @@ namespace QTPFS {
 			nextPointIndex = 0;
 			numPathUpdates = 0;
 
+			firstDeadSegment = -1u;
+			lastDeadSegment  = 0;
+
 			hash   = -1u;
 			radius = 0.0f;
 			synced = true;
@@ -31,11 +34,17 @@ namespace QTPFS {
 			nextPointIndex = p.GetNextPointIndex();
 			numPathUpdates = p.GetNumPathUpdates();
 
+			firstDeadSegment = p.firstDeadSegment;
+			lastDeadSegment  = p.lastDeadSegment;
+
 			hash   = p.GetHash();
 			radius = p.GetRadius();
 			synced = p.GetSynced();
 			points = p.GetPoints();
 
+			repairPrefix = p.repairPrefix;
+			repairSuffix = p.repairSuffix;
+
 			boundingBoxMins = p.GetBoundingBoxMins();
 			boundingBoxMaxs = p.GetBoundingBoxMaxs();
 
@@ -44,6 +53,47 @@ namespace QTPFS {
 		}
 		~IPath() { points.clear(); }
 
+		// range of segments invalidated by terrain changes while the path was live
+		void AddDeadSegments(unsigned int first, unsigned int last) {
+			firstDeadSegment = std::min(firstDeadSegment, first);
+			lastDeadSegment  = std::max(lastDeadSegment, last);
+		}
+		bool HasDeadSegments() const { return (firstDeadSegment <= lastDeadSegment); }
+		unsigned int GetFirstDeadSegment() const { return firstDeadSegment; }
+		unsigned int GetLastDeadSegment() const { return lastDeadSegment; }
+
+		// still-valid waypoints of a dead path before and after the
+		// segment being searched again; spliced back in on success
+		void SetRepairPoints(std::vector<float3>&& prefix, std::vector<float3>&& suffix) {
+			repairPrefix = std::move(prefix);
+			repairSuffix = std::move(suffix);
+		}
+		void SpliceRepairPoints() {
+			if (!HasRepairPoints())
+				return;
+
+			repairPrefix.insert(repairPrefix.end(), points.begin(), points.end());
+			repairPrefix.insert(repairPrefix.end(), repairSuffix.begin(), repairSuffix.end());
+
+			points.swap(repairPrefix);
+			repairPrefix.clear();
+			repairSuffix.clear();
+		}
+		// turns a pending repair into a search over the whole remaining path
+		void DiscardRepairPoints() {
+			if (!repairPrefix.empty())
+				SetSourcePoint(repairPrefix.front());
+			if (!repairSuffix.empty())
+				SetTargetPoint(repairSuffix.back());
+
+			repairPrefix.clear();
+			repairSuffix.clear();
+		}
+		bool HasRepairPoints() const { return (!repairPrefix.empty() || !repairSuffix.empty()); }
+
+		const std::vector<float3>& GetRepairPrefix() const { return repairPrefix; }
+		const std::vector<float3>& GetRepairSuffix() const { return repairSuffix; }
+
 		void SetID(unsigned int pathID) { this->pathID = pathID; }
 		unsigned int GetID() const { return pathID; }
 
@@ -107,12 +157,18 @@ namespace QTPFS {
 		unsigned int nextPointIndex; // index of the next waypoint to be visited
 		unsigned int numPathUpdates; // number of times this path was invalidated
 
+		unsigned int firstDeadSegment;
+		unsigned int lastDeadSegment;
+
 		std::uint64_t hash;
 		float radius;
 		bool synced;
 
 		std::vector<float3> points;
 
+		std::vector<float3> repairPrefix;
+		std::vector<float3> repairSuffix;
+
 		// corners of the bounding-box containing all our points
 		float3 boundingBoxMins;
 		float3 boundingBoxMaxs;
@@ -117,12 +117,106 @@ void QTPFS::PathCache::DelPath(unsigned int pathID) {
 
 
 
+static bool SegmentCrossesRectangle(
+	const SRectangle& r,
+	const CollisionVolume& rv,
+	const float3& rm,
+	const float3& p0,
+	const float3& p1
+) {
+	const bool p0InRect =
+		((p0.x >= (r.x1 * SQUARE_SIZE) && p0.x < (r.x2 * SQUARE_SIZE)) &&
+		 (p0.z >= (r.z1 * SQUARE_SIZE) && p0.z < (r.z2 * SQUARE_SIZE)));
+	const bool p1InRect =
+		((p1.x >= (r.x1 * SQUARE_SIZE) && p1.x < (r.x2 * SQUARE_SIZE)) &&
+		 (p1.z >= (r.z1 * SQUARE_SIZE) && p1.z < (r.z2 * SQUARE_SIZE)));
+	const bool havePointInRect = (p0InRect || p1InRect);
+
+	// NOTE:
+	//     box-volume tests in its own space, but points are
+	//     in world-space so we must inv-transform them first
+	//     (p0 --> p0 - rm, p1 --> p1 - rm)
+	const bool
+		xRangeInRect = (p0.x >= (r.x1 * SQUARE_SIZE) && p1.x <  (r.x2 * SQUARE_SIZE)),
+		xRangeExRect = (p0.x <  (r.x1 * SQUARE_SIZE) && p1.x >= (r.x2 * SQUARE_SIZE)),
+		zRangeInRect = (p0.z >= (r.z1 * SQUARE_SIZE) && p1.z <  (r.z2 * SQUARE_SIZE)),
+		zRangeExRect = (p0.z <  (r.z1 * SQUARE_SIZE) && p1.z >= (r.z2 * SQUARE_SIZE));
+	const bool edgeCrossesRect =
+		(xRangeExRect && zRangeInRect) ||
+		(xRangeInRect && zRangeExRect) ||
+		CCollisionHandler::IntersectBox(&rv, p0 - rm, p1 - rm, NULL);
+
+	return (havePointInRect || edgeCrossesRect);
+}
+
+static bool PathCrossesRectangle(
+	const SRectangle& r,
+	const CollisionVolume& rv,
+	const float3& rm,
+	QTPFS::IPath* path
+) {
+	const float3& pathMins = path->GetBoundingBoxMins();
+	const float3& pathMaxs = path->GetBoundingBoxMaxs();
+
+	// if rectangle does not overlap bounding-box, skip this path
+	if ((r.x2 * SQUARE_SIZE) < pathMins.x) { return false; }
+	if ((r.z2 * SQUARE_SIZE) < pathMins.z) { return false; }
+	if ((r.x1 * SQUARE_SIZE) > pathMaxs.x) { return false; }
+	if ((r.z1 * SQUARE_SIZE) > pathMaxs.z) { return false; }
+
+	// figure out if <path> has at least one edge crossing <r>
+	// we only care about the segments we have not yet visited
+	const unsigned int minIdx = std::max(path->GetNextPointIndex(), 2U) - 2;
+	const unsigned int maxIdx = std::max(path->NumPoints(), 1u) - 1;
+
+	for (unsigned int i = minIdx; i < maxIdx; i++) {
+		if (!SegmentCrossesRectangle(r, rv, rm, path->GetPoint(i), path->GetPoint(i + 1)))
+			continue;
+
+		#ifdef QTPFS_REPAIR_DEAD_PATHS
+		// the last crossing segment bounds the part that has to be searched again
+		for (unsigned int j = maxIdx - 1; j >= i; j--) {
+			if (SegmentCrossesRectangle(r, rv, rm, path->GetPoint(j), path->GetPoint(j + 1))) {
+				path->AddDeadSegments(i, j);
+				break;
+			}
+		}
+		#endif
+
+		return true;
+	}
+
+	return false;
+}
+
+static bool RepairPointsCrossRectangle(
+	const SRectangle& r,
+	const CollisionVolume& rv,
+	const float3& rm,
+	const QTPFS::IPath* path
+) {
+	const std::vector<float3>& prefix = path->GetRepairPrefix();
+	const std::vector<float3>& suffix = path->GetRepairSuffix();
+
+	// the joints to the searched segment count as well
+	for (size_t i = 0; i < prefix.size(); i++) {
+		if (SegmentCrossesRectangle(r, rv, rm, prefix[i], (i + 1 < prefix.size())? prefix[i + 1]: path->GetSourcePoint()))
+			return true;
+	}
+	for (size_t i = 0; i < suffix.size(); i++) {
+		if (SegmentCrossesRectangle(r, rv, rm, (i == 0)? path->GetTargetPoint(): suffix[i - 1], suffix[i]))
+			return true;
+	}
+
+	return false;
+}
+
 bool QTPFS::PathCache::MarkDeadPaths(const SRectangle& r) {
 	#ifdef QTPFS_IGNORE_DEAD_PATHS
 	return false;
 	#endif
 
-	if (livePaths.empty())
+	if (livePaths.empty() && deadPaths.empty() && tempPaths.empty())
 		return false;
 
 	// NOTE: not static, we run in multiple threads
@@ -140,60 +234,39 @@ bool QTPFS::PathCache::MarkDeadPaths(const SRectangle& r) {
 	for (PathMapIt it = livePaths.begin(); it != livePaths.end(); ++it) {
 		IPath* path = it->second;
 
-		const float3& pathMins = path->GetBoundingBoxMins();
-		const float3& pathMaxs = path->GetBoundingBoxMaxs();
-
-		// if rectangle does not overlap bounding-box, skip this path
-		if ((r.x2 * SQUARE_SIZE) < pathMins.x) { continue; }
-		if ((r.z2 * SQUARE_SIZE) < pathMins.z) { continue; }
-		if ((r.x1 * SQUARE_SIZE) > pathMaxs.x) { continue; }
-		if ((r.z1 * SQUARE_SIZE) > pathMaxs.z) { continue; }
-
-		// figure out if <path> has at least one edge crossing <r>
-		// we only care about the segments we have not yet visited
-		const unsigned int minIdx = std::max(path->GetNextPointIndex(), 2U) - 2;
-		const unsigned int maxIdx = std::max(path->NumPoints(), 1u) - 1;
-
-		for (unsigned int i = minIdx; i < maxIdx; i++) {
-			const float3& p0 = path->GetPoint(i    );
-			const float3& p1 = path->GetPoint(i + 1);
-
-			const bool p0InRect =
-				((p0.x >= (r.x1 * SQUARE_SIZE) && p0.x < (r.x2 * SQUARE_SIZE)) &&
-				 (p0.z >= (r.z1 * SQUARE_SIZE) && p0.z < (r.z2 * SQUARE_SIZE)));
-			const bool p1InRect =
-				((p1.x >= (r.x1 * SQUARE_SIZE) && p1.x < (r.x2 * SQUARE_SIZE)) &&
-				 (p1.z >= (r.z1 * SQUARE_SIZE) && p1.z < (r.z2 * SQUARE_SIZE)));
-			const bool havePointInRect = (p0InRect || p1InRect);
-
-			// NOTE:
-			//     box-volume tests in its own space, but points are
-			//     in world-space so we must inv-transform them first
-			//     (p0 --> p0 - rm, p1 --> p1 - rm)
-			const bool
-				xRangeInRect = (p0.x >= (r.x1 * SQUARE_SIZE) && p1.x <  (r.x2 * SQUARE_SIZE)),
-				xRangeExRect = (p0.x <  (r.x1 * SQUARE_SIZE) && p1.x >= (r.x2 * SQUARE_SIZE)),
-				zRangeInRect = (p0.z >= (r.z1 * SQUARE_SIZE) && p1.z <  (r.z2 * SQUARE_SIZE)),
-				zRangeExRect = (p0.z <  (r.z1 * SQUARE_SIZE) && p1.z >= (r.z2 * SQUARE_SIZE));
-			const bool edgeCrossesRect =
-				(xRangeExRect && zRangeInRect) ||
-				(xRangeInRect && zRangeExRect) ||
-				CCollisionHandler::IntersectBox(&rv, p0 - rm, p1 - rm, NULL);
-
-			// remember the ID of each path affected by the deformation
-			if (havePointInRect || edgeCrossesRect) {
-				assert(tempPaths.find(path->GetID()) == tempPaths.end());
-				deadPaths.insert(std::pair<unsigned int, IPath*>(path->GetID(), path));
-				livePathIts.push_back(it);
-				break;
-			}
-		}
+		if (!PathCrossesRectangle(r, rv, rm, path))
+			continue;
+
+		// remember the ID of each path affected by the deformation
+		assert(tempPaths.find(path->GetID()) == tempPaths.end());
+		deadPaths.insert(std::pair<unsigned int, IPath*>(path->GetID(), path));
+		livePathIts.push_back(it);
 	}
 
 	for (auto it = livePathIts.begin(); it != livePathIts.end(); ++it) {
 		livePaths.erase(*it);
 	}
 
+	#ifdef QTPFS_REPAIR_DEAD_PATHS
+	// paths killed by an earlier change in the same frame must also
+	// account for this one, or their kept segments might cross it
+	for (const auto& pair: deadPaths) {
+		PathCrossesRectangle(r, rv, rm, pair.second);
+	}
+
+	// repairs still waiting for their search keep segments which might now be invalid
+	for (const auto& pair: tempPaths) {
+		IPath* path = pair.second;
+
+		if (!path->HasRepairPoints())
+			continue;
+		if (!RepairPointsCrossRectangle(r, rv, rm, path))
+			continue;
+
+		path->DiscardRepairPoints();
+	}
+	#endif
+
 	return true;
 }
 
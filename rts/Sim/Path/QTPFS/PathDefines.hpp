@@ -15,6 +15,8 @@
 // #define QTPFS_OPENMP_ENABLED
 // #define QTPFS_ORTHOPROJECTED_EDGE_TRANSITIONS
 #define QTPFS_STAGGERED_LAYER_UPDATES
+#define QTPFS_REPAIR_DEAD_PATHS
+#define QTPFS_GROUP_PATH_SEARCHES
 //
 // #define QTPFS_VIRTUAL_NODE_FUNCTIONS
 // #define QTPFS_ENABLE_THREADED_UPDATE
@@ -23,6 +25,7 @@
 // #define QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 
 #define QTPFS_MAX_SMOOTHING_ITERATIONS 8
+#define QTPFS_MIN_GROUP_SEARCH_SIZE 4
 
 #define QTPFS_MAX_NETPOINTS_PER_NODE_EDGE 3
 #define QTPFS_NETPOINT_EDGE_SPACING_SCALE (1.0f / (QTPFS_MAX_NETPOINTS_PER_NODE_EDGE + 1))
@@ -143,13 +143,15 @@ QTPFS::PathManager::~PathManager() {
 	// nodeLayers.clear();
 	pathCaches.clear();
 	pathSearches.clear();
+	searchBatches.clear();
+	searchStateOffsets.clear();
 	pathTypes.clear();
 	pathTraces.clear();
 
 	numCurrExecutedSearches.clear();
 	numPrevExecutedSearches.clear();
 
-	PathSearch::FreeGlobalQueue();
+	PathSearch::FreeGlobalQueues();
 
 	#ifdef QTPFS_ENABLE_THREADED_UPDATE
 	// at this point the thread is waiting, so notify it
@@ -186,8 +188,6 @@ void QTPFS::PathManager::InitStatic() {
 }
 
 void QTPFS::PathManager::Load() {
-	// NOTE: offset *must* start at a non-zero value
-	searchStateOffset = NODE_STATE_OFFSET;
 	numTerrainChanges = 0;
 	numPathRequests   = 0;
 	maxNumLeafNodes   = 0;
@@ -196,6 +196,9 @@ void QTPFS::PathManager::Load() {
 	nodeLayers.resize(moveDefHandler.GetNumMoveDefs());
 	pathCaches.resize(moveDefHandler.GetNumMoveDefs());
 	pathSearches.resize(moveDefHandler.GetNumMoveDefs());
+	searchBatches.resize(moveDefHandler.GetNumMoveDefs());
+	// NOTE: offsets *must* start at a non-zero value
+	searchStateOffsets.resize(moveDefHandler.GetNumMoveDefs(), NODE_STATE_OFFSET);
 
 	// add one extra element for object-less requests
 	numCurrExecutedSearches.resize(teamHandler.ActiveTeams() + 1, 0);
@@ -248,7 +251,7 @@ void QTPFS::PathManager::Load() {
 
 		{ SyncedUint tmp(pfsCheckSum); }
 
-		PathSearch::InitGlobalQueue(maxNumLeafNodes);
+		PathSearch::InitGlobalQueues(maxNumLeafNodes);
 	}
 
 	{
@@ -435,7 +438,7 @@ void QTPFS::PathManager::UpdateNodeLayer(unsigned int layerNum, const SRectangle
 
 	// NOTE:
 	//     this is needed for IsBlocked* --> SquareIsBlocked --> IsNonBlocking
-	//     but no point doing it in ExecuteSearch because the IsBlocked* calls
+	//     but no point doing it in ExecuteSelectedSearches because the IsBlocked* calls
 	//     are only made from NodeLayer::Update and also no point doing it here
 	//     since we are independent of a specific path --> requires redesign
 	//
@@ -711,19 +714,28 @@ void QTPFS::PathManager::ThreadUpdate() {
 		static unsigned int minPathTypeUpdate = 0;
 		static unsigned int maxPathTypeUpdate = numPathTypeUpdates;
 
-		sharedPaths.clear();
-
 		for (unsigned int pathTypeUpdate = minPathTypeUpdate; pathTypeUpdate < maxPathTypeUpdate; pathTypeUpdate++) {
 			#ifndef QTPFS_IGNORE_DEAD_PATHS
 			QueueDeadPathSearches(pathTypeUpdate);
 			#endif
 
 			#ifdef QTPFS_STAGGERED_LAYER_UPDATES
-			// NOTE: *must* be called between QueueDeadPathSearches and ExecuteQueuedSearches
+			// NOTE: *must* be called between QueueDeadPathSearches and SelectQueuedSearches
 			ExecQueuedNodeLayerUpdates(pathTypeUpdate, !pathSearches[pathTypeUpdate].empty());
 			#endif
 
-			ExecuteQueuedSearches(pathTypeUpdate);
+			SelectQueuedSearches(pathTypeUpdate);
+		}
+
+		// searches only touch the nodes and path-cache of their own layer, so
+		// the layers can be processed concurrently; results are committed in
+		// layer order afterwards to keep everything outside them deterministic
+		for_mt(minPathTypeUpdate, maxPathTypeUpdate, [this](const int pathType) {
+			ExecuteSelectedSearches(pathType);
+		});
+
+		for (unsigned int pathTypeUpdate = minPathTypeUpdate; pathTypeUpdate < maxPathTypeUpdate; pathTypeUpdate++) {
+			CommitSelectedSearches(pathTypeUpdate);
 		}
 
 		std::copy(numCurrExecutedSearches.begin(), numCurrExecutedSearches.end(), numPrevExecutedSearches.begin());
@@ -748,66 +760,56 @@ void QTPFS::PathManager::ThreadUpdate() {
 
 
 
-void QTPFS::PathManager::ExecuteQueuedSearches(unsigned int pathType) {
+void QTPFS::PathManager::SelectQueuedSearches(unsigned int pathType) {
 	NodeLayer& nodeLayer = nodeLayers[pathType];
 	PathCache& pathCache = pathCaches[pathType];
 
-	std::vector<IPathSearch*>& searches = pathSearches[pathType];
-	std::vector<IPathSearch*>::iterator searchesIt = searches.begin();
+	PathSearchVect& searches = pathSearches[pathType];
+	PathSearchVectIt searchesIt = searches.begin();
 
-	if (!searches.empty()) {
-		// execute pending searches collected via
-		// RequestPath and QueueDeadPathSearches
-		while (searchesIt != searches.end()) {
-			if (ExecuteSearch(searches, searchesIt, nodeLayer, pathCache, pathType)) {
-				searchStateOffset += NODE_STATE_OFFSET;
-			}
-		}
-	}
-}
+	std::vector<SearchBatchItem>& batch = searchBatches[pathType];
 
-bool QTPFS::PathManager::ExecuteSearch(
-	PathSearchVect& searches,
-	PathSearchVectIt& searchesIt,
-	NodeLayer& nodeLayer,
-	PathCache& pathCache,
-	unsigned int pathType
-) {
-	IPathSearch* search = *searchesIt;
-	IPath* path = pathCache.GetTempPath(search->GetID());
-
-	assert(search != nullptr);
-	assert(path != nullptr);
-
-	const auto DeleteSearch = [](IPathSearch* s, PathSearchVect& v, PathSearchVectIt& it) {
+	const auto TakeSearch = [](PathSearchVect& v, PathSearchVectIt& it) {
 		// ordering of still-queued searches is not relevant
 		*it = v.back();
 		v.pop_back();
-		delete s;
 	};
 
-	// temp-path might have been removed already via
-	// DeletePath before we got a chance to process it
-	if (path->GetID() == 0) {
-		DeleteSearch(search, searches, searchesIt);
-		return false;
-	}
+	sharedSearches.clear();
+	groupSearches.clear();
 
-	assert(search->GetID() != 0);
-	assert(path->GetID() == search->GetID());
+	// select pending searches collected via RequestPath and
+	// QueueDeadPathSearches for execution during this update
+	while (searchesIt != searches.end()) {
+		IPathSearch* search = *searchesIt;
+		IPath* path = pathCache.GetTempPath(search->GetID());
 
-	search->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), MAP_RECTANGLE);
-	path->SetHash(search->GetHash(mapDims.mapx * mapDims.mapy, pathType));
+		assert(search != nullptr);
+		assert(path != nullptr);
 
-	{
-		#ifdef QTPFS_SEARCH_SHARED_PATHS
-		SharedPathMap::const_iterator sharedPathsIt = sharedPaths.find(path->GetHash());
+		// temp-path might have been removed already via
+		// DeletePath before we got a chance to process it
+		if (path->GetID() == 0) {
+			TakeSearch(searches, searchesIt);
+			delete search;
+			continue;
+		}
 
-		if (sharedPathsIt != sharedPaths.end()) {
-			if (search->SharedFinalize(sharedPathsIt->second, path)) {
-				DeleteSearch(search, searches, searchesIt);
-				return false;
-			}
+		assert(search->GetID() != 0);
+		assert(path->GetID() == search->GetID());
+
+		search->Initialize(&nodeLayer, &pathCache, path->GetSourcePoint(), path->GetTargetPoint(), MAP_RECTANGLE);
+		path->SetHash(search->GetHash(mapDims.mapx * mapDims.mapy, pathType));
+
+		#ifdef QTPFS_SEARCH_SHARED_PATHS
+		// partial repairs splice their own waypoints into the result and can not share it
+		const auto sharedSearchesIt = path->HasRepairPoints()? sharedSearches.end(): sharedSearches.find(path->GetHash());
+
+		if (sharedSearchesIt != sharedSearches.end()) {
+			// can reuse the result of an identical search selected earlier
+			batch.push_back({search, path, static_cast<int>(sharedSearchesIt->second), -1, -1, false});
+			TakeSearch(searches, searchesIt);
+			continue;
 		}
 		#endif
 
@@ -816,30 +818,126 @@ bool QTPFS::PathManager::ExecuteSearch(
 		const unsigned int numPrevSearches = numPrevExecutedSearches[search->GetTeam()];
 
 		if ((numCurrSearches - numPrevSearches) >= MAX_TEAM_SEARCHES) {
-			++searchesIt; return false;
+			++searchesIt; continue;
 		}
 
 		numCurrExecutedSearches[search->GetTeam()] += 1;
 		#endif
-	}
 
-	// removes path from temp-paths, adds it to live-paths
-	if (search->Execute(searchStateOffset, numTerrainChanges)) {
-		search->Finalize(path);
+		if (!path->HasRepairPoints())
+			sharedSearches[path->GetHash()] = batch.size();
 
-		#ifdef QTPFS_SEARCH_SHARED_PATHS
-		sharedPaths[path->GetHash()] = path;
+		batch.push_back({search, path, -1, static_cast<int>(batch.size()), -1, false});
+
+		#ifdef QTPFS_GROUP_PATH_SEARCHES
+		// chain searches towards the same target node, see ExecuteSelectedSearches
+		const auto groupSearchesIt = groupSearches.find(search->GetGroupHash(mapDims.mapx * mapDims.mapy, pathType));
+
+		if (groupSearchesIt != groupSearches.end()) {
+			SearchBatchItem& prevItem = batch[groupSearchesIt->second];
+
+			batch.back().groupIndex = prevItem.groupIndex;
+			prevItem.groupNextIndex = batch.size() - 1;
+		}
+
+		groupSearches[search->GetGroupHash(mapDims.mapx * mapDims.mapy, pathType)] = batch.size() - 1;
 		#endif
+		TakeSearch(searches, searchesIt);
+	}
+}
+
+void QTPFS::PathManager::ExecuteSelectedSearches(unsigned int pathType) {
+	unsigned int& searchStateOffset = searchStateOffsets[pathType];
+
+	#ifdef QTPFS_GROUP_PATH_SEARCHES
+	std::vector<SearchBatchItem>& batch = searchBatches[pathType];
+	std::vector<IPathSearch*> groupMembers;
+
+	// large groups of searches towards the same target node (as issued
+	// by a move order given to many units) are run as a single search
+	// from the target to all their sources; this has to be followed by
+	// finalizing the members before another search overwrites the nodes
+	for (size_t i = 0; i < batch.size(); i++) {
+		if (batch[i].groupIndex != static_cast<int>(i))
+			continue;
+
+		groupMembers.clear();
+
+		for (int j = i; j >= 0; j = batch[j].groupNextIndex) {
+			groupMembers.push_back(batch[j].search);
+		}
 
-		#ifdef QTPFS_TRACE_PATH_SEARCHES
-		pathTraces[path->GetID()] = search->GetExecutionTrace();
+		if (groupMembers.size() < QTPFS_MIN_GROUP_SEARCH_SIZE)
+			continue;
+
+		batch[i].search->ExecuteGroup(groupMembers, searchStateOffset, numTerrainChanges);
+		searchStateOffset += NODE_STATE_OFFSET;
+
+		for (int j = i; j >= 0; j = batch[j].groupNextIndex) {
+			batch[j].executed = batch[j].search->GroupFinalize(batch[j].path);
+		}
+	}
+	#endif
+
+	for (SearchBatchItem& item: searchBatches[pathType]) {
+		if (item.sharedIndex >= 0)
+			continue;
+		// members of a group search that were not reached fall back to their own
+		if (item.executed)
+			continue;
+
+		item.executed = item.search->Execute(searchStateOffset, numTerrainChanges);
+		searchStateOffset += NODE_STATE_OFFSET;
+
+		#ifdef QTPFS_REPAIR_DEAD_PATHS
+		// the repaired segment can no longer be bridged (partial result), so
+		// drop the kept waypoints and search the whole remaining path again
+		if (item.executed && item.path->HasRepairPoints() && !item.search->HaveFullPath()) {
+			item.path->DiscardRepairPoints();
+			item.search->Initialize(&nodeLayers[pathType], &pathCaches[pathType], item.path->GetSourcePoint(), item.path->GetTargetPoint(), MAP_RECTANGLE);
+			item.path->SetHash(item.search->GetHash(mapDims.mapx * mapDims.mapy, pathType));
+
+			item.executed = item.search->Execute(searchStateOffset, numTerrainChanges);
+			searchStateOffset += NODE_STATE_OFFSET;
+		}
 		#endif
-	} else {
-		DeletePath(path->GetID());
+
+		// removes path from temp-paths, adds it to live-paths
+		if (item.executed)
+			item.search->Finalize(item.path);
 	}
+}
 
-	DeleteSearch(search, searches, searchesIt);
-	return true;
+void QTPFS::PathManager::CommitSelectedSearches(unsigned int pathType) {
+	std::vector<SearchBatchItem>& batch = searchBatches[pathType];
+
+	for (SearchBatchItem& item: batch) {
+		if (item.sharedIndex < 0) {
+			if (item.executed) {
+				#ifdef QTPFS_TRACE_PATH_SEARCHES
+				pathTraces[item.path->GetID()] = item.search->GetExecutionTrace();
+				#endif
+			} else {
+				DeletePath(item.path->GetID());
+			}
+
+			delete item.search;
+			continue;
+		}
+
+		// items sharing a result always come after the one they share it with
+		const SearchBatchItem& sharedItem = batch[item.sharedIndex];
+
+		if (sharedItem.executed && item.search->SharedFinalize(sharedItem.path, item.path)) {
+			delete item.search;
+			continue;
+		}
+
+		// nothing to share, search again during the next update of this layer
+		pathSearches[pathType].push_back(item.search);
+	}
+
+	batch.clear();
 }
 
 void QTPFS::PathManager::QueueDeadPathSearches(unsigned int pathType) {
@@ -882,7 +980,7 @@ unsigned int QTPFS::PathManager::QueueSearch(
 	//     the path-owner object handed to us can never become
 	//     dangling (even with delayed execution) because ~GMT
 	//     calls DeletePath, which ensures any path is removed
-	//     from its cache before we get to ExecuteSearch
+	//     from its cache before we get to SelectQueuedSearches
 	IPath* newPath = new IPath();
 	IPathSearch* newSearch = new PathSearch(PATH_SEARCH_ASTAR);
 
@@ -913,6 +1011,42 @@ unsigned int QTPFS::PathManager::QueueSearch(
 		newPath->SetOwner(oldPath->GetOwner());
 		newPath->SetSourcePoint(pos);
 		newPath->SetTargetPoint(oldPath->GetTargetPoint());
+
+		#ifdef QTPFS_REPAIR_DEAD_PATHS
+		// only search again between the waypoints bounding the
+		// invalidated segments, the remainder is kept as it was
+		if (oldPath->HasDeadSegments()) {
+			const unsigned int numPoints = oldPath->NumPoints();
+			const unsigned int nextIndex = std::max(oldPath->GetNextPointIndex(), 1u);
+			const unsigned int headIndex = oldPath->GetFirstDeadSegment();
+			const unsigned int tailIndex = oldPath->GetLastDeadSegment() + 1;
+
+			std::vector<float3> prefix;
+			std::vector<float3> suffix;
+
+			if (headIndex >= nextIndex && headIndex < numPoints) {
+				prefix.reserve(headIndex - nextIndex + 1);
+				prefix.push_back(pos);
+
+				for (unsigned int i = nextIndex; i < headIndex; i++) {
+					prefix.push_back(oldPath->GetPoint(i));
+				}
+
+				newPath->SetSourcePoint(oldPath->GetPoint(headIndex));
+			}
+			if ((tailIndex + 1) < numPoints) {
+				suffix.reserve(numPoints - tailIndex - 1);
+
+				for (unsigned int i = tailIndex + 1; i < numPoints; i++) {
+					suffix.push_back(oldPath->GetPoint(i));
+				}
+
+				newPath->SetTargetPoint(oldPath->GetPoint(tailIndex));
+			}
+
+			newPath->SetRepairPoints(std::move(prefix), std::move(suffix));
+		}
+		#endif
 		newSearch->SetID(oldPath->GetID());
 		newSearch->SetTeam(teamHandler.ActiveTeams());
 	} else {
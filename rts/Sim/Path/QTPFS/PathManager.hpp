@@ -93,8 +93,7 @@ namespace QTPFS {
 		typedef spring::unordered_map<unsigned int, unsigned int>::iterator PathTypeMapIt;
 		typedef spring::unordered_map<unsigned int, PathSearchTrace::Execution*> PathTraceMap;
 		typedef spring::unordered_map<unsigned int, PathSearchTrace::Execution*>::iterator PathTraceMapIt;
-		typedef spring::unordered_map<std::uint64_t, IPath*> SharedPathMap;
-		typedef spring::unordered_map<std::uint64_t, IPath*>::iterator SharedPathMapIt;
+		typedef spring::unordered_map<std::uint64_t, unsigned int> SharedSearchMap;
 
 		typedef std::vector<IPathSearch*> PathSearchVect;
 		typedef std::vector<IPathSearch*>::iterator PathSearchVectIt;
@@ -121,7 +120,9 @@ namespace QTPFS {
 		void ExecQueuedNodeLayerUpdates(unsigned int layerNum, bool flushQueue);
 		#endif
 
-		void ExecuteQueuedSearches(unsigned int pathType);
+		void SelectQueuedSearches(unsigned int pathType);
+		void ExecuteSelectedSearches(unsigned int pathType);
+		void CommitSelectedSearches(unsigned int pathType);
 		void QueueDeadPathSearches(unsigned int pathType);
 
 		unsigned int QueueSearch(
@@ -134,14 +135,6 @@ namespace QTPFS {
 			const bool synced
 		);
 
-		bool ExecuteSearch(
-			PathSearchVect& searches,
-			PathSearchVectIt& searchesIt,
-			NodeLayer& nodeLayer,
-			PathCache& pathCache,
-			unsigned int pathType
-		);
-
 		bool IsFinalized() const { return (!nodeTrees.empty()); }
 
 
@@ -153,11 +146,28 @@ namespace QTPFS {
 		static std::vector<PathCache> pathCaches;
 		static std::vector< std::vector<IPathSearch*> > pathSearches;
 
+		struct SearchBatchItem {
+			IPathSearch* search;
+			IPath* path;
+
+			// index of the item whose result this search can share, or -1
+			int sharedIndex;
+			// indices of the first and next item searching towards the same target node, or -1
+			int groupIndex;
+			int groupNextIndex;
+			bool executed;
+		};
+
+		// searches selected for execution during the current update, per layer
+		std::vector< std::vector<SearchBatchItem> > searchBatches;
+
 		spring::unordered_map<unsigned int, unsigned int> pathTypes;
 		spring::unordered_map<unsigned int, PathSearchTrace::Execution*> pathTraces;
 
-		// maps "hashes" of executed searches to the found paths
-		spring::unordered_map<std::uint64_t, IPath*> sharedPaths;
+		// maps "hashes" of selected searches to their batch indices
+		SharedSearchMap sharedSearches;
+		// maps target nodes of selected searches to the last batch index searching towards them
+		SharedSearchMap groupSearches;
 
 		std::vector<unsigned int> numCurrExecutedSearches;
 		std::vector<unsigned int> numPrevExecutedSearches;
@@ -165,7 +175,9 @@ namespace QTPFS {
 		static unsigned int LAYERS_PER_UPDATE;
 		static unsigned int MAX_TEAM_SEARCHES;
 
-		unsigned int searchStateOffset;
+		// per layer, searches on different layers never share nodes
+		std::vector<unsigned int> searchStateOffsets;
+
 		unsigned int numTerrainChanges;
 		unsigned int numPathRequests;
 		unsigned int maxNumLeafNodes;
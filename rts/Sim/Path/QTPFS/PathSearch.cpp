@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 
@@ -14,8 +15,24 @@
 #endif
 
 #include "System/float3.h"
+#include "System/Threading/ThreadPool.h"
 
-QTPFS::binary_heap<QTPFS::INode*> QTPFS::PathSearch::openNodes;
+std::vector< QTPFS::binary_heap<QTPFS::INode*> > QTPFS::PathSearch::threadOpenNodes;
+
+
+void QTPFS::PathSearch::InitGlobalQueues(unsigned int n) {
+	// indexed by thread number, which for the auxiliary thread lies past GetMaxThreads
+	threadOpenNodes.resize(ThreadPool::MAX_THREADS);
+
+	// only pool threads get a full-size queue, the others grow on demand
+	for (size_t i = 0; i < threadOpenNodes.size(); i++) {
+		threadOpenNodes[i].reserve((i < size_t(ThreadPool::GetMaxThreads()))? n: std::min(n, 1024u));
+	}
+}
+
+void QTPFS::PathSearch::FreeGlobalQueues() {
+	threadOpenNodes.clear();
+}
 
 
 
@@ -29,6 +46,9 @@ void QTPFS::PathSearch::Initialize(
 	srcPoint = sourcePoint; srcPoint.ClampInBounds();
 	tgtPoint = targetPoint; tgtPoint.ClampInBounds();
 
+	goalMins = tgtPoint;
+	goalMaxs = tgtPoint;
+
 	nodeLayer = layer;
 	pathCache = cache;
 
@@ -49,6 +69,9 @@ bool QTPFS::PathSearch::Execute(
 	searchState = searchStateOffset; // starts at NODE_STATE_OFFSET
 	searchMagic = searchMagicNumber; // starts at numTerrainChanges
 
+	// searches on different layers may run concurrently, each uses its thread's queue
+	openNodes = &threadOpenNodes[ThreadPool::GetThreadNum()];
+
 	haveFullPath = (srcNode == tgtNode);
 	havePartPath = false;
 
@@ -78,10 +101,10 @@ bool QTPFS::PathSearch::Execute(
 	if (srcNode->GetMoveCost() == QTPFS_POSITIVE_INFINITY)
 		srcNode->SetMoveCost(0.0f);
 
-	ResetState(srcNode);
+	ResetState(srcNode, srcPoint);
 	UpdateNode(srcNode, nullptr, 0);
 
-	while (!openNodes.empty()) {
+	while (!openNodes->empty()) {
 		IterateNodes(nodeLayer->GetNodes());
 
 		#ifdef QTPFS_TRACE_PATH_SEARCHES
@@ -93,7 +116,7 @@ bool QTPFS::PathSearch::Execute(
 		havePartPath = (minNode != srcNode);
 
 		if (haveFullPath)
-			openNodes.reset();
+			openNodes->reset();
 	}
 
 	if (srcNode->GetMoveCost() == 0.0f)
@@ -118,12 +141,12 @@ bool QTPFS::PathSearch::Execute(
 
 
 
-void QTPFS::PathSearch::ResetState(INode* node) {
-	// will be copied into srcNode by UpdateNode()
-	netPoints[0] = {srcPoint.x, srcPoint.z};
+void QTPFS::PathSearch::ResetState(INode* node, const float3& point) {
+	// will be copied into node by UpdateNode()
+	netPoints[0] = {point.x, point.z};
 
 	gDists[0] = 0.0f;
-	hDists[0] = srcPoint.distance(tgtPoint);
+	hDists[0] = GetHeuristicDist(point);
 	gCosts[0] = 0.0f;
 	hCosts[0] = hDists[0] * hCostMult;
 
@@ -136,8 +159,8 @@ void QTPFS::PathSearch::ResetState(INode* node) {
 		hCosts[i] = 0.0f;
 	}
 
-	openNodes.reset();
-	openNodes.push(node);
+	openNodes->reset();
+	openNodes->push(node);
 }
 
 void QTPFS::PathSearch::UpdateNode(INode* nextNode, INode* prevNode, unsigned int netPointIdx) {
@@ -153,7 +176,7 @@ void QTPFS::PathSearch::UpdateNode(INode* nextNode, INode* prevNode, unsigned in
 }
 
 void QTPFS::PathSearch::IterateNodes(const std::vector<INode*>& allNodes) {
-	curNode = openNodes.top();
+	curNode = openNodes->top();
 	curNode->SetSearchState(searchState | NODE_STATE_CLOSED);
 	#ifdef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 	// in the non-conservative case, this is done from
@@ -161,8 +184,8 @@ void QTPFS::PathSearch::IterateNodes(const std::vector<INode*>& allNodes) {
 	curNode->SetMagicNumber(searchMagic);
 	#endif
 
-	openNodes.pop();
-	openNodes.check_heap_property(0);
+	openNodes->pop();
+	openNodes->check_heap_property(0);
 
 	#ifdef QTPFS_TRACE_PATH_SEARCHES
 	searchIter.SetPoppedNodeIdx(curNode->zmin() * mapDims.mapx + curNode->xmin());
@@ -233,7 +256,7 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const std::vector<INode*>& nxtNodes
 			// cannot use squared-distances because that will bias paths
 			// towards smaller nodes (eg. 1^2 + 1^2 + 1^2 + 1^2 != 4^2)
 			gDists[0] = curPoint.distance({netPoints[0].x, 0.0f, netPoints[0].y});
-			hDists[0] = tgtPoint.distance({netPoints[0].x, 0.0f, netPoints[0].y});
+			hDists[0] = GetHeuristicDist({netPoints[0].x, 0.0f, netPoints[0].y});
 			gCosts[0] =
 				curNode->GetPathCost(NODE_PATH_COST_G) +
 				curNode->GetMoveCost() * gDists[0] +
@@ -251,7 +274,7 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const std::vector<INode*>& nxtNodes
 			netPoints[j] = curNode->GetNeighborEdgeTransitionPoint(1 + i * QTPFS_MAX_NETPOINTS_PER_NODE_EDGE + j);
 
 			gDists[j] = curPoint.distance({netPoints[j].x, 0.0f, netPoints[j].y});
-			hDists[j] = tgtPoint.distance({netPoints[j].x, 0.0f, netPoints[j].y});
+			hDists[j] = GetHeuristicDist({netPoints[j].x, 0.0f, netPoints[j].y});
 			gCosts[j] =
 				curNode->GetPathCost(NODE_PATH_COST_G) +
 				curNode->GetMoveCost() * gDists[j] +
@@ -267,8 +290,8 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const std::vector<INode*>& nxtNodes
 		if (!isCurrent) {
 			UpdateNode(nxtNode, curNode, netPointIdx);
 
-			openNodes.push(nxtNode);
-			openNodes.check_heap_property(0);
+			openNodes->push(nxtNode);
+			openNodes->check_heap_property(0);
 
 			#ifdef QTPFS_TRACE_PATH_SEARCHES
 			searchIter.AddPushedNodeIdx(nxtNode->zmin() * mapDims.mapx + nxtNode->xmin());
@@ -279,7 +302,7 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const std::vector<INode*>& nxtNodes
 		if (gCosts[netPointIdx] >= nxtNode->GetPathCost(NODE_PATH_COST_G))
 			continue;
 		if (isClosed)
-			openNodes.push(nxtNode);
+			openNodes->push(nxtNode);
 
 		UpdateNode(nxtNode, curNode, netPointIdx);
 
@@ -287,8 +310,8 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const std::vector<INode*>& nxtNodes
 		// (changing the f-cost of an OPEN node messes up the
 		// queue's internal consistency; a pushed node remains
 		// OPEN until it gets popped)
-		openNodes.resort(nxtNode);
-		openNodes.check_heap_property(0);
+		openNodes->resort(nxtNode);
+		openNodes->check_heap_property(0);
 	}
 }
 
@@ -299,6 +322,16 @@ void QTPFS::PathSearch::Finalize(IPath* path) {
 	SmoothPath(path);
 	#endif
 
+	#ifdef QTPFS_REPAIR_DEAD_PATHS
+	// a partial result stops short of the kept suffix, splicing it on would cross
+	// whatever blocks the way; PathManager normally re-searches such repairs whole
+	if (haveFullPath) {
+		path->SpliceRepairPoints();
+	} else {
+		path->DiscardRepairPoints();
+	}
+	#endif
+
 	path->SetBoundingBox();
 
 	// path remains in live-cache until DeletePath is called
@@ -362,12 +395,20 @@ void QTPFS::PathSearch::TracePath(IPath* path) {
 	path->SetTargetPoint(tgtPoint);
 }
 
-void QTPFS::PathSearch::SmoothPath(IPath* path) const {
+void QTPFS::PathSearch::SmoothPath(IPath* path) {
 	if (path->NumPoints() == 2)
 		return;
 
 	assert(srcNode->GetPrevNode() == NULL);
 
+	pathNodes.clear();
+
+	for (INode* n = tgtNode; n != srcNode; n = n->GetPrevNode()) {
+		pathNodes.push_back(n);
+	}
+
+	pathNodes.push_back(srcNode);
+
 	for (unsigned int k = 0; k < QTPFS_MAX_SMOOTHING_ITERATIONS; k++) {
 		if (!SmoothPathIter(path)) {
 			// all waypoints stopped moving
@@ -375,15 +416,9 @@ void QTPFS::PathSearch::SmoothPath(IPath* path) const {
 		}
 	}
 
-	INode* n0 = tgtNode;
-	INode* n1 = tgtNode;
-
-	while (n1 != srcNode) {
-		n0 = n1;
-		n1 = n0->GetPrevNode();
-
-		// reset back-pointers
-		n0->SetPrevNode(NULL);
+	// reset back-pointers
+	for (INode* n: pathNodes) {
+		n->SetPrevNode(NULL);
 	}
 }
 
@@ -395,12 +430,10 @@ bool QTPFS::PathSearch::SmoothPathIter(IPath* path) const {
 	unsigned int ni = path->NumPoints();
 	unsigned int nm = 0;
 
-	INode* n0 = tgtNode;
-	INode* n1 = tgtNode;
+	for (size_t k = 1; k < pathNodes.size(); k++) {
+		const INode* n0 = pathNodes[k - 1];
+		const INode* n1 = pathNodes[k    ];
 
-	while (n1 != srcNode) {
-		n0 = n1;
-		n1 = n0->GetPrevNode();
 		ni -= 1;
 
 		assert(n1->GetNeighborRelation(n0) != 0);
@@ -538,6 +571,178 @@ bool QTPFS::PathSearch::SmoothPathIter(IPath* path) const {
 
 
 
+void QTPFS::PathSearch::ExecuteGroup(
+	const std::vector<IPathSearch*>& members,
+	unsigned int searchStateOffset,
+	unsigned int searchMagicNumber
+) {
+	searchState = searchStateOffset;
+	searchMagic = searchMagicNumber;
+
+	openNodes = &threadOpenNodes[ThreadPool::GetThreadNum()];
+
+	// all members share our target node; search once from it until the
+	// source nodes of every member are closed, after which each can trace
+	// its own path by following the back-pointers towards the target
+	std::vector<INode*> groupNodes;
+	std::vector<bool> groupNodesReached;
+
+	groupNodes.reserve(members.size());
+	goalMins = float3( std::numeric_limits<float>::max());
+	goalMaxs = float3(-std::numeric_limits<float>::max());
+
+	for (IPathSearch* member: members) {
+		PathSearch* search = static_cast<PathSearch*>(member);
+
+		assert(search->tgtNode == tgtNode);
+		search->haveGroupPath = false;
+
+		groupNodes.push_back(search->srcNode);
+		goalMins = float3::min(goalMins, search->srcPoint);
+		goalMaxs = float3::max(goalMaxs, search->srcPoint);
+	}
+
+	std::sort(groupNodes.begin(), groupNodes.end());
+	groupNodes.erase(std::unique(groupNodes.begin(), groupNodes.end()), groupNodes.end());
+	groupNodesReached.resize(groupNodes.size(), false);
+
+	// as in Execute, members may start inside impassable nodes (e.g. a factory
+	// footprint) which the search must still be able to enter to reach them
+	std::vector<INode*> blockedNodes;
+
+	for (INode* node: groupNodes) {
+		if (node == tgtNode || node->GetMoveCost() != QTPFS_POSITIVE_INFINITY)
+			continue;
+
+		node->SetMoveCost(0.0f);
+		blockedNodes.push_back(node);
+	}
+
+	// forward searches can never enter an impassable target node
+	if (!tgtNode->AllSquaresImpassable()) {
+		INode* rootNode = tgtNode;
+		size_t numReached = 0;
+
+		switch (searchType) {
+			case PATH_SEARCH_ASTAR:    { hCostMult = 1.0f / nodeLayer->GetMaxRelSpeedMod(); } break;
+			case PATH_SEARCH_DIJKSTRA: { hCostMult = 0.0f;                                  } break;
+		}
+
+		// no node is a target while iterating, reached sources are counted below
+		tgtNode = nullptr;
+
+		ResetState(rootNode, tgtPoint);
+		UpdateNode(rootNode, nullptr, 0);
+
+		while (!openNodes->empty()) {
+			IterateNodes(nodeLayer->GetNodes());
+
+			const auto it = std::lower_bound(groupNodes.begin(), groupNodes.end(), curNode);
+
+			if (it == groupNodes.end() || *it != curNode)
+				continue;
+			if (groupNodesReached[it - groupNodes.begin()])
+				continue;
+
+			groupNodesReached[it - groupNodes.begin()] = true;
+
+			if ((numReached += 1) == groupNodes.size())
+				openNodes->reset();
+		}
+
+		tgtNode = rootNode;
+	}
+
+	for (INode* node: blockedNodes) {
+		node->SetMoveCost(QTPFS_POSITIVE_INFINITY);
+	}
+
+	goalMins = tgtPoint;
+	goalMaxs = tgtPoint;
+
+	for (IPathSearch* member: members) {
+		PathSearch* search = static_cast<PathSearch*>(member);
+
+		const auto it = std::lower_bound(groupNodes.begin(), groupNodes.end(), search->srcNode);
+
+		// reaching a member's source from its target always yields a full path
+		search->haveGroupPath = groupNodesReached[it - groupNodes.begin()];
+		search->haveFullPath = search->haveGroupPath;
+	}
+}
+
+bool QTPFS::PathSearch::GroupFinalize(IPath* path) {
+	// sources not reached by the group search are searched for individually
+	if (!haveGroupPath)
+		return false;
+
+	TraceGroupPath(path);
+
+	#ifdef QTPFS_REPAIR_DEAD_PATHS
+	if (haveFullPath)
+		path->SpliceRepairPoints();
+	#endif
+
+	path->SetBoundingBox();
+
+	pathCache->AddLivePath(path);
+	return true;
+}
+
+void QTPFS::PathSearch::TraceGroupPath(IPath* path) {
+	std::vector<float3> points;
+
+	pathNodes.clear();
+	points.push_back(srcPoint);
+
+	// back-pointers of a group search lead from each source to the target,
+	// so the waypoints come out in order; they are not reset since nodes
+	// can be shared with the paths of other members
+	for (INode* n = srcNode; n != tgtNode; n = n->GetPrevNode()) {
+		const float2& tmpPoint2 = n->GetNeighborEdgeTransitionPoint(0);
+		const float3  tmpPoint  = {tmpPoint2.x, 0.0f, tmpPoint2.y};
+
+		assert(n->GetPrevNode() != nullptr);
+		assert(!math::isinf(tmpPoint.x) && !math::isinf(tmpPoint.z));
+		assert(!math::isnan(tmpPoint.x) && !math::isnan(tmpPoint.z));
+
+		pathNodes.push_back(n);
+		points.push_back(tmpPoint);
+	}
+
+	pathNodes.push_back(tgtNode);
+	points.push_back(tgtPoint);
+
+	// SmoothPathIter walks from the target
+	std::reverse(pathNodes.begin(), pathNodes.end());
+
+	// waypoints should never have identical coordinates, but the source
+	// or target point can coincide with the adjacent transition-point
+	const bool uniquePoints = (std::adjacent_find(points.begin(), points.end()) == points.end());
+
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+	path->AllocPoints(std::max(points.size(), size_t(2)));
+
+	for (unsigned int i = 0; i < points.size(); i++) {
+		path->SetPoint(i, points[i]);
+	}
+
+	path->SetSourcePoint(srcPoint);
+	path->SetTargetPoint(tgtPoint);
+
+	#ifdef QTPFS_SMOOTH_PATHS
+	// smoothing relies on one waypoint per node-transition
+	if (path->NumPoints() == 2 || !uniquePoints)
+		return;
+
+	for (unsigned int k = 0; k < QTPFS_MAX_SMOOTHING_ITERATIONS; k++) {
+		if (!SmoothPathIter(path))
+			break;
+	}
+	#endif
+}
+
+
 bool QTPFS::PathSearch::SharedFinalize(const IPath* srcPath, IPath* dstPath) {
 	assert(dstPath->GetID() != 0);
 	assert(dstPath->GetID() != srcPath->GetID());
@@ -564,3 +769,7 @@ const std::uint64_t QTPFS::PathSearch::GetHash(std::uint64_t N, std::uint32_t k)
 	return (srcNode->GetNodeNumber() + (tgtNode->GetNodeNumber() * N) + (k * N * N));
 }
 
+const std::uint64_t QTPFS::PathSearch::GetGroupHash(std::uint64_t N, std::uint32_t k) const {
+	return (tgtNode->GetNodeNumber() + (k * N));
+}
+
@@ -97,9 +97,19 @@ namespace QTPFS {
 		) = 0;
 		virtual void Finalize(IPath* path) = 0;
 		virtual bool SharedFinalize(const IPath* srcPath, IPath* dstPath) { return false; }
+		virtual void ExecuteGroup(
+			const std::vector<IPathSearch*>& members,
+			unsigned int searchStateOffset = 0,
+			unsigned int searchMagicNumber = 0
+		) {}
+		virtual bool GroupFinalize(IPath* path) { return false; }
 		virtual PathSearchTrace::Execution* GetExecutionTrace() { return NULL; }
 
 		virtual const std::uint64_t GetHash(std::uint64_t N, std::uint32_t k) const = 0;
+		virtual const std::uint64_t GetGroupHash(std::uint64_t N, std::uint32_t k) const = 0;
+
+		// false after Execute if only a partial path (towards the closest node) was found
+		virtual bool HaveFullPath() const = 0;
 
 		void SetID(unsigned int n) { searchID = n; }
 		void SetTeam(unsigned int n) { searchTeam = n; }
@@ -128,11 +138,12 @@ namespace QTPFS {
 			, curNode(NULL)
 			, nxtNode(NULL)
 			, minNode(NULL)
+			, openNodes(NULL)
 			, hCostMult(0.0f)
 			, haveFullPath(false)
 			, havePartPath(false)
+			, haveGroupPath(false)
 			{}
-		~PathSearch() { openNodes.reset(); }
 
 		void Initialize(
 			NodeLayer* layer,
@@ -147,27 +158,42 @@ namespace QTPFS {
 		);
 		void Finalize(IPath* path);
 		bool SharedFinalize(const IPath* srcPath, IPath* dstPath);
+		void ExecuteGroup(
+			const std::vector<IPathSearch*>& members,
+			unsigned int searchStateOffset = 0,
+			unsigned int searchMagicNumber = 0
+		);
+		bool GroupFinalize(IPath* path);
 		PathSearchTrace::Execution* GetExecutionTrace() { return searchExec; }
 
 		const std::uint64_t GetHash(std::uint64_t N, std::uint32_t k) const;
+		const std::uint64_t GetGroupHash(std::uint64_t N, std::uint32_t k) const;
 
-		static void InitGlobalQueue(unsigned int n) { openNodes.reserve(n); }
-		static void FreeGlobalQueue() { openNodes.clear(); }
+		bool HaveFullPath() const { return haveFullPath; }
+
+		static void InitGlobalQueues(unsigned int n);
+		static void FreeGlobalQueues();
 
 	private:
-		void ResetState(INode* node);
+		void ResetState(INode* node, const float3& point);
 		void UpdateNode(INode* nextNode, INode* prevNode, unsigned int netPointIdx);
 
 		void IterateNodes(const std::vector<INode*>& allNodes);
 		void IterateNodeNeighbors(const std::vector<INode*>& nxtNodes);
 
 		void TracePath(IPath* path);
-		void SmoothPath(IPath* path) const;
+		void TraceGroupPath(IPath* path);
+		void SmoothPath(IPath* path);
 		bool SmoothPathIter(IPath* path) const;
 
-		// global queue: allocated once, re-used by all searches without clear()'s
+		// never over-estimates the distance to the closest point the search heads for
+		float GetHeuristicDist(const float3& p) const {
+			return (p.distance(float3::min(float3::max(p, goalMins), goalMaxs)));
+		}
+
+		// global per-thread queues: allocated once, re-used by all searches without clear()'s
 		// this relies on INode::operator< to sort the INode*'s by increasing f-cost
-		static binary_heap<INode*> openNodes;
+		static std::vector< binary_heap<INode*> > threadOpenNodes;
 
 		NodeLayer* nodeLayer;
 		PathCache* pathCache;
@@ -182,9 +208,21 @@ namespace QTPFS {
 		INode *curNode, *nxtNode;
 		INode *minNode;
 
+		// queue of the thread executing this search
+		binary_heap<INode*>* openNodes;
+
 		float3 srcPoint;
 		float3 tgtPoint;
 
+		// bounds of the point(s) the heuristic heads for; tgtPoint
+		// except during a group search, which starts at tgtPoint
+		// and heads for the source points of all its members
+		float3 goalMins;
+		float3 goalMaxs;
+
+		// nodes along the traced path, from target to source
+		std::vector<INode*> pathNodes;
+
 		float2 netPoints[QTPFS_MAX_NETPOINTS_PER_NODE_EDGE];
 
 		float gDists[QTPFS_MAX_NETPOINTS_PER_NODE_EDGE];
@@ -196,6 +234,7 @@ namespace QTPFS {
 
 		bool haveFullPath;
 		bool havePartPath;
+		bool haveGroupPath;
 	};
 }
 
@@ -352,10 +352,13 @@ void CAirCAI::ExecuteFight(Command& c)
 			const float3 pos = ClosestPointOnLine(commandPos1, commandPos2, owner->pos + ofs);
 
 			if ((enemy = CGameHelper::GetClosestValidTarget(pos, 500.0f * owner->moveState, owner->allyteam, this)) != nullptr) {
+				// pushing a return-fight command can move <c> along with the queue
+				const unsigned char cmdOpts = c.GetOpts();
+
 				PushOrUpdateReturnFight();
 
 				// make the attack-command inherit <c>'s options
-				commandQue.push_front(Command(CMD_ATTACK, c.GetOpts(), enemy->id));
+				commandQue.push_front(Command(CMD_ATTACK, cmdOpts, enemy->id));
 
 				tempOrder = true;
 				inCommand = false;
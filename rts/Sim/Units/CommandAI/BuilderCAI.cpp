@@ -1,5 +1,6 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <cassert>
 
 #include "BuilderCAI.h"
@@ -54,9 +55,9 @@ CR_REG_METADATA(CBuilderCAI , (
 ))
 
 // not adding to members, should repopulate itself
-spring::unordered_set<int> CBuilderCAI::reclaimers;
-spring::unordered_set<int> CBuilderCAI::featureReclaimers;
-spring::unordered_set<int> CBuilderCAI::resurrecters;
+CBuilderCAI::TargetIndex CBuilderCAI::reclaimers;
+CBuilderCAI::TargetIndex CBuilderCAI::featureReclaimers;
+CBuilderCAI::TargetIndex CBuilderCAI::resurrecters;
 
 std::vector<int> CBuilderCAI::removees;
 
@@ -226,9 +227,9 @@ CBuilderCAI::~CBuilderCAI()
 
 void CBuilderCAI::InitStatic()
 {
-	spring::clear_unordered_set(reclaimers);
-	spring::clear_unordered_set(featureReclaimers);
-	spring::clear_unordered_set(resurrecters);
+	reclaimers.Clear();
+	featureReclaimers.Clear();
+	resurrecters.Clear();
 }
 
 void CBuilderCAI::PostLoad()
@@ -1026,7 +1027,7 @@ void CBuilderCAI::ExecuteReclaim(Command& c)
 					StopMoveAndFinishCommand();
 					RemoveUnitFromFeatureReclaimers(owner);
 				} else {
-					AddUnitToFeatureReclaimers(owner);
+					AddUnitToFeatureReclaimers(owner, feature->id);
 				}
 			} else {
 				StopMoveAndFinishCommand();
@@ -1061,7 +1062,7 @@ void CBuilderCAI::ExecuteReclaim(Command& c)
 				if (!ReclaimObject(unit)) {
 					StopMoveAndFinishCommand();
 				} else {
-					AddUnitToReclaimers(owner);
+					AddUnitToReclaimers(owner, unit->id);
 				}
 			} else {
 				RemoveUnitFromReclaimers(owner);
@@ -1134,7 +1135,7 @@ void CBuilderCAI::ExecuteResurrect(Command& c)
 					StopMoveAndFinishCommand();
 				}
 				else {
-					AddUnitToResurrecters(owner);
+					AddUnitToResurrecters(owner, feature->id);
 				}
 			} else {
 				RemoveUnitFromResurrecters(owner);
@@ -1363,131 +1364,150 @@ int CBuilderCAI::GetDefaultCmd(const CUnit* pointed, const CFeature* feature)
 }
 
 
-void CBuilderCAI::AddUnitToReclaimers(CUnit* unit) { reclaimers.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromReclaimers(CUnit* unit) { reclaimers.erase(unit->id); }
+void CBuilderCAI::TargetIndex::Insert(int builderID, int targetID)
+{
+	const auto it = builderTargets.find(builderID);
 
-void CBuilderCAI::AddUnitToFeatureReclaimers(CUnit* unit) { featureReclaimers.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromFeatureReclaimers(CUnit* unit) { featureReclaimers.erase(unit->id); }
+	if (it != builderTargets.end()) {
+		if (it->second == targetID)
+			return;
 
-void CBuilderCAI::AddUnitToResurrecters(CUnit* unit) { resurrecters.insert(unit->id); }
-void CBuilderCAI::RemoveUnitFromResurrecters(CUnit* unit) { resurrecters.erase(unit->id); }
+		EraseTargetBuilder(it->second, builderID);
+		it->second = targetID;
+	} else {
+		builderTargets.emplace(builderID, targetID);
+	}
 
+	targetBuilders[targetID].push_back(builderID);
+}
 
-/**
- * Checks if a unit is being reclaimed by a friendly con.
- *
- * We assume that there will not be a lot of reclaimers, because performance
- * would suck if there were. Ideally, reclaimers should be assigned on a
- * per-unit basis, but this requires tracking of deaths, which albeit
- * already done, is not exactly simple to follow.
- *
- * TODO easy: store reclaiming units per allyteam
- * TODO harder: update reclaimers as they start/finish reclaims and/or die
- */
-bool CBuilderCAI::IsUnitBeingReclaimed(const CUnit* unit, const CUnit* friendUnit)
+void CBuilderCAI::TargetIndex::Erase(int builderID)
 {
-	bool retval = false;
+	const auto it = builderTargets.find(builderID);
 
-	removees.clear();
-	removees.reserve(reclaimers.size());
+	if (it == builderTargets.end())
+		return;
 
-	for (auto it = reclaimers.begin(); it != reclaimers.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
+	EraseTargetBuilder(it->second, builderID);
+	builderTargets.erase(it);
+}
 
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const Command& c = cq.front();
-		if (c.GetID() != CMD_RECLAIM || (c.GetNumParams() != 1 && c.GetNumParams() != 5)) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdUnitId = (int)c.GetParam(0);
-		if (cmdUnitId == unit->id && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
+void CBuilderCAI::TargetIndex::EraseTargetBuilder(int targetID, int builderID)
+{
+	const auto it = targetBuilders.find(targetID);
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromReclaimers(unitHandler.GetUnit(*it));
+	if (it == targetBuilders.end())
+		return;
 
-	return retval;
+	std::vector<int>& builders = it->second;
+	const auto bit = std::find(builders.begin(), builders.end(), builderID);
+
+	assert(bit != builders.end());
+
+	*bit = builders.back();
+	builders.pop_back();
+
+	if (builders.empty())
+		targetBuilders.erase(it);
 }
 
+void CBuilderCAI::TargetIndex::Clear()
+{
+	spring::clear_unordered_map(builderTargets);
+	spring::clear_unordered_map(targetBuilders);
+}
 
-bool CBuilderCAI::IsFeatureBeingReclaimed(int featureId, const CUnit* friendUnit)
+const std::vector<int>& CBuilderCAI::TargetIndex::GetBuilders(int targetID) const
 {
-	bool retval = false;
+	static const std::vector<int> noBuilders;
 
-	removees.clear();
-	removees.reserve(featureReclaimers.size());
+	const auto it = targetBuilders.find(targetID);
 
-	for (auto it = featureReclaimers.begin(); it != featureReclaimers.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
+	if (it == targetBuilders.end())
+		return noBuilders;
 
-		if (cq.empty()) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const Command& c = cq.front();
-		if (c.GetID() != CMD_RECLAIM || (c.GetNumParams() != 1 && c.GetNumParams() != 5)) {
-			removees.push_back(u->id);
-			continue;
-		}
-		const int cmdFeatureId = (int)c.GetParam(0);
-		if ((cmdFeatureId - unitHandler.MaxUnits()) == featureId && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
-			retval = true;
-			break;
-		}
-	}
+	return it->second;
+}
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromFeatureReclaimers(unitHandler.GetUnit(*it));
 
-	return retval;
-}
+void CBuilderCAI::AddUnitToReclaimers(CUnit* unit, int unitID) { reclaimers.Insert(unit->id, unitID); }
+void CBuilderCAI::RemoveUnitFromReclaimers(CUnit* unit) { reclaimers.Erase(unit->id); }
 
+void CBuilderCAI::AddUnitToFeatureReclaimers(CUnit* unit, int featureID) { featureReclaimers.Insert(unit->id, featureID); }
+void CBuilderCAI::RemoveUnitFromFeatureReclaimers(CUnit* unit) { featureReclaimers.Erase(unit->id); }
 
-bool CBuilderCAI::IsFeatureBeingResurrected(int featureId, const CUnit* friendUnit)
+void CBuilderCAI::AddUnitToResurrecters(CUnit* unit, int featureID) { resurrecters.Insert(unit->id, featureID); }
+void CBuilderCAI::RemoveUnitFromResurrecters(CUnit* unit) { resurrecters.Erase(unit->id); }
+
+
+/**
+ * Checks if any builder registered in <index> for <targetID> is still
+ * executing <cmdID> on it and is allied to <friendUnit> (if given).
+ * Builders whose current command no longer matches are dropped from
+ * the index.
+ */
+static bool IsBeingTargeted(CBuilderCAI::TargetIndex& index, int targetID, int cmdID, int cmdTargetID, const CUnit* friendUnit)
 {
+	const std::vector<int>& builders = index.GetBuilders(targetID);
+
+	if (builders.empty())
+		return false;
+
 	bool retval = false;
 
+	std::vector<int>& removees = CBuilderCAI::removees;
 	removees.clear();
-	removees.reserve(resurrecters.size());
 
-	for (auto it = resurrecters.begin(); it != resurrecters.end(); ++it) {
-		const CUnit* u = unitHandler.GetUnit(*it);
-		const CCommandAI* cai = u->commandAI;
-		const CCommandQueue& cq = cai->commandQue;
+	for (const int builderID: builders) {
+		const CUnit* u = unitHandler.GetUnit(builderID);
+		const CCommandQueue& cq = u->commandAI->commandQue;
 
 		if (cq.empty()) {
-			removees.push_back(u->id);
+			removees.push_back(builderID);
 			continue;
 		}
+
 		const Command& c = cq.front();
-		if (c.GetID() != CMD_RESURRECT || c.GetNumParams() != 1) {
-			removees.push_back(u->id);
+
+		if (c.GetID() != cmdID || (c.GetNumParams() != 1 && (c.GetNumParams() != 5 || cmdID != CMD_RECLAIM))) {
+			removees.push_back(builderID);
 			continue;
 		}
-		const int cmdFeatureId = (int)c.GetParam(0);
-		if ((cmdFeatureId - unitHandler.MaxUnits()) == featureId && (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam))) {
+		if (static_cast<int>(c.GetParam(0)) != cmdTargetID) {
+			removees.push_back(builderID);
+			continue;
+		}
+
+		if (friendUnit == nullptr || teamHandler.Ally(friendUnit->allyteam, u->allyteam)) {
 			retval = true;
 			break;
 		}
 	}
 
-	for (auto it = removees.begin(); it != removees.end(); ++it)
-		RemoveUnitFromResurrecters(unitHandler.GetUnit(*it));
+	for (const int builderID: removees)
+		index.Erase(builderID);
 
 	return retval;
 }
 
+/**
+ * Checks if a unit is being reclaimed by a friendly con.
+ */
+bool CBuilderCAI::IsUnitBeingReclaimed(const CUnit* unit, const CUnit* friendUnit)
+{
+	return (IsBeingTargeted(reclaimers, unit->id, CMD_RECLAIM, unit->id, friendUnit));
+}
+
+bool CBuilderCAI::IsFeatureBeingReclaimed(int featureId, const CUnit* friendUnit)
+{
+	return (IsBeingTargeted(featureReclaimers, featureId, CMD_RECLAIM, featureId + unitHandler.MaxUnits(), friendUnit));
+}
+
+bool CBuilderCAI::IsFeatureBeingResurrected(int featureId, const CUnit* friendUnit)
+{
+	return (IsBeingTargeted(resurrecters, featureId, CMD_RESURRECT, featureId + unitHandler.MaxUnits(), friendUnit));
+}
+
 
 bool CBuilderCAI::ReclaimObject(CSolidObject* object) {
 	if (MoveInBuildRange(object)) {
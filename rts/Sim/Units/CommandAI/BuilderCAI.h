@@ -6,6 +6,7 @@
 #include "MobileCAI.h"
 #include "Sim/Units/BuildInfo.h"
 #include "System/Misc/BitwiseEnum.h"
+#include "System/UnorderedMap.hpp"
 #include "System/UnorderedSet.hpp"
 
 #include <vector>
@@ -62,12 +63,34 @@ public:
 	bool IsInBuildRange(const CWorldObject* obj) const;
 	bool IsInBuildRange(const float3& pos, const float radius) const;
 
+public:
+	/**
+	 * Builders executing a reclaim or resurrect command, keyed by the
+	 * ID of their target. Entries are added and removed as commands
+	 * start and stop, stale ones are pruned when their target is queried.
+	 */
+	struct TargetIndex {
+	public:
+		void Insert(int builderID, int targetID);
+		void Erase(int builderID);
+		void Clear();
+
+		const std::vector<int>& GetBuilders(int targetID) const;
+
+	private:
+		void EraseTargetBuilder(int targetID, int builderID);
+
+	private:
+		spring::unordered_map<int, int> builderTargets;
+		spring::unordered_map<int, std::vector<int>> targetBuilders;
+	};
+
 public:
 	spring::unordered_set<int> buildOptions;
 
-	static spring::unordered_set<int> reclaimers;
-	static spring::unordered_set<int> featureReclaimers;
-	static spring::unordered_set<int> resurrecters;
+	static TargetIndex reclaimers;
+	static TargetIndex featureReclaimers;
+	static TargetIndex resurrecters;
 
 	static std::vector<int> removees;
 
@@ -125,15 +148,15 @@ private:
 	void ReclaimFeature(CFeature* f);
 
 	/// fix for patrolling cons repairing/resurrecting stuff that's being reclaimed
-	static void AddUnitToReclaimers(CUnit*);
+	static void AddUnitToReclaimers(CUnit*, int unitID);
 	static void RemoveUnitFromReclaimers(CUnit*);
 
 	/// fix for cons wandering away from their target circle
-	static void AddUnitToFeatureReclaimers(CUnit*);
+	static void AddUnitToFeatureReclaimers(CUnit*, int featureID);
 	static void RemoveUnitFromFeatureReclaimers(CUnit*);
 
 	/// fix for patrolling cons reclaiming stuff that is being resurrected
-	static void AddUnitToResurrecters(CUnit*);
+	static void AddUnitToResurrecters(CUnit*, int featureID);
 	static void RemoveUnitFromResurrecters(CUnit*);
 
 	inline float f3Dist(const float3& a, const float3& b) const {
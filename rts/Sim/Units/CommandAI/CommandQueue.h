@@ -3,10 +3,13 @@
 #ifndef _COMMAND_QUEUE_H
 #define _COMMAND_QUEUE_H
 
-#include <deque>
 #include "Command.h"
+#include "System/RingDeque.hpp"
 
-/// A wrapper class for std::deque<Command> to keep track of commands
+/// A wrapper class for spring::ring_deque<Command> to keep track of commands
+/// NOTE: unlike std::deque, pushing a command can invalidate references to the others,
+///   and a popped command's slot is reset and then reused by the next push_front; code
+///   holding a Command& into the queue must copy what it needs before modifying it
 class CCommandQueue {
 
 	friend class CCommandAI;
@@ -28,7 +31,7 @@ class CCommandQueue {
 		/// limit to a float's integer range
 		static const int maxTagValue = (1 << 24); // 16777216
 
-		typedef std::deque<Command> basis;
+		typedef spring::ring_deque<Command> basis;
 
 		typedef basis::size_type              size_type;
 		typedef basis::iterator               iterator;
@@ -98,7 +101,7 @@ class CCommandQueue {
 		inline void SetQueueType(QueueType type) { queueType = type; }
 
 	private:
-		std::deque<Command> queue;
+		basis queue;
 		QueueType queueType;
 		int tagCounter;
 };
@@ -542,11 +542,14 @@ void CMobileCAI::ExecuteFight(Command& c)
 		CUnit* enemy = CGameHelper::GetClosestValidTarget(curPosOnLine, searchRadius, owner->allyteam, this);
 
 		if (enemy != nullptr) {
+			// pushing a return-fight command can move <c> along with the queue
+			const unsigned char cmdOpts = c.GetOpts();
+
 			PushOrUpdateReturnFight();
 
 			// make the attack-command inherit <c>'s options
 			// NOTE: see AirCAI::ExecuteFight why we do not set INTERNAL_ORDER
-			commandQue.push_front(Command(CMD_ATTACK, c.GetOpts(), enemy->id));
+			commandQue.push_front(Command(CMD_ATTACK, cmdOpts, enemy->id));
 
 			inCommand = false;
 			tempOrder = true;
@@ -1777,6 +1780,9 @@ void CMobileCAI::UnloadUnits_Drop(Command& c)
 
 	const bool canUnload = FindEmptyDropSpots(startingDropPos, startingDropPos + approachVector * std::max(16.0f, c.GetParam(3)), dropSpots);
 
+	// <c> is the queue's front and gets popped (its slot reused) below
+	const unsigned char cmdOpts = c.GetOpts();
+
 	StopMoveAndFinishCommand();
 
 	if (canUnload) {
@@ -1784,7 +1790,7 @@ void CMobileCAI::UnloadUnits_Drop(Command& c)
 		auto di = dropSpots.rbegin();
 
 		for (; ti != transportees.end() && di != dropSpots.rend(); ++ti, ++di) {
-			commandQue.push_front(Command(CMD_UNLOAD_UNIT, c.GetOpts() | INTERNAL_ORDER, *di));
+			commandQue.push_front(Command(CMD_UNLOAD_UNIT, cmdOpts | INTERNAL_ORDER, *di));
 		}
 
 		SlowUpdate();
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cstdio>
+#include <ctime>
 #include <memory>
 
 #include <sys/types.h>
@@ -54,6 +55,9 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_ARCHIVESCANNER)
 
 constexpr static int INTERNAL_VER = 16;
 
+// number of uncached archives read concurrently between watchdog resets
+constexpr static size_t SCAN_BATCH_SIZE = 256;
+
 
 /*
  * Engine known (and used?) tags in [map|mod]info.lua
@@ -419,6 +423,10 @@ void CArchiveScanner::Clear()
 	brokenArchives.reserve(16);
 	brokenArchivesIndex.clear();
 	brokenArchivesIndex.reserve(16);
+	dirInfos.clear();
+	dirInfos.reserve(16);
+	dirInfosIndex.clear();
+	dirInfosIndex.reserve(16);
 	cachefile.clear();
 }
 
@@ -472,8 +480,6 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs)
 	std::lock_guard<decltype(scannerMutex)> lck(scannerMutex);
 	std::deque<std::string> foundArchives;
 
-	isDirty = true;
-
 	// scan for all archives
 	for (const std::string& dir: scanDirs) {
 		if (!FileSystem::DirExists(dir))
@@ -499,9 +505,45 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs)
 		}
 	}*/
 
-	// Create archiveInfos etc. if not in cache already
+	// Create archiveInfos etc. if not in cache already; a stat suffices
+	// for cached archives, the others are opened and read concurrently
+	// and added in the order they were found
+	std::vector<ArchiveScanData> scanData;
+
 	for (const std::string& archive: foundArchives) {
-		ScanArchive(archive, false);
+		unsigned modifiedTime = 0;
+
+		if (CheckCachedData(archive, modifiedTime, false))
+			continue;
+
+		scanData.emplace_back();
+		scanData.back().fullName = archive;
+		scanData.back().modified = modifiedTime;
+	}
+
+	for (size_t i = 0; i < scanData.size(); i += SCAN_BATCH_SIZE) {
+		const size_t j = std::min(i + SCAN_BATCH_SIZE, scanData.size());
+
+		for_mt(i, j, [&](const int k) {
+			ReadArchiveScanData(scanData[k]);
+		});
+
+		for (size_t k = i; k < j; k++) {
+			ArchiveScanData& sd = scanData[k];
+
+			// the same archive can exist in multiple data-dirs, recheck
+			// against the copies that were added since the first pass
+			if (CheckCachedData(sd.fullName, sd.modified, false))
+				continue;
+
+			AddArchiveScanData(sd, false);
+		}
+
+		// release buffers of finished batches early
+		for (size_t k = i; k < j; k++) {
+			scanData[k] = {};
+		}
+
 	#if !defined(DEDICATED) && !defined(UNITSYNC)
 		Watchdog::ClearTimer();
 	#endif
@@ -517,6 +559,8 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs)
 			// Overwrite the info for this archive with a replaced pointer
 			ArchiveInfo& ai = GetAddArchiveInfo(lcReplaceName);
 
+			isDirty |= (ai.replaced != lcOriginalName);
+
 			ai.path = "";
 			ai.origName = replaceName;
 			ai.modified = 1;
@@ -525,6 +569,13 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs)
 			ai.replaced = lcOriginalName;
 		}
 	}
+
+	// entries not seen during this scan are dropped from the cache
+	const auto isStale = [](const auto& info) { return (!info.updated); };
+
+	isDirty |= std::any_of(archiveInfos.begin(), archiveInfos.end(), isStale);
+	isDirty |= std::any_of(brokenArchives.begin(), brokenArchives.end(), isStale);
+	isDirty |= std::any_of(dirInfos.begin(), dirInfos.end(), isStale);
 }
 
 
@@ -537,29 +588,73 @@ void CArchiveScanner::ScanDir(const std::string& curPath, std::deque<std::string
 			Watchdog::ClearTimer();
 		#endif
 
-		const std::string& subDir = FileSystem::EnsurePathSepAtEnd(subDirs.front());
-		const std::vector<std::string>& foundFiles = dataDirsAccess.FindFiles(subDir, "*", FileQueryFlags::INCLUDE_DIRS);
+		// FindFiles returns native separators, keep them for the paths built from cached listings
+		std::string subDir = FileSystem::EnsurePathSepAtEnd(subDirs.front());
+		FileSystem::FixSlashes(subDir);
+
+		const DirInfo& dirInfo = GetDirInfo(subDir);
 
 		subDirs.pop_front();
 
-		for (const std::string& fileName: foundFiles) {
-			const std::string& fileNameNoSep = FileSystem::EnsureNoPathSepAtEnd(fileName);
-			const std::string& lcFilePath = StringToLower(FileSystem::GetDirectory(fileNameNoSep));
+		for (const std::string& archiveName: dirInfo.archives) {
+			foundArchives.push_front(subDir + archiveName); // push in reverse order!
+		}
+		for (const std::string& subDirName: dirInfo.subDirs) {
+			subDirs.push_back(subDir + subDirName);
+		}
+	}
+}
 
-			// Exclude archive files found inside directory archives (.sdd)
-			if (lcFilePath.find(".sdd") != std::string::npos)
-				continue;
+const CArchiveScanner::DirInfo& CArchiveScanner::GetDirInfo(const std::string& dirPath)
+{
+	// adding, removing or renaming an entry updates the directory's
+	// own modification time, so an unchanged time means the cached
+	// listing is still valid and the directory need not be read
+	const uint32_t modified = FileSystemAbstraction::GetFileModificationTime(FileSystem::EnsureNoPathSepAtEnd(dirPath));
+	const auto diIter = dirInfosIndex.find(dirPath);
+
+	if (diIter != dirInfosIndex.end()) {
+		DirInfo& di = dirInfos[diIter->second];
+
+		if (modified != 0 && modified == di.modified) {
+			di.updated = true;
+			return di;
+		}
+	} else {
+		dirInfosIndex.insert(dirPath, dirInfos.size());
+		dirInfos.emplace_back();
+	}
 
-			// Is this an archive we should look into?
-			if (archiveLoader.IsArchiveFile(fileNameNoSep)) {
-				foundArchives.push_front(fileNameNoSep); // push in reverse order!
-				continue;
-			}
-			if (FileSystem::DirExists(fileNameNoSep)) {
-				subDirs.push_back(fileNameNoSep);
-			}
+	DirInfo& di = dirInfos[dirInfosIndex[dirPath]];
+
+	di.path = dirPath;
+	di.archives.clear();
+	di.subDirs.clear();
+	// a directory modified in the second it is listed can change again without
+	// its time changing, such listings are not trusted by the next scan
+	di.modified = ((modified + 1) < uint32_t(std::time(nullptr)))? modified: 0;
+	di.updated = true;
+
+	isDirty = true;
+
+	// Exclude archive files found inside directory archives (.sdd)
+	if (StringToLower(dirPath).find(".sdd") != std::string::npos)
+		return di;
+
+	for (const std::string& fileName: dataDirsAccess.FindFiles(dirPath, "*", FileQueryFlags::INCLUDE_DIRS)) {
+		const std::string& fileNameNoSep = FileSystem::EnsureNoPathSepAtEnd(fileName);
+
+		// Is this an archive we should look into?
+		if (archiveLoader.IsArchiveFile(fileNameNoSep)) {
+			di.archives.push_back(FileSystem::GetFilename(fileNameNoSep));
+			continue;
+		}
+		if (FileSystem::DirExists(fileNameNoSep)) {
+			di.subDirs.push_back(FileSystem::GetFilename(fileNameNoSep));
 		}
 	}
+
+	return di;
 }
 
 static void AddDependency(std::vector<std::string>& deps, const std::string& dependency)
@@ -645,12 +740,66 @@ CArchiveScanner::BrokenArchive& CArchiveScanner::GetAddBrokenArchive(const std::
 
 void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 {
-	unsigned modifiedTime = 0;
+	ArchiveScanData sd;
 
 	assert(!isInScan);
 
-	if (CheckCachedData(fullName, modifiedTime, doChecksum))
+	if (CheckCachedData(fullName, sd.modified, doChecksum))
+		return;
+
+	sd.fullName = fullName;
+
+	ReadArchiveScanData(sd);
+	AddArchiveScanData(sd, doChecksum);
+}
+
+void CArchiveScanner::ReadArchiveScanData(ArchiveScanData& sd)
+{
+	std::unique_ptr<IArchive> ar;
+
+	try {
+		ar.reset(archiveLoader.OpenArchive(sd.fullName));
+	} catch (...) {
+		// rethrown by AddArchiveScanData, as if the archive had been opened there
+		sd.openError = std::current_exception();
 		return;
+	}
+
+	if (ar == nullptr || !ar->IsOpen())
+		return;
+
+	sd.isOpen = true;
+	sd.archiveType = ar->GetType();
+	sd.hasModInfo = ar->FileExists("modinfo.lua");
+	sd.hasMapInfo = ar->FileExists("mapinfo.lua");
+
+	if (sd.hasMapInfo) {
+		sd.luaInfoFile = "mapinfo.lua";
+	} else if (sd.hasModInfo) {
+		sd.luaInfoFile = "modinfo.lua";
+	}
+
+	// only needed if mapinfo.lua turns out to lack the 'mapfile' key, but cheap
+	if (sd.hasMapInfo || !sd.hasModInfo) {
+		std::string error;
+		sd.arMapFile = SearchMapFile(ar.get(), error);
+	}
+
+	if (!sd.luaInfoFile.empty())
+		sd.luaInfoRead = ar->GetFile(sd.luaInfoFile, sd.luaInfoData);
+
+	sd.compressionOK = CheckCompression(ar.get(), sd.fullName, sd.compressionError);
+
+	// Store modinfo.lua/mapinfo.lua modified timestamp for directory archives, as only they can change.
+	if (sd.archiveType == ARCHIVE_TYPE_SDD && !sd.luaInfoFile.empty()) {
+		sd.archiveDataPath = ar->GetArchiveFile() + "/" + static_cast<const CDirArchive*>(ar.get())->GetOrigFileName(ar->FindFile(sd.luaInfoFile));
+		sd.modifiedArchiveData = FileSystemAbstraction::GetFileModificationTime(sd.archiveDataPath);
+	}
+}
+
+void CArchiveScanner::AddArchiveScanData(ArchiveScanData& sd, bool doChecksum)
+{
+	assert(!isInScan);
 
 	isDirty = true;
 	isInScan = true;
@@ -664,20 +813,22 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 
 	const ScanScope scanScope(&isInScan);
 
+	const std::string& fullName = sd.fullName;
 	const std::string& fname = FileSystem::GetFilename(fullName);
 	const std::string& fpath = FileSystem::GetDirectory(fullName);
 	const std::string& lcfn  = StringToLower(fname);
 
-	std::unique_ptr<IArchive> ar(archiveLoader.OpenArchive(fullName));
+	if (sd.openError != nullptr)
+		std::rethrow_exception(sd.openError);
 
-	if (ar == nullptr || !ar->IsOpen()) {
+	if (!sd.isOpen) {
 		LOG_L(L_WARNING, "[AS::%s] unable to open archive \"%s\"", __func__, fullName.c_str());
 
 		// record it as broken, so we don't need to look inside everytime
 		BrokenArchive& ba = GetAddBrokenArchive(lcfn);
 		ba.name = lcfn;
 		ba.path = fpath;
-		ba.modified = modifiedTime;
+		ba.modified = sd.modified;
 		ba.updated = true;
 		ba.problem = "Unable to open archive";
 
@@ -689,39 +840,37 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 	std::string error;
 	std::string arMapFile; // file in archive with "smf" extension
 	std::string miMapFile; // value for the 'mapfile' key parsed from mapinfo
-	std::string luaInfoFile;
-
-	const bool hasModInfo = ar->FileExists("modinfo.lua");
-	const bool hasMapInfo = ar->FileExists("mapinfo.lua");
 
 
 	ArchiveInfo ai;
 	ArchiveData& ad = ai.archiveData;
 
 	// execute the respective .lua, otherwise assume this archive is a map
-	if (hasMapInfo) {
-		ScanArchiveLua(ar.get(), luaInfoFile = "mapinfo.lua", ai, error);
+	if (sd.hasMapInfo) {
+		ScanArchiveLua(sd, ai, error);
 
 		if ((miMapFile = ad.GetMapFile()).empty()) {
-			if (ar->GetType() != ARCHIVE_TYPE_SDV)
+			if (sd.archiveType != ARCHIVE_TYPE_SDV)
 				LOG_L(L_WARNING, "[AS::%s] set the 'mapfile' key in mapinfo.lua of archive \"%s\" for faster loading!", __func__, fullName.c_str());
 
-			arMapFile = SearchMapFile(ar.get(), error);
+			arMapFile = sd.arMapFile;
 		}
-	} else if (hasModInfo) {
-		ScanArchiveLua(ar.get(), luaInfoFile = "modinfo.lua", ai, error);
+	} else if (sd.hasModInfo) {
+		ScanArchiveLua(sd, ai, error);
 	} else {
-		arMapFile = SearchMapFile(ar.get(), error);
+		arMapFile = sd.arMapFile;
 	}
 
-	if (!CheckCompression(ar.get(), fullName, error)) {
+	if (!sd.compressionOK) {
+		error += sd.compressionError;
+
 		LOG_L(L_WARNING, "[AS::%s] failed to scan \"%s\" (%s)", __func__, fullName.c_str(), error.c_str());
 
 		// mark archive as broken, so we don't need to look inside everytime
 		BrokenArchive& ba = GetAddBrokenArchive(lcfn);
 		ba.name = lcfn;
 		ba.path = fpath;
-		ba.modified = modifiedTime;
+		ba.modified = sd.modified;
 		ba.updated = true;
 		ba.problem = error;
 
@@ -730,7 +879,7 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 		return;
 	}
 
-	if (hasMapInfo || !arMapFile.empty()) {
+	if (sd.hasMapInfo || !arMapFile.empty()) {
 		// map archive
 		// FIXME: name will never be empty if version is set (see HACK in ArchiveData)
 		if ((ad.GetName()).empty()) {
@@ -745,7 +894,7 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 		ad.SetInfoItemValueInteger("modType", modtype::map);
 
 		LOG_S(LOG_SECTION_ARCHIVESCANNER, "Found new map: %s", ad.GetNameVersioned().c_str());
-	} else if (hasModInfo) {
+	} else if (sd.hasModInfo) {
 		// game or base-type (cursors, bitmaps, ...) archive
 		// babysitting like this is really no longer required
 		if (ad.IsGame() || ad.IsMenu())
@@ -758,13 +907,9 @@ void CArchiveScanner::ScanArchive(const std::string& fullName, bool doChecksum)
 	}
 
 	ai.path = fpath;
-	ai.modified = modifiedTime;
-
-	// Store modinfo.lua/mapinfo.lua modified timestamp for directory archives, as only they can change.
-	if (ar->GetType() == ARCHIVE_TYPE_SDD && !luaInfoFile.empty()) {
-		ai.archiveDataPath = ar->GetArchiveFile() + "/" + static_cast<const CDirArchive*>(ar.get())->GetOrigFileName(ar->FindFile(luaInfoFile));
-		ai.modifiedArchiveData = FileSystemAbstraction::GetFileModificationTime(ai.archiveDataPath);
-	}
+	ai.modified = sd.modified;
+	ai.archiveDataPath = sd.archiveDataPath;
+	ai.modifiedArchiveData = sd.modifiedArchiveData;
 
 	ai.origName = fname;
 	ai.updated = true;
@@ -867,21 +1012,22 @@ bool CArchiveScanner::CheckCachedData(const std::string& fullName, unsigned& mod
 }
 
 
-bool CArchiveScanner::ScanArchiveLua(IArchive* ar, const std::string& fileName, ArchiveInfo& ai, std::string& err)
+bool CArchiveScanner::ScanArchiveLua(const ArchiveScanData& sd, ArchiveInfo& ai, std::string& err)
 {
-	std::vector<std::uint8_t> buf;
+	const std::string& fileName = sd.luaInfoFile;
+	const std::vector<std::uint8_t>& buf = sd.luaInfoData;
 
-	if (!ar->GetFile(fileName, buf) || buf.empty()) {
+	if (!sd.luaInfoRead || buf.empty()) {
 		err = "Error reading " + fileName;
 
-		if (ar->GetArchiveFile().find(".sdp") != std::string::npos)
-			err += " (archive's rapid tag: " + GetRapidTagFromPackage(FileSystem::GetBasename(ar->GetArchiveFile())) + ")";
+		if (sd.fullName.find(".sdp") != std::string::npos)
+			err += " (archive's rapid tag: " + GetRapidTagFromPackage(FileSystem::GetBasename(sd.fullName)) + ")";
 
 		return false;
 	}
 
 	// NB: skips LuaConstGame::PushEntries(L) since that would invoke ScanArchive again
-	LuaParser p(std::string((char*)(buf.data()), buf.size()), SPRING_VFS_ZIP);
+	LuaParser p(std::string((const char*)(buf.data()), buf.size()), SPRING_VFS_ZIP);
 
 	if (!p.Execute()) {
 		err = "Error in " + fileName + ": " + p.GetErrorLog();
@@ -1029,6 +1175,7 @@ void CArchiveScanner::ReadCacheData(const std::string& filename)
 	const LuaTable& archiveCacheTbl = p.GetRoot();
 	const LuaTable& archivesTbl = archiveCacheTbl.SubTable("archives");
 	const LuaTable& brokenArchivesTbl = archiveCacheTbl.SubTable("brokenArchives");
+	const LuaTable& dirsTbl = archiveCacheTbl.SubTable("dirs");
 
 	// Do not load old version caches
 	const int ver = archiveCacheTbl.GetInt("internalver", (INTERNAL_VER + 1));
@@ -1089,6 +1236,32 @@ void CArchiveScanner::ReadCacheData(const std::string& filename)
 		ba.problem = curArchive.GetString("problem", "unknown");
 	}
 
+	for (int i = 1; dirsTbl.KeyExists(i); ++i) {
+		const LuaTable& curDirTbl = dirsTbl.SubTable(i);
+		const LuaTable& archivesListTbl = curDirTbl.SubTable("archives");
+		const LuaTable& subDirsListTbl = curDirTbl.SubTable("subdirs");
+
+		const std::string& path = curDirTbl.GetString("path", "");
+
+		if (path.empty() || dirInfosIndex.find(path) != dirInfosIndex.end())
+			continue;
+
+		dirInfosIndex.insert(path, dirInfos.size());
+		dirInfos.emplace_back();
+
+		DirInfo& di = dirInfos.back();
+		di.path = path;
+		di.modified = strtoul(curDirTbl.GetString("modified", "0").c_str(), nullptr, 10);
+		di.updated = false;
+
+		for (int j = 1; archivesListTbl.KeyExists(j); ++j) {
+			di.archives.push_back(archivesListTbl.GetString(j, ""));
+		}
+		for (int j = 1; subDirsListTbl.KeyExists(j); ++j) {
+			di.subDirs.push_back(subDirsListTbl.GetString(j, ""));
+		}
+	}
+
 	isDirty = false;
 }
 
@@ -1129,12 +1302,15 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 
 		const auto it = std::remove_if(archiveInfos.begin(), archiveInfos.end(), [](const ArchiveInfo& i) { return (!i.updated); });
 		const auto jt = std::remove_if(brokenArchives.begin(), brokenArchives.end(), [](const BrokenArchive& i) { return (!i.updated); });
+		const auto kt = std::remove_if(dirInfos.begin(), dirInfos.end(), [](const DirInfo& i) { return (!i.updated); });
 
 		archiveInfos.erase(it, archiveInfos.end());
 		brokenArchives.erase(jt, brokenArchives.end());
+		dirInfos.erase(kt, dirInfos.end());
 
 		archiveInfosIndex.clear();
 		brokenArchivesIndex.clear();
+		dirInfosIndex.clear();
 
 		// rebuild index-maps
 		for (const ArchiveInfo& ai: archiveInfos) {
@@ -1143,6 +1319,9 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 		for (const BrokenArchive& bi: brokenArchives) {
 			brokenArchivesIndex.insert(bi.name, &bi - &brokenArchives[0]);
 		}
+		for (const DirInfo& di: dirInfos) {
+			dirInfosIndex.insert(di.path, &di - &dirInfos[0]);
+		}
 	}
 
 
@@ -1214,7 +1393,33 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 		fprintf(out, "\t\t},\n");
 	}
 
-	fprintf(out, "\t},\n"); // close 'brokenArchives'
+	fprintf(out, "\t},\n\n"); // close 'brokenArchives'
+	fprintf(out, "\tdirs = {  -- count = %u\n", unsigned(dirInfos.size()));
+
+	for (const DirInfo& di: dirInfos) {
+		fprintf(out, "\t\t{\n");
+		SafeStr(out, "\t\t\tpath = ", di.path);
+		fprintf(out, "\t\t\tmodified = \"%u\",\n", di.modified);
+
+		if (!di.archives.empty()) {
+			fprintf(out, "\t\t\tarchives = {\n");
+			for (const std::string& name: di.archives) {
+				SafeStr(out, "\t\t\t\t", name);
+			}
+			fprintf(out, "\t\t\t},\n");
+		}
+		if (!di.subDirs.empty()) {
+			fprintf(out, "\t\t\tsubdirs = {\n");
+			for (const std::string& name: di.subDirs) {
+				SafeStr(out, "\t\t\t\t", name);
+			}
+			fprintf(out, "\t\t\t},\n");
+		}
+
+		fprintf(out, "\t\t},\n");
+	}
+
+	fprintf(out, "\t},\n"); // close 'dirs'
 	fprintf(out, "}\n\n"); // close 'archiveCache'
 	fprintf(out, "return archiveCache\n");
 
@@ -6,6 +6,7 @@
 #include <cstring> // memset
 #include <string>
 #include <deque>
+#include <exception>
 #include <vector>
 
 #include "System/Info.h"
@@ -184,6 +185,35 @@ private:
 		uint32_t modified = 0;
 		bool updated = false;
 	};
+	struct DirInfo {
+		std::string path;                  // with trailing separator
+		std::vector<std::string> archives; // names of the archives in this directory, in listing order
+		std::vector<std::string> subDirs;  // names of the directories to descend into, in listing order
+
+		uint32_t modified = 0;
+		bool updated = false;
+	};
+	// everything needed from an archive file to add it, gathered without touching scanner state
+	struct ArchiveScanData {
+		std::string fullName;
+		std::string luaInfoFile;      // {map,mod}info.lua if present
+		std::string archiveDataPath;  // path to luaInfoFile for .sdd's
+		std::string arMapFile;        // file in archive with "smf" extension
+		std::string compressionError;
+
+		std::vector<std::uint8_t> luaInfoData;
+		std::exception_ptr openError;
+
+		uint32_t modified = 0;
+		uint32_t modifiedArchiveData = 0;
+		int archiveType = -1;
+
+		bool isOpen = false;
+		bool hasMapInfo = false;
+		bool hasModInfo = false;
+		bool luaInfoRead = false;
+		bool compressionOK = false;
+	};
 
 private:
 	ArchiveInfo& GetAddArchiveInfo(const std::string& lcfn);
@@ -192,14 +222,28 @@ private:
 	void ScanDirs(const std::vector<std::string>& dirs);
 	void ScanDir(const std::string& curPath, std::deque<std::string>& foundArchives);
 
+	/**
+	 * Lists the archives and sub-directories of a directory, reusing
+	 * the cached listing if the directory has not been modified since.
+	 */
+	const DirInfo& GetDirInfo(const std::string& dirPath);
+
+	/**
+	 * Opens an archive and reads its meta-data; thread-safe, and
+	 * therefore used to process archives not found in the cache
+	 * concurrently.
+	 */
+	static void ReadArchiveScanData(ArchiveScanData& sd);
+	void AddArchiveScanData(ArchiveScanData& sd, bool doChecksum);
+
 	/// scan mapinfo / modinfo lua files
-	bool ScanArchiveLua(IArchive* ar, const std::string& fileName, ArchiveInfo& ai, std::string& err);
+	bool ScanArchiveLua(const ArchiveScanData& sd, ArchiveInfo& ai, std::string& err);
 
 	/**
 	 * scan archive for map file
 	 * @return file name if found, empty string if not
 	 */
-	std::string SearchMapFile(const IArchive* ar, std::string& error);
+	static std::string SearchMapFile(const IArchive* ar, std::string& error);
 
 
 	void ReadCacheData(const std::string& filename);
@@ -240,8 +284,11 @@ private:
 	spring::unordered_map<std::string, size_t> archiveInfosIndex;
 	spring::unordered_map<std::string, size_t> brokenArchivesIndex;
 
+	spring::unordered_map<std::string, size_t> dirInfosIndex;
+
 	std::vector<ArchiveInfo> archiveInfos;
 	std::vector<BrokenArchive> brokenArchives;
+	std::vector<DirInfo> dirInfos;
 
 	std::string cachefile;
 
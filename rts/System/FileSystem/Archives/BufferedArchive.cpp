@@ -7,8 +7,6 @@
 
 #include <cassert>
 
-spring::mutex CBufferedArchive::archiveLock;
-
 
 CBufferedArchive::~CBufferedArchive()
 {
@@ -21,49 +19,67 @@ CBufferedArchive::~CBufferedArchive()
 
 bool CBufferedArchive::GetFile(unsigned int fid, std::vector<std::uint8_t>& buffer)
 {
-	std::lock_guard<spring::mutex> lck(archiveLock);
 	assert(IsFileId(fid));
 
 	int ret = 0;
 
-	if (noCache) {
-		if ((ret = GetFileImpl(fid, buffer)) != 1)
-			LOG_L(L_WARNING, "[BufferedArchive::%s(fid=%u)][noCache] name=%s ret=%d size=" _STPF_, __func__, fid, archiveFile.c_str(), ret, buffer.size());
+	// engine-only
+	if (noCache || !globalConfig.vfsCacheArchiveFiles) {
+		{
+			std::lock_guard<spring::mutex> lck(fileLocks[fid % fileLocks.size()]);
+			ret = GetFileImpl(fid, buffer);
+		}
+
+		if (ret != 1)
+			LOG_L(L_WARNING, "[BufferedArchive::%s(fid=%u)][noCache=%d] name=%s ret=%d size=" _STPF_, __func__, fid, noCache, archiveFile.c_str(), ret, buffer.size());
 
 		return (ret == 1);
 	}
 
-	// engine-only
-	if (!globalConfig.vfsCacheArchiveFiles) {
-		if ((ret = GetFileImpl(fid, buffer)) != 1)
-			LOG_L(L_WARNING, "[BufferedArchive::%s(fid=%u)][!vfsCache] name=%s ret=%d size=" _STPF_, __func__, fid, archiveFile.c_str(), ret, buffer.size());
+	const auto GetCachedFile = [&](FileBuffer*& fb) {
+		std::lock_guard<spring::mutex> lck(cacheLock);
 
-		return (ret == 1);
-	}
+		// NumFiles is virtual, can't do this in ctor
+		if (fileCache.empty())
+			fileCache.resize(NumFiles());
+
+		// never resized again, so the reference stays valid outside the lock
+		fb = &fileCache.at(fid);
+		return fb->populated;
+	};
+
+	FileBuffer* fb = nullptr;
+
+	if (!GetCachedFile(fb)) {
+		std::lock_guard<spring::mutex> fileLck(fileLocks[fid % fileLocks.size()]);
+
+		// check again, another thread might have extracted it while we waited
+		if (!GetCachedFile(fb)) {
+			std::vector<std::uint8_t> data;
 
-	// NumFiles is virtual, can't do this in ctor
-	if (fileCache.empty())
-		fileCache.resize(NumFiles());
+			const bool exists = ((ret = GetFileImpl(fid, data)) == 1);
 
-	FileBuffer& fb = fileCache.at(fid);
+			std::lock_guard<spring::mutex> cacheLck(cacheLock);
 
-	if (!fb.populated) {
-		fb.exists = ((ret = GetFileImpl(fid, fb.data)) == 1);
-		fb.populated = true;
+			fb->data = std::move(data);
+			fb->exists = exists;
+			fb->populated = true;
 
-		cacheSize += fb.data.size();
-		fileCount += fb.exists;
+			cacheSize += fb->data.size();
+			fileCount += fb->exists;
+		}
 	}
 
-	if (!fb.exists) {
-		LOG_L(L_WARNING, "[BufferedArchive::%s(fid=%u)][!fb.exists] name=%s ret=%d size=" _STPF_, __func__, fid, archiveFile.c_str(), ret, fb.data.size());
+	// populated buffers are never modified again, no lock needed to read them
+	if (!fb->exists) {
+		LOG_L(L_WARNING, "[BufferedArchive::%s(fid=%u)][!fb.exists] name=%s ret=%d size=" _STPF_, __func__, fid, archiveFile.c_str(), ret, fb->data.size());
 		return false;
 	}
 
-	if (buffer.size() != fb.data.size())
-		buffer.resize(fb.data.size());
+	if (buffer.size() != fb->data.size())
+		buffer.resize(fb->data.size());
 
 	// TODO: zero-copy access
-	std::copy(fb.data.begin(), fb.data.end(), buffer.begin());
+	std::copy(fb->data.begin(), fb->data.end(), buffer.begin());
 	return true;
 }
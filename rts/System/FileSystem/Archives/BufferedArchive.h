@@ -6,9 +6,13 @@
 #include "IArchive.h"
 #include "System/Threading/SpringThreading.h"
 
+#include <array>
+
 /**
- * Provides a helper implementation for archive types that can only uncompress
- * one file to memory at a time.
+ * Provides a helper implementation for archive types that uncompress whole
+ * files to memory. Different files can be extracted by concurrent threads,
+ * so GetFileImpl must be thread-safe for distinct file-ids; extraction of the
+ * same file is serialized here.
  */
 class CBufferedArchive : public IArchive
 {
@@ -42,13 +46,13 @@ protected:
 
 	// indexed by file-id
 	std::vector<FileBuffer> fileCache;
-	// neither 7zip (.sd7) nor minizip (.sdz) are thread-safe
-	// zlib (used to extract pool archive .gz entries) should
-	// not need this, but currently each buffered GetFileImpl
-	// call is protected
-	static spring::mutex archiveLock;
 
 private:
+	// guards fileCache (populated-state) and the statistics below
+	spring::mutex cacheLock;
+	// striped by file-id, held while a file is being extracted
+	std::array<spring::mutex, 16> fileLocks;
+
 	uint32_t cacheSize = 0;
 	uint32_t fileCount = 0;
 
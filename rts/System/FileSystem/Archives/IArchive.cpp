@@ -39,3 +39,13 @@ bool IArchive::GetFile(const std::string& name, std::vector<std::uint8_t>& buffe
 	return true;
 }
 
+
+bool IArchive::GetFileView(const std::string& name, ArchiveFileView& view)
+{
+	const unsigned int fid = FindFile(name);
+
+	if (!IsFileId(fid))
+		return false;
+
+	return (GetFileView(fid, view));
+}
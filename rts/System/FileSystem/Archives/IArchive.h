@@ -11,6 +11,15 @@
 #include "System/Sync/SHA512.hpp"
 #include "System/UnorderedMap.hpp"
 
+/**
+ * Read-only window into the content of a file inside an archive.
+ * @see IArchive::GetFileView
+ */
+struct ArchiveFileView {
+	const std::uint8_t* data = nullptr;
+	size_t size = 0;
+};
+
 /**
  * @brief Abstraction of different archive types
  *
@@ -82,6 +91,22 @@ public:
 	 */
 	bool GetFile(const std::string& name, std::vector<std::uint8_t>& buffer);
 
+	/**
+	 * Fetches a view of the content of a file by its ID without copying it.
+	 * Only supported for (large) files the archive stores uncompressed,
+	 * callers have to fall back to GetFile if this returns false.
+	 * @param fid file ID in [0, NumFiles())
+	 * @param view on success, points to the contents of the file; these
+	 *   stay valid for as long as the archive is open
+	 * @return true if a view of the file could be provided
+	 */
+	virtual bool GetFileView(unsigned int fid, ArchiveFileView& view) { return false; }
+	/**
+	 * Fetches a view of the content of a file by its name.
+	 * @see GetFileView(unsigned int fid, ArchiveFileView& view)
+	 */
+	bool GetFileView(const std::string& name, ArchiveFileView& view);
+
 	std::pair<std::string, int> FileInfo(unsigned int fid) const {
 		std::pair<std::string, int> info;
 		FileInfo(fid, info.first, info.second);
@@ -0,0 +1,84 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+#include "System/Platform/Win/win32.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+CMemoryMappedFile::CMemoryMappedFile(const std::string& filePath)
+{
+	#ifdef _WIN32
+	const HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize;
+
+	// empty files can not be mapped
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	// the mapping keeps its own reference to the file
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+		return;
+
+	if ((data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))) == nullptr) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return;
+	}
+
+	size = fileSize.QuadPart;
+
+	#else
+
+	const int fd = open(filePath.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return;
+
+	struct stat st;
+
+	// empty files can not be mapped
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return;
+	}
+
+	// the mapping keeps its own reference to the file
+	void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (ptr == MAP_FAILED)
+		return;
+
+	data = static_cast<const std::uint8_t*>(ptr);
+	size = st.st_size;
+	#endif
+}
+
+CMemoryMappedFile::~CMemoryMappedFile()
+{
+	if (data == nullptr)
+		return;
+
+	#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mapping);
+	#else
+	munmap(const_cast<std::uint8_t*>(data), size);
+	#endif
+}
@@ -0,0 +1,36 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _MEMORY_MAPPED_FILE_H
+#define _MEMORY_MAPPED_FILE_H
+
+#include <cinttypes>
+#include <cstddef>
+#include <string>
+
+#include "System/Misc/NonCopyable.h"
+
+/**
+ * Read-only mapping of an entire (non-empty) file into memory.
+ * The contents are paged in by the OS on access, nothing is copied.
+ */
+class CMemoryMappedFile : public spring::noncopyable
+{
+public:
+	CMemoryMappedFile(const std::string& filePath);
+	~CMemoryMappedFile();
+
+	bool IsOpen() const { return (data != nullptr); }
+
+	const std::uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+private:
+	const std::uint8_t* data = nullptr;
+	size_t size = 0;
+
+	#ifdef _WIN32
+	void* mapping = nullptr;
+	#endif
+};
+
+#endif // _MEMORY_MAPPED_FILE_H
@@ -8,14 +8,28 @@
 #include <sstream>
 #include <string>
 #include <cassert>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <atomic>
+#include <list>
+#include <thread>
+
+#ifndef _WIN32
+	#include <unistd.h>
+#else
+	#include <process.h>
+#endif
 
 #include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/Exceptions.h"
+#include "System/GlobalConfig.h"
 #include "System/StringUtil.h"
+#include "System/UnorderedMap.hpp"
 #include "System/Log/ILog.h"
+#include "System/Threading/SpringThreading.h"
 
 
 CPoolArchiveFactory::CPoolArchiveFactory(): IArchiveFactory("sdp")
@@ -46,6 +60,184 @@ static bool gz_really_read(gzFile file, voidp buf, unsigned int len)
 
 
 
+typedef std::array<uint8_t, 16> PoolMD5;
+
+struct PoolMD5Hash {
+	// digests are uniformly distributed, any part of them is a good hash
+	size_t operator () (const PoolMD5& md5) const {
+		size_t h = 0;
+		std::memcpy(&h, md5.data(), sizeof(h));
+		return h;
+	}
+};
+
+/**
+ * Inflated pool files and their hashes, shared by all pool archives.
+ * Content is evicted in least-recently-used order once it exceeds the
+ * configured size (none by default, CBufferedArchive already keeps a
+ * copy per archive), hashes are small and kept until the process exits.
+ */
+class CPoolContentCache {
+public:
+	CPoolContentCache(size_t maxSize): maxContentSize(maxSize) {}
+
+	bool GetHash(const PoolMD5& md5, uint8_t* shasum) {
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		const auto it = hashes.find(md5);
+
+		if (it == hashes.end())
+			return false;
+
+		std::memcpy(shasum, it->second.data(), sha512::SHA_LEN);
+		return true;
+	}
+
+	bool GetContent(const PoolMD5& md5, std::vector<std::uint8_t>& buffer, uint8_t* shasum) {
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		const auto it = contents.find(md5);
+
+		if (it == contents.end())
+			return false;
+
+		lruOrder.splice(lruOrder.begin(), lruOrder, it->second.lruIter);
+
+		buffer.assign(it->second.data.begin(), it->second.data.end());
+		std::memcpy(shasum, hashes[md5].data(), sha512::SHA_LEN);
+		return true;
+	}
+
+	void AddContent(const PoolMD5& md5, const std::vector<std::uint8_t>& buffer, const uint8_t* shasum) {
+		std::lock_guard<spring::mutex> lck(mutex);
+
+		std::memcpy(hashes[md5].data(), shasum, sha512::SHA_LEN);
+
+		if (maxContentSize == 0 || buffer.size() > maxContentSize || contents.find(md5) != contents.end())
+			return;
+
+		while ((contentSize + buffer.size()) > maxContentSize) {
+			const auto it = contents.find(lruOrder.back());
+
+			contentSize -= it->second.data.size();
+			contents.erase(it);
+			lruOrder.pop_back();
+		}
+
+		lruOrder.push_front(md5);
+
+		ContentEntry& entry = contents[md5];
+		entry.data = buffer;
+		entry.lruIter = lruOrder.begin();
+
+		contentSize += buffer.size();
+	}
+
+private:
+	struct ContentEntry {
+		std::vector<std::uint8_t> data;
+		std::list<PoolMD5>::iterator lruIter;
+	};
+
+	spring::mutex mutex;
+
+	spring::unordered_map<PoolMD5, sha512::raw_digest, PoolMD5Hash> hashes;
+	spring::unordered_map<PoolMD5, ContentEntry, PoolMD5Hash> contents;
+
+	// most recently used first
+	std::list<PoolMD5> lruOrder;
+
+	size_t contentSize = 0;
+	size_t maxContentSize = 0;
+};
+
+static CPoolContentCache& GetPoolContentCache()
+{
+	static CPoolContentCache cache(size_t(std::max(globalConfig.vfsPoolContentCacheSize, 0)) * 1024 * 1024);
+	return cache;
+}
+
+
+// on-disk copies of inflated pool files are stored as their content followed by its hash,
+// which is verified against the content whenever a copy is read
+static std::string GetPoolDiskCopyName(const std::string& prefix, const std::string& pstfix)
+{
+	return (FileSystem::GetCacheBaseDir() + "/pool/" + prefix + "/" + pstfix);
+}
+
+static bool ReadPoolDiskCopy(const std::string& name, std::vector<std::uint8_t>& buffer, uint8_t* shasum)
+{
+	const std::string& absFileName = dataDirsAccess.LocateFile(name);
+
+	FILE* file = fopen(absFileName.c_str(), "rb");
+
+	if (file == nullptr)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	const long fileSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	bool readOk = (fileSize == long(buffer.size() + sha512::SHA_LEN));
+
+	readOk = readOk && (fread(buffer.data(), 1, buffer.size(), file) == buffer.size());
+	readOk = readOk && (fread(shasum, 1, sha512::SHA_LEN, file) == sha512::SHA_LEN);
+
+	fclose(file);
+
+	// the hash feeds archive checksums, so a damaged copy must not be trusted
+	if (readOk) {
+		sha512::raw_digest contentHash;
+		sha512::calc_digest(buffer.data(), buffer.size(), contentHash.data());
+
+		if (std::memcmp(contentHash.data(), shasum, sha512::SHA_LEN) == 0)
+			return true;
+	}
+
+	LOG_L(L_WARNING, "[PoolArchive::%s] removing corrupted pool-file copy \"%s\"", __func__, absFileName.c_str());
+
+	std::memset(shasum, 0, sha512::SHA_LEN);
+	std::remove(absFileName.c_str());
+	return false;
+}
+
+static int GetProcessID()
+{
+#ifndef _WIN32
+	return (getpid());
+#else
+	return (_getpid());
+#endif
+}
+
+static void WritePoolDiskCopy(const std::string& name, const std::vector<std::uint8_t>& buffer, const uint8_t* shasum)
+{
+	if (!FileSystem::CreateDirectory(FileSystem::GetDirectory(name)))
+		return;
+
+	// write to a temporary file first so concurrent readers never see partial data
+	const std::string& absFileName = dataDirsAccess.LocateFile(name, FileQueryFlags::WRITE);
+	// other processes may share the cache directory, other threads of ours may write the same copy
+	static std::atomic<int> numTmpFiles = {0};
+
+	const std::string& tmpFileName = absFileName + ".tmp" + IntToString(GetProcessID()) + "." + IntToString(numTmpFiles++);
+
+	FILE* file = fopen(tmpFileName.c_str(), "wb");
+
+	if (file == nullptr)
+		return;
+
+	bool writeOk = (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+	writeOk = writeOk && (fwrite(shasum, 1, sha512::SHA_LEN, file) == sha512::SHA_LEN);
+
+	fclose(file);
+
+	if (!writeOk || std::rename(tmpFileName.c_str(), absFileName.c_str()) != 0)
+		std::remove(tmpFileName.c_str());
+}
+
+
+
 CPoolArchive::CPoolArchive(const std::string& name): CBufferedArchive(name)
 {
 	memset(&dummyFileHash, 0, sizeof(dummyFileHash));
@@ -148,8 +340,26 @@ int CPoolArchive::GetFileImpl(unsigned int fid, std::vector<std::uint8_t>& buffe
 
 
 	buffer.clear();
+
+	// content of other archives (e.g. the previous version of a game) might already have been inflated
+	if (GetPoolContentCache().GetContent(f->md5sum, buffer, f->shasum.data()) && buffer.size() == f->size) {
+		s->readTime = (spring_now() - startTime).toNanoSecsi();
+		return 1;
+	}
+
+	const std::string& diskCopyName = GetPoolDiskCopyName(prefix, pstfix);
+
 	buffer.resize(f->size);
 
+	if (globalConfig.vfsPoolContentDiskCache) {
+		if (ReadPoolDiskCopy(diskCopyName, buffer, f->shasum.data())) {
+			GetPoolContentCache().AddContent(f->md5sum, buffer, f->shasum.data());
+
+			s->readTime = (spring_now() - startTime).toNanoSecsi();
+			return 1;
+		}
+	}
+
 	const auto GzRead = [&f, &path, &buffer](bool report) -> int {
 		gzFile in = gzopen(path.c_str(), "rb");
 
@@ -198,5 +408,27 @@ int CPoolArchive::GetFileImpl(unsigned int fid, std::vector<std::uint8_t>& buffe
 	}
 
 	sha512::calc_digest(buffer.data(), buffer.size(), f->shasum.data());
+	GetPoolContentCache().AddContent(f->md5sum, buffer, f->shasum.data());
+
+	if (globalConfig.vfsPoolContentDiskCache)
+		WritePoolDiskCopy(diskCopyName, buffer, f->shasum.data());
+
 	return 1;
 }
+
+bool CPoolArchive::CalcHash(uint32_t fid, uint8_t hash[sha512::SHA_LEN], std::vector<std::uint8_t>& fb)
+{
+	assert(IsFileId(fid));
+
+	FileData& fd = files[fid];
+
+	// pool-entry hashes are not calculated until GetFileImpl, must check JIT
+	// unless another archive already read an entry with the same content
+	if (memcmp(fd.shasum.data(), dummyFileHash.data(), sizeof(fd.shasum)) == 0) {
+		if (!GetPoolContentCache().GetHash(fd.md5sum, fd.shasum.data()))
+			GetFileImpl(fid, fb);
+	}
+
+	memcpy(hash, fd.shasum.data(), sha512::SHA_LEN);
+	return (memcmp(fd.shasum.data(), dummyFileHash.data(), sizeof(fd.shasum)) != 0);
+}
@@ -70,6 +70,10 @@ private:
  * The 16-byte MD5 digest is the reference to the 32 hex-char filename
  * under pool/ which contains the content.
  *
+ * Since versions of the same game share most of their pool files, inflated
+ * files and their hashes are kept in a process-wide cache keyed by MD5 and
+ * reused by every archive referencing the same content.
+ *
  * @author Chris Clearwater (det) <chris@detrino.org>
  */
 class CPoolArchive : public CBufferedArchive
@@ -88,18 +92,7 @@ public:
 		name = files[fid].name;
 		size = files[fid].size;
 	}
-	bool CalcHash(uint32_t fid, uint8_t hash[sha512::SHA_LEN], std::vector<std::uint8_t>& fb) override {
-		assert(IsFileId(fid));
-
-		const FileData& fd = files[fid];
-
-		// pool-entry hashes are not calculated until GetFileImpl, must check JIT
-		if (memcmp(fd.shasum.data(), dummyFileHash.data(), sizeof(fd.shasum)) == 0)
-			GetFileImpl(fid, fb);
-
-		memcpy(hash, fd.shasum.data(), sha512::SHA_LEN);
-		return (memcmp(fd.shasum.data(), dummyFileHash.data(), sizeof(fd.shasum)) != 0);
-	}
+	bool CalcHash(uint32_t fid, uint8_t hash[sha512::SHA_LEN], std::vector<std::uint8_t>& fb) override;
 
 protected:
 	int GetFileImpl(unsigned int fid, std::vector<std::uint8_t>& buffer) override;
@@ -55,6 +55,10 @@ private:
 
 	std::vector<FileEntry> fileEntries;
 
+	// the decoder state and the cached (solid) block below are shared
+	// by all files, extraction from one archive is therefore serialized
+	spring::mutex decoderLock;
+
 	UInt32 blockIndex = 0xFFFFFFFF;
 	size_t outBufferSize = 0;
 	Byte* outBuffer = nullptr;
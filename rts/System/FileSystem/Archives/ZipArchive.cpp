@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cassert>
+#include <zlib.h>
 
 #include "System/StringUtil.h"
 #include "System/Log/ILog.h"
@@ -19,8 +20,6 @@ IArchive* CZipArchiveFactory::DoCreateArchive(const std::string& filePath) const
 
 CZipArchive::CZipArchive(const std::string& archiveName): CBufferedArchive(archiveName)
 {
-	std::lock_guard<spring::mutex> lck(archiveLock);
-
 	if ((zip = unzOpen(archiveName.c_str())) == nullptr) {
 		LOG_L(L_ERROR, "[%s] error opening \"%s\"", __func__, archiveName.c_str());
 		return;
@@ -55,20 +54,47 @@ CZipArchive::CZipArchive(const std::string& archiveName): CBufferedArchive(archi
 		fd.size = info.uncompressed_size;
 		fd.origName = fName;
 		fd.crc = info.crc;
+		fd.stored = (info.compression_method == 0 && (info.flag & 1) == 0 && info.compressed_size == info.uncompressed_size);
 
 		lcNameIndex.emplace(StringToLower(fd.origName), fileEntries.size());
 		fileEntries.emplace_back(std::move(fd));
 	}
+
+	zipHandles.push_back(zip);
 }
 
 CZipArchive::~CZipArchive()
 {
-	std::lock_guard<spring::mutex> lck(archiveLock);
+	// all readers are done, so every handle (including zip) is idle
+	for (unzFile handle: zipHandles) {
+		unzClose(handle);
+	}
+
+	zipHandles.clear();
+	zip = nullptr;
+}
 
-	if (zip != nullptr) {
-		unzClose(zip);
-		zip = nullptr;
+
+unzFile CZipArchive::AcquireHandle()
+{
+	{
+		std::lock_guard<spring::mutex> lck(zipHandlesLock);
+
+		if (!zipHandles.empty()) {
+			unzFile handle = zipHandles.back();
+			zipHandles.pop_back();
+			return handle;
+		}
 	}
+
+	// more concurrent readers than ever before, open another handle
+	return (unzOpen(archiveFile.c_str()));
+}
+
+void CZipArchive::ReleaseHandle(unzFile handle)
+{
+	std::lock_guard<spring::mutex> lck(zipHandlesLock);
+	zipHandles.push_back(handle);
 }
 
 
@@ -81,36 +107,102 @@ void CZipArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
 }
 
 
+bool CZipArchive::GetFileView(unsigned int fid, ArchiveFileView& view)
+{
+	if (zip == nullptr)
+		return false;
+
+	assert(IsFileId(fid));
+
+	const FileEntry& fe = fileEntries[fid];
+
+	// compressed entries have to be extracted into a buffer, empty ones have no data
+	if (!fe.stored || fe.size <= 0)
+		return false;
+
+	std::lock_guard<spring::mutex> lck(mappedArchiveLock);
+
+	if (mappedArchive == nullptr) {
+		mappedArchive = std::make_unique<CMemoryMappedFile>(archiveFile);
+		storedDataOffsets.resize(fileEntries.size(), 0);
+	}
+
+	if (!mappedArchive->IsOpen())
+		return false;
+
+	if (storedDataOffsets[fid] == 0) {
+		// the local header has a variable size, let minizip parse it
+		unzFile handle = AcquireHandle();
+
+		if (handle == nullptr)
+			return false;
+
+		unzGoToFilePos(handle, &fileEntries[fid].fp);
+
+		if (unzOpenCurrentFile2(handle, nullptr, nullptr, 1) == UNZ_OK) {
+			storedDataOffsets[fid] = unzGetCurrentFileZStreamPos64(handle);
+			unzCloseCurrentFile(handle);
+		}
+
+		ReleaseHandle(handle);
+
+		// GetFileImpl rejects entries failing their CRC, views must do the same;
+		// checked once, a rejected entry keeps going through the buffered path
+		if (storedDataOffsets[fid] == 0 || (storedDataOffsets[fid] + fe.size) > mappedArchive->GetSize()) {
+			storedDataOffsets[fid] = INVALID_DATA_OFFSET;
+		} else if (crc32(0, mappedArchive->GetData() + storedDataOffsets[fid], fe.size) != fe.crc) {
+			LOG_L(L_WARNING, "[ZipArchive::%s] CRC mismatch for \"%s\" in \"%s\"", __func__, fe.origName.c_str(), archiveFile.c_str());
+			storedDataOffsets[fid] = INVALID_DATA_OFFSET;
+		}
+	}
+
+	if (storedDataOffsets[fid] == INVALID_DATA_OFFSET)
+		return false;
+
+	view.data = mappedArchive->GetData() + storedDataOffsets[fid];
+	view.size = fe.size;
+	return true;
+}
+
+
 // To simplify things, files are always read completely into memory from
 // the zip-file, since zlib does not provide any way of reading more
-// than one file at a time
+// than one file at a time (per handle)
 int CZipArchive::GetFileImpl(unsigned int fid, std::vector<std::uint8_t>& buffer)
 {
 	// Prevent opening files on missing/invalid archives
 	if (zip == nullptr)
 		return -4;
 
-	// assert(archiveLock.locked());
 	assert(IsFileId(fid));
 
-	unzGoToFilePos(zip, &fileEntries[fid].fp);
+	unzFile handle = AcquireHandle();
+
+	if (handle == nullptr)
+		return -4;
+
+	unzGoToFilePos(handle, &fileEntries[fid].fp);
 
 	unz_file_info fi;
-	unzGetCurrentFileInfo(zip, &fi, nullptr, 0, nullptr, 0, nullptr, 0);
+	unzGetCurrentFileInfo(handle, &fi, nullptr, 0, nullptr, 0, nullptr, 0);
 
-	if (unzOpenCurrentFile(zip) != UNZ_OK)
+	if (unzOpenCurrentFile(handle) != UNZ_OK) {
+		ReleaseHandle(handle);
 		return -3;
+	}
 
 	buffer.clear();
 	buffer.resize(fi.uncompressed_size);
 
 	int ret = 1;
 
-	if (!buffer.empty() && unzReadCurrentFile(zip, buffer.data(), buffer.size()) != buffer.size())
+	if (!buffer.empty() && unzReadCurrentFile(handle, buffer.data(), buffer.size()) != buffer.size())
 		ret -= 2;
-	if (unzCloseCurrentFile(zip) == UNZ_CRCERROR)
+	if (unzCloseCurrentFile(handle) == UNZ_CRCERROR)
 		ret -= 1;
 
+	ReleaseHandle(handle);
+
 	if (ret != 1)
 		buffer.clear();
 
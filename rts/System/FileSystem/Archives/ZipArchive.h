@@ -5,8 +5,10 @@
 
 #include "IArchiveFactory.h"
 #include "BufferedArchive.h"
+#include "MemoryMappedFile.h"
 #include "minizip/unzip.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -40,6 +42,8 @@ public:
 	unsigned int NumFiles() const override { return (fileEntries.size()); }
 	void FileInfo(unsigned int fid, std::string& name, int& size) const override;
 
+	bool GetFileView(unsigned int fid, ArchiveFileView& view) override;
+
 	#if 0
 	unsigned int GetCrc32(unsigned int fid) {
 		assert(IsFileId(fid));
@@ -47,19 +51,45 @@ public:
 	}
 	#endif
 
+protected:
+	unzFile AcquireHandle();
+	void ReleaseHandle(unzFile handle);
+
 protected:
 	unzFile zip;
 
+	// minizip keeps the current file and inflate state inside the handle,
+	// so every concurrent reader needs its own; idle ones are kept here
+	// (including <zip>)
+	std::vector<unzFile> zipHandles;
+	spring::mutex zipHandlesLock;
+
 	// actual data is in BufferedArchive
 	struct FileEntry {
 		unz_file_pos fp;
 		int size;
 		std::string origName;
 		unsigned int crc;
+
+		// true if not compressed (nor encrypted), such entries can be viewed in-place
+		bool stored;
 	};
 
 	std::vector<FileEntry> fileEntries;
 
+	// offsets of the data of stored entries within the archive, filled in on demand
+	// (0 if not yet looked up, INVALID_DATA_OFFSET if the entry can not be viewed)
+	//
+	// the mapping lives as long as the archive; unlike the files of .sdd's, an .sdz
+	// is never edited in place while in use (the open zip handles already keep it
+	// open and locked on Windows, and downloaders replace archives by renaming new
+	// files over them, which leaves existing mappings intact)
+	static constexpr ZPOS64_T INVALID_DATA_OFFSET = ~ZPOS64_T(0);
+
+	std::vector<ZPOS64_T> storedDataOffsets;
+	std::unique_ptr<CMemoryMappedFile> mappedArchive;
+	spring::mutex mappedArchiveLock;
+
 	int GetFileImpl(unsigned int fid, std::vector<std::uint8_t>& buffer) override;
 };
 
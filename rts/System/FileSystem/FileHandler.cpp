@@ -20,6 +20,7 @@
 #ifndef TOOLS
 	#include "VFSHandler.h"
 	#include "DataDirsAccess.h"
+	#include "Archives/IArchive.h"
 	#include "System/StringUtil.h"
 	#include "System/Platform/Misc.h"
 #endif
@@ -92,6 +93,14 @@ bool CFileHandler::TryReadFromVFS(const string& fileName, int section)
 	if (vfsHandler == nullptr)
 		return (loadCode = -2, false);
 
+	ArchiveFileView view;
+
+	if ((loadCode = vfsHandler->LoadFileView(StringToLower(fileName), view, (CVFSHandler::Section) section)) == 1) {
+		fileView = view.data;
+		fileSize = view.size;
+		return true;
+	}
+
 	if ((loadCode = vfsHandler->LoadFile(StringToLower(fileName), fileBuffer, (CVFSHandler::Section) section)) == 1) {
 		// capacity can exceed size if FH was used to open more than one file
 		// assert(fileBuffer.size() == fileBuffer.capacity());
@@ -130,6 +139,18 @@ void CFileHandler::Close()
 
 	ifs.close();
 	fileBuffer.clear();
+	fileView = nullptr;
+}
+
+std::vector<std::uint8_t>& CFileHandler::GetBuffer()
+{
+	// callers want to own (steal) the contents, so these have to be copied out of the archive
+	if (fileView != nullptr) {
+		fileBuffer.assign(fileView, fileView + fileSize);
+		fileView = nullptr;
+	}
+
+	return fileBuffer;
 }
 
 
@@ -173,15 +194,15 @@ int CFileHandler::Read(void* buf, int length)
 		return ifs.gcount();
 	}
 
-	if (fileBuffer.empty())
+	if (!IsBuffered())
 		return 0;
 
 	if ((length + filePos) > fileSize)
 		length = fileSize - filePos;
 
 	if (length > 0) {
-		assert(fileBuffer.size() >= (filePos + length));
-		memcpy(buf, &fileBuffer[filePos], length);
+		assert(fileView != nullptr || fileBuffer.size() >= (filePos + length));
+		memcpy(buf, GetBufferData() + filePos, length);
 		filePos += length;
 	}
 
@@ -218,7 +239,7 @@ void CFileHandler::Seek(int length, std::ios_base::seekdir where)
 		ifs.seekg(length, where);
 		return;
 	}
-	if (fileBuffer.empty())
+	if (!IsBuffered())
 		return;
 
 	switch (where) {
@@ -234,7 +255,7 @@ bool CFileHandler::Eof() const
 	if (ifs.is_open())
 		return ifs.eof();
 
-	if (!fileBuffer.empty())
+	if (IsBuffered())
 		return (filePos >= fileSize);
 
 	return true;
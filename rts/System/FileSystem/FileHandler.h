@@ -37,7 +37,9 @@ public:
 	// true if any of TryReadFrom{RawFS,PWD,VFS} succeed
 	bool FileExists() const { return (fileSize >= 0); }
 	// true if (and only if) TryReadFromVFS succeeds
-	bool IsBuffered() const { return (!fileBuffer.empty()); }
+	bool IsBuffered() const { return (fileView != nullptr || !fileBuffer.empty()); }
+	// true if the file contents are viewed in-place (without a copy) in its archive
+	bool IsMapped() const { return (fileView != nullptr); }
 
 	bool Eof() const;
 	int GetPos();
@@ -49,7 +51,10 @@ public:
 	static std::string GetFileAbsolutePath(const std::string& filePath, const std::string& modes);
 	static std::string GetArchiveContainingFile(const std::string& filePath, const std::string& modes);
 
-	std::vector<std::uint8_t>& GetBuffer() { return fileBuffer; }
+	// copies the contents into the buffer first if the file is mapped
+	std::vector<std::uint8_t>& GetBuffer();
+	// contents of a buffered file, valid for FileSize() bytes while the file is open
+	const std::uint8_t* GetBufferData() const { return ((fileView != nullptr)? fileView: fileBuffer.data()); }
 
 	static bool InReadDir(const std::string& path);
 	static bool InWriteDir(const std::string& path);
@@ -79,6 +84,11 @@ protected:
 	std::ifstream ifs;
 	std::vector<std::uint8_t> fileBuffer;
 
+	// points into an archive instead of fileBuffer if the VFS could map the file;
+	// such a handler must be closed before its archive is removed from the VFS
+	// (e.g. by VFS.UnmapArchive), call GetBuffer to keep the contents past that
+	const std::uint8_t* fileView = nullptr;
+
 	int filePos = 0;
 	int fileSize = -1;
 	int loadCode = -3; // {-1,0,1} if loaded from VFS
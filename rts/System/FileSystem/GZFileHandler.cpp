@@ -67,6 +67,12 @@ bool CGZFileHandler::UncompressBuffer()
 	std::vector<std::uint8_t> compressed;
 	std::swap(compressed, fileBuffer);
 
+	// the VFS may have mapped the file instead of filling fileBuffer
+	const std::uint8_t* compressedData = (fileView != nullptr)? fileView: compressed.data();
+	const size_t compressedSize = (fileView != nullptr)? fileSize: compressed.size();
+
+	// the uncompressed contents always go into fileBuffer
+	fileView = nullptr;
 
 	z_stream zstream;
 	zstream.opaque = Z_NULL;
@@ -77,8 +83,8 @@ bool CGZFileHandler::UncompressBuffer()
 	//+16 marks it's a gzip header
 	inflateInit2(&zstream, 15 + 16);
 
-	zstream.next_in   = &compressed[0];
-	zstream.avail_in  = compressed.size();
+	zstream.next_in   = const_cast<std::uint8_t*>(compressedData);
+	zstream.avail_in  = compressedSize;
 
 	std::uint8_t unzipBuffer[BUFFER_SIZE];
 
@@ -11,6 +11,7 @@
 #include "System/UnorderedMap.hpp"
 
 class IArchive;
+struct ArchiveFileView;
 
 /**
  * Main API for accessing the Virtual File System (VFS).
@@ -103,6 +104,15 @@ public:
 	 * @return 1 if the file exists in the VFS and was successfully read
 	 */
 	int LoadFile(const std::string& filePath, std::vector<std::uint8_t>& buffer, Section section);
+	/**
+	 * Provides a view of the contents of a file within the VFS without
+	 * copying them, if the archive containing it supports this.
+	 * @param filePath raw file path, for example "maps/myMap.smf",
+	 *   case-insensitive
+	 * @return 1 if the file exists in the VFS and a view was provided
+	 * @see IArchive::GetFileView
+	 */
+	int LoadFileView(const std::string& filePath, ArchiveFileView& view, Section section);
 
 
 	/**
@@ -59,6 +59,8 @@ CONFIG(bool, UseNetMessageSmoothingBuffer).defaultValue(true).description("Buffe
 
 CONFIG(bool, LuaWritableConfigFile).defaultValue(true);
 CONFIG(bool, VFSCacheArchiveFiles).defaultValue(true);
+CONFIG(int, VFSPoolContentCacheSize).defaultValue(0).minimumValue(0).description("Size in MB of the memory cache for inflated rapid pool files, shared by all pool archives referencing the same content. Hashes are always cached; content is also held by the per-archive file cache, so this is off by default.");
+CONFIG(bool, VFSPoolContentDiskCache).defaultValue(false).description("Store inflated copies of rapid pool files in the cache directory and read those instead of the compressed pool files.");
 
 CONFIG(bool, DumpGameStateOnDesync).defaultValue(false).description("Enable writing clientgamestate and servergamestate dumps when a desync is detected");
 
@@ -91,6 +93,8 @@ void GlobalConfig::Init()
 	useNetMessageSmoothingBuffer = configHandler->GetBool("UseNetMessageSmoothingBuffer");
 	luaWritableConfigFile = configHandler->GetBool("LuaWritableConfigFile");
 	vfsCacheArchiveFiles = configHandler->GetBool("VFSCacheArchiveFiles");
+	vfsPoolContentCacheSize = configHandler->GetInt("VFSPoolContentCacheSize");
+	vfsPoolContentDiskCache = configHandler->GetBool("VFSPoolContentDiskCache");
 
 	dumpGameStateOnDesync = configHandler->GetBool("DumpGameStateOnDesync");
 
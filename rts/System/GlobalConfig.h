@@ -106,6 +106,20 @@ public:
 	 */
 	bool vfsCacheArchiveFiles = true;
 
+	/**
+	 * @brief vfsPoolContentCacheSize
+	 *
+	 * Size in MB of the (process-wide) memory cache for inflated pool files
+	 */
+	int vfsPoolContentCacheSize = 0;
+
+	/**
+	 * @brief vfsPoolContentDiskCache
+	 *
+	 * Whether inflated pool files should also be stored in the cache directory
+	 */
+	bool vfsPoolContentDiskCache = false;
+
 	/**
 	 * @brief dumpGameStateOnDesync
 	 *
@@ -1,5 +1,10 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <sstream>
 #include <zlib.h>
 
@@ -37,17 +42,20 @@
 #include "Sim/Units/Scripts/NullUnitScript.h"
 #include "Sim/Weapons/PlasmaRepulser.h"
 #include "System/SafeUtil.h"
+#include "System/UnorderedMap.hpp"
 #include "System/Platform/errorhandler.h"
 #include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
-#include "System/FileSystem/GZFileHandler.h"
 #include "System/Threading/ThreadPool.h"
+#include "System/creg/MemoryStream.h"
 #include "System/creg/SerializeLuaState.h"
 #include "System/creg/Serializer.h"
 #include "System/Exceptions.h"
 #include "System/Log/ILog.h"
 
 #define MAX_STRING_SIZE (1 << 19) // 512kB excluding null-term
+#define SAVE_COMPRESSION_LEVEL 5
 
 
 CCregLoadSaveHandler::CCregLoadSaveHandler()
@@ -103,8 +111,7 @@ void CGameStateCollector::Serialize(creg::ISerializer* s)
 	s->SerializeObjectInstance(&commandDescriptionCache, commandDescriptionCache.GetClass());
 	CSkirmishAIHandler::SerializeSkirmishAIHandler(s);
 	s->SerializeObjectInstance(eoh, eoh->GetClass());
-	std::unique_ptr<creg::IType> mapType = creg::DeduceType<decltype(CSplitLuaHandle::gameParams)>::Get();
-	mapType->Serialize(s, &CSplitLuaHandle::gameParams);
+	s->SerializeObjectInstance(&CSplitLuaHandle::gameParams, CSplitLuaHandle::gameParams.GetClass());
 
 	s->SerializeObjectInstance(CUnitDrawer::modelDrawerData->GetSavedData(), CUnitDrawer::modelDrawerData->GetSavedData()->GetClass());
 }
@@ -199,26 +206,75 @@ static void PrintSize(const char* txt, int size)
 		LOG("%s %u B",    txt, size);
 	}
 }
+
+// deflates <src> into a self-contained gzip member; members
+// stored back-to-back read as one continuous stream via gzread
+static void CompressSection(const std::vector<char>& src, std::vector<std::uint8_t>& dst)
+{
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+
+	if (deflateInit2(&zs, SAVE_COMPRESSION_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		throw std::runtime_error("[creg::CompressSection] deflateInit2 failed");
+
+	constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+	size_t srcPos = 0;
+	size_t dstSize = 0;
+	int flush = Z_NO_FLUSH;
+
+	do {
+		const size_t numRead = std::min(src.size() - srcPos, CHUNK_SIZE);
+
+		flush = ((srcPos += numRead) == src.size())? Z_FINISH: Z_NO_FLUSH;
+		zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src.data() + srcPos - numRead));
+		zs.avail_in = numRead;
+
+		do {
+			dst.resize(dstSize + CHUNK_SIZE);
+
+			zs.next_out = &dst[dstSize];
+			zs.avail_out = CHUNK_SIZE;
+
+			deflate(&zs, flush);
+			dstSize += (CHUNK_SIZE - zs.avail_out);
+		} while (zs.avail_out == 0);
+	} while (flush != Z_FINISH);
+
+	deflateEnd(&zs);
+	dst.resize(dstSize);
+}
 #endif //USING_CREG
 
-static void ReadString(std::istream& s, std::string& str)
+static void ReadString(gzFile file, std::string& str)
 {
-	char cstr[MAX_STRING_SIZE + 1];
-	s.getline(cstr, sizeof(cstr) - 1, 0);
 	str.clear();
-	str.append(cstr);
-}
 
+	for (int c = gzgetc(file); c > 0 && str.size() < MAX_STRING_SIZE; c = gzgetc(file)) {
+		str.push_back(c);
+	}
+}
 
-static void SaveLuaState(CSplitLuaHandle* handle, creg::COutputStreamSerializer& os, std::stringstream& oss)
+static void ReadUInt(gzFile file, std::uint64_t& val)
 {
-	CLuaStateCollector lsc;
-	lsc.Read(handle);
-	os.SavePackage(&oss, &lsc, lsc.GetClass());
+	// same encoding as creg::WriteUInt
+	val = 0;
+
+	for (unsigned int offset = 0; offset < 64; offset += 7) {
+		const int c = gzgetc(file);
+
+		if (c < 0)
+			break;
+
+		val += (std::uint64_t(c & 0x7F) << offset);
+
+		if ((c & 0x80) == 0)
+			break;
+	}
 }
 
 
-static void LoadLuaState(CSplitLuaHandle* handle, creg::CInputStreamSerializer& is, std::stringstream& iss)
+static void LoadLuaState(CSplitLuaHandle* handle, creg::CInputStreamSerializer& is, std::istream& iss)
 {
 	void* plsc;
 	creg::Class* plsccls = nullptr;
@@ -236,6 +292,104 @@ static void LoadLuaState(CSplitLuaHandle* handle, creg::CInputStreamSerializer&
 }
 
 
+typedef std::array<std::vector<char>, CCregLoadSaveHandler::SAVE_SECTION_COUNT> SaveSections;
+
+// uncompressed save kept in memory under its (pseudo) file-name
+struct SimSnapshot {
+	std::string scriptText;
+	std::string modName;
+	std::string mapName;
+
+	SaveSections sections;
+};
+
+// persists across reloads, which is how snapshots are restored
+static spring::unordered_map<std::string, SimSnapshot> simSnapshots;
+
+static bool IsSnapshotFile(const std::string& path) { return (FileSystem::GetExtension(path) == "ssnap"); }
+
+bool CCregLoadSaveHandler::HasSnapshot(const std::string& path) { return (simSnapshots.find(path) != simSnapshots.end()); }
+
+
+#ifdef USING_CREG
+typedef std::array<std::uint64_t, CCregLoadSaveHandler::SAVE_SECTION_COUNT> SaveSectionSizes;
+typedef std::array<std::vector<std::uint8_t>, 1 + CCregLoadSaveHandler::SAVE_SECTION_COUNT> SaveFileMembers;
+
+// serializes the synced state into <sections>; if <members> is given each
+// section is compressed into it as soon as it is complete and then freed
+static void SerializeSections(SaveSections& sections, SaveSectionSizes& sectionSizes, SaveFileMembers* members)
+{
+	std::array<std::exception_ptr, CCregLoadSaveHandler::SAVE_SECTION_COUNT> sectionErrors;
+
+	// collecting runs a full GC pass, keep it on the main thread
+	CLuaStateCollector gaiaLSC;
+	CLuaStateCollector rulesLSC;
+	gaiaLSC.Read(luaGaia);
+	rulesLSC.Read(luaRules);
+
+	// AIs can call back into the engine, so save them before the
+	// other sections are serialized concurrently
+	{
+		creg::CMemoryWriteBuf aiBuf(sections[CCregLoadSaveHandler::SAVE_SECTION_AI]);
+		std::ostream aiStream(&aiBuf);
+
+		for (const auto& ai: skirmishAIHandler.GetAllSkirmishAIs()) {
+			std::stringstream aiData;
+			eoh->Save(&aiData, ai.first);
+
+			const std::string aiBlob = aiData.str();
+			creg::WriteUInt(&aiStream, aiBlob.size());
+			aiStream.write(aiBlob.data(), aiBlob.size());
+		}
+	}
+
+	// each section gets its own serializer; the Lua states share one
+	// task since creg's Lua serialization keeps static context
+	for_mt(0, CCregLoadSaveHandler::SAVE_SECTION_COUNT, [&](const int i) {
+		try {
+			creg::CMemoryWriteBuf sectionBuf(sections[i]);
+			std::ostream sectionStream(&sectionBuf);
+
+			switch (i) {
+				case CCregLoadSaveHandler::SAVE_SECTION_LUA: {
+					creg::COutputStreamSerializer os;
+					os.SavePackage(&sectionStream, &gaiaLSC, gaiaLSC.GetClass());
+					os.SavePackage(&sectionStream, &rulesLSC, rulesLSC.GetClass());
+				} break;
+				case CCregLoadSaveHandler::SAVE_SECTION_GAME: {
+					creg::COutputStreamSerializer os;
+					CGameStateCollector gsc;
+					os.SavePackage(&sectionStream, &gsc, gsc.GetClass());
+				} break;
+				default: {
+				} break;
+			}
+
+			sectionSizes[i] = sections[i].size();
+
+			if (members == nullptr)
+				return;
+
+			CompressSection(sections[i], (*members)[1 + i]);
+			// release the uncompressed data before the other sections are done
+			sections[i] = std::vector<char>();
+		} catch (...) {
+			sectionErrors[i] = std::current_exception();
+		}
+	});
+
+	for (const std::exception_ptr& sectionError: sectionErrors) {
+		if (sectionError != nullptr)
+			std::rethrow_exception(sectionError);
+	}
+
+	PrintSize("Lua", sectionSizes[CCregLoadSaveHandler::SAVE_SECTION_LUA]);
+	PrintSize("Game", sectionSizes[CCregLoadSaveHandler::SAVE_SECTION_GAME]);
+	PrintSize("AIs", sectionSizes[CCregLoadSaveHandler::SAVE_SECTION_AI]);
+}
+#endif //USING_CREG
+
+
 void CCregLoadSaveHandler::SaveGame(const std::string& path)
 {
 #ifdef USING_CREG
@@ -246,67 +400,63 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 	selectedUnitsHandler.ClearSelected();
 
 	try {
-		std::stringstream oss;
+		SaveSections sections;
+		SaveSectionSizes sectionSizes = {};
+
+		if (IsSnapshotFile(path)) {
+			SerializeSections(sections, sectionSizes, nullptr);
+
+			SimSnapshot& snapshot = simSnapshots[path];
+			snapshot.scriptText = gameSetup->setupText;
+			snapshot.modName = modName;
+			snapshot.mapName = mapName;
+			snapshot.sections = std::move(sections);
+			return;
+		}
 
-		// write our own header. SavePackage() will add its own
-		WriteString(oss, SpringVersion::GetSync());
-		WriteString(oss, gameSetup->setupText);
-		WriteString(oss, modName);
-		WriteString(oss, mapName);
+		// gzip member of the header followed by those of the sections
+		SaveFileMembers fileMembers;
 
+		SerializeSections(sections, sectionSizes, &fileMembers);
 
 		{
-			creg::COutputStreamSerializer os;
-
-			// save lua state first as lua unit scripts depend on it
-			const int luaStart = oss.tellp();
-			SaveLuaState(luaGaia, os, oss);
-			SaveLuaState(luaRules, os, oss);
-			PrintSize("Lua", ((int)oss.tellp()) - luaStart);
-
-			// save creg state
-			const int gameStart = oss.tellp();
-			CGameStateCollector gsc;
-			os.SavePackage(&oss, &gsc, gsc.GetClass());
-			PrintSize("Game", ((int)oss.tellp()) - gameStart);
-
-
-			// save AI state
-			const int aiStart = oss.tellp();
-
-			for (const auto& ai: skirmishAIHandler.GetAllSkirmishAIs()) {
-				std::stringstream aiData;
-				eoh->Save(&aiData, ai.first);
-
-				std::uint64_t aiSize = aiData.tellp();
-				creg::WriteUInt(&oss, aiSize);
-				if (aiSize > 0)
-					oss << aiData.rdbuf();
+			std::vector<char> header;
+			creg::CMemoryWriteBuf headerBuf(header);
+			std::ostream oss(&headerBuf);
+
+			// write our own header. SavePackage() will add its own
+			WriteString(oss, SpringVersion::GetSync());
+			WriteString(oss, gameSetup->setupText);
+			WriteString(oss, modName);
+			WriteString(oss, mapName);
+
+			// lets the loader inflate each section on its own
+			for (const std::uint64_t sectionSize: sectionSizes) {
+				creg::WriteUInt(&oss, sectionSize);
 			}
-			PrintSize("AIs", ((int)oss.tellp()) - aiStart);
+
+			CompressSection(header, fileMembers[0]);
 		}
 
 		{
-			gzFile file = gzopen(dataDirsAccess.LocateFile(path, FileQueryFlags::WRITE).c_str(), "wb5");
+			FILE* file = fopen(dataDirsAccess.LocateFile(path, FileQueryFlags::WRITE).c_str(), "wb");
 
 			if (file == nullptr) {
 				LOG_L(L_ERROR, "[LSH::%s] could not open save-file", __func__);
 				return;
 			}
 
-			std::string data = std::move(oss.str());
-			std::function<void(gzFile, std::string&&)> func = [](gzFile file, std::string&& data) {
-				gzwrite(file, data.c_str(), data.size());
-				gzflush(file, Z_FINISH);
-				gzclose(file);
+			std::function<void(FILE*, SaveFileMembers&&)> func = [](FILE* file, SaveFileMembers&& members) {
+				for (const auto& member: members) {
+					fwrite(member.data(), 1, member.size(), file);
+				}
+
+				fclose(file);
 			};
 
-			// gzFile is just a plain typedef (struct gzFile_s {}* gzFile), can be copied
 			// need to keep a reference to the future around or its destructor will block
-			ThreadPool::AddExtJob(std::move(std::async(std::launch::async, std::move(func), file, std::move(data))));
+			ThreadPool::AddExtJob(std::move(std::async(std::launch::async, std::move(func), file, std::move(fileMembers))));
 		}
-
-		//FIXME add lua state
 	} catch (const content_error& ex) {
 		LOG_L(L_ERROR, "[LSH::%s] content error \"%s\"", __func__, ex.what());
 	} catch (const std::exception& ex) {
@@ -326,18 +476,20 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 /// loads the data (map&mod-name,setup-script) needed by PreGame
 bool CCregLoadSaveHandler::LoadGameStartInfo(const std::string& path)
 {
-	CGZFileHandler saveFile(dataDirsAccess.LocateFile(FindSaveFile(path)), SPRING_VFS_RAW_FIRST);
+	if (IsSnapshotFile(path))
+		return (LoadSnapshotStartInfo(path));
+
+	gzFile file = gzopen(dataDirsAccess.LocateFile(FindSaveFile(path)).c_str(), "rb");
+
+	if (file == nullptr) {
+		LOG_L(L_ERROR, "[LSH::%s] could not open save-file \"%s\"", __func__, path.c_str());
+		return false;
+	}
 
-	std::stringbuf* sbuf = iss.rdbuf();
 	std::string saveVersion;
 	std::string syncVersion = SpringVersion::GetSync();
 
-	char buf[4096];
-	int len;
-	while ((len = saveFile.Read(buf, sizeof(buf))) > 0)
-		sbuf->sputn(buf, len);
-
-	ReadString(iss, saveVersion);
+	ReadString(file, saveVersion);
 
 	// check saved engine version against current build
 	// in general these will *not* be binary-compatible
@@ -346,14 +498,88 @@ bool CCregLoadSaveHandler::LoadGameStartInfo(const std::string& path)
 		LOG_L(L_WARNING, "[LSH::%s][release=%d] file \"%s\" saved by engine version \"%s\" incompatible with \"%s\"", __func__, SpringVersion::IsRelease(), path.c_str(), saveVersion.c_str(), syncVersion.c_str());
 
 	// read our own header
-	ReadString(iss, scriptText);
-	ReadString(iss, modName);
-	ReadString(iss, mapName);
+	ReadString(file, scriptText);
+	ReadString(file, modName);
+	ReadString(file, mapName);
+
+	std::array<std::uint64_t, SAVE_SECTION_COUNT> sectionSizes = {};
+	std::array<std::promise<std::vector<char>>, SAVE_SECTION_COUNT> sectionPromises;
+
+	for (size_t i = 0; i < sectionSizes.size(); i++) {
+		ReadUInt(file, sectionSizes[i]);
+		sections[i] = sectionPromises[i].get_future();
+	}
+
+	// inflate the sections while PreGame loads the map and game archives
+	sectionReader = std::async(std::launch::async, [file, sectionSizes, sectionPromises = std::move(sectionPromises)]() mutable {
+		size_t i = 0;
+
+		try {
+			for (; i < sectionPromises.size(); i++) {
+				std::vector<char> data(sectionSizes[i]);
+
+				for (size_t n = 0; n < data.size(); ) {
+					const int numRead = gzread(file, data.data() + n, std::min(data.size() - n, size_t(1) << 30));
+
+					if (numRead <= 0)
+						throw content_error("[LSH::LoadGameStartInfo] save-file is truncated");
+
+					n += numRead;
+				}
+
+				sectionPromises[i].set_value(std::move(data));
+			}
+		} catch (...) {
+			// later sections can not be located without this one
+			for (; i < sectionPromises.size(); i++) {
+				sectionPromises[i].set_exception(std::current_exception());
+			}
+		}
+
+		gzclose(file);
+	});
 
 	CGameSetup::LoadSavedScript(path, scriptText);
 	return (saveVersion == syncVersion);
 }
 
+
+/// fills the sections from a snapshot taken in this process
+bool CCregLoadSaveHandler::LoadSnapshotStartInfo(const std::string& path)
+{
+	const auto it = simSnapshots.find(path);
+
+	if (it == simSnapshots.end()) {
+		LOG_L(L_ERROR, "[LSH::%s] no snapshot \"%s\" was taken", __func__, path.c_str());
+		return false;
+	}
+
+	const SimSnapshot& snapshot = it->second;
+
+	scriptText = snapshot.scriptText;
+	modName = snapshot.modName;
+	mapName = snapshot.mapName;
+
+	// copied, a snapshot can be restored any number of times
+	for (size_t i = 0; i < snapshot.sections.size(); i++) {
+		std::promise<std::vector<char>> sectionPromise;
+		sectionPromise.set_value(snapshot.sections[i]);
+		sections[i] = sectionPromise.get_future();
+	}
+
+	CGameSetup::LoadSavedScript(path, scriptText);
+	return true;
+}
+
+/// blocks until section <i> has been inflated, rethrows read errors
+std::vector<char> CCregLoadSaveHandler::GetSection(unsigned int i)
+{
+	if (!sections[i].valid())
+		throw content_error("[LSH::GetSection] save-file section is not available");
+
+	return (sections[i].get());
+}
+
 /// this should be called on frame 0 when the game has started
 void CCregLoadSaveHandler::LoadGame()
 {
@@ -362,20 +588,31 @@ void CCregLoadSaveHandler::LoadGame()
 	{
 		creg::CInputStreamSerializer inputStream;
 
-		// load lua state first, as lua unit scripts depend on it
-		LoadLuaState(luaGaia, inputStream, iss);
-		LoadLuaState(luaRules, inputStream, iss);
+		{
+			// load lua state first, as lua unit scripts depend on it
+			std::vector<char> luaData = GetSection(SAVE_SECTION_LUA);
+			creg::CMemoryReadBuf luaBuf(luaData.data(), luaData.data() + luaData.size());
+			std::istream luaStream(&luaBuf);
 
-		// load creg state
-		void* pGSC = nullptr;
-		creg::Class* gsccls = nullptr;
+			LoadLuaState(luaGaia, inputStream, luaStream);
+			LoadLuaState(luaRules, inputStream, luaStream);
+		}
+		{
+			// load creg state
+			std::vector<char> gameData = GetSection(SAVE_SECTION_GAME);
+			creg::CMemoryReadBuf gameBuf(gameData.data(), gameData.data() + gameData.size());
+			std::istream gameStream(&gameBuf);
 
-		inputStream.LoadPackage(&iss, pGSC, gsccls);
-		assert(pGSC && gsccls == CGameStateCollector::StaticClass());
+			void* pGSC = nullptr;
+			creg::Class* gsccls = nullptr;
 
-		// the only job of gsc is to collect gamestate data
-		CGameStateCollector* gsc = static_cast<CGameStateCollector*>(pGSC);
-		spring::SafeDelete(gsc);
+			inputStream.LoadPackage(&gameStream, pGSC, gsccls);
+			assert(pGSC && gsccls == CGameStateCollector::StaticClass());
+
+			// the only job of gsc is to collect gamestate data
+			CGameStateCollector* gsc = static_cast<CGameStateCollector*>(pGSC);
+			spring::SafeDelete(gsc);
+		}
 	}
 
 	LEAVE_SYNCED_CODE();
@@ -390,21 +627,28 @@ void CCregLoadSaveHandler::LoadAIData()
 #ifdef USING_CREG
 	ENTER_SYNCED_CODE();
 
+	std::vector<char> aiData = GetSection(SAVE_SECTION_AI);
+	creg::CMemoryReadBuf aiBuf(aiData.data(), aiData.data() + aiData.size());
+	std::istream aiStream(&aiBuf);
+
 	// load ai state
 	for (const auto& ai: skirmishAIHandler.GetAllSkirmishAIs()) {
 		std::uint64_t aiSize;
-		creg::ReadUInt(&iss, &aiSize);
+		creg::ReadUInt(&aiStream, &aiSize);
 
-		std::vector<char> buffer(aiSize);
-		std::stringstream aiData;
-		iss.read(buffer.data(), buffer.size());
-		aiData.write(buffer.data(), buffer.size());
+		const size_t aiBeg = aiStream.tellg();
+		const size_t aiEnd = aiBeg + aiSize;
 
-		eoh->Load(&aiData, ai.first);
-	}
+		if (!aiStream || aiEnd > aiData.size())
+			throw content_error("[LSH::LoadAIData] save-file AI data is truncated");
+
+		// each AI reads from a view of its own blob
+		creg::CMemoryReadBuf blobBuf(aiData.data() + aiBeg, aiData.data() + aiEnd);
+		std::istream blobStream(&blobBuf);
 
-	// cleanup
-	iss.str("");
+		eoh->Load(&blobStream, ai.first);
+		aiStream.seekg(aiEnd);
+	}
 
 	gs->paused = false;
 	if (gameServer != nullptr) {
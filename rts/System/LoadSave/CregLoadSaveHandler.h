@@ -3,8 +3,10 @@
 #ifndef CREG_LOAD_SAVE_HANDLER_H
 #define CREG_LOAD_SAVE_HANDLER_H
 
+#include <array>
+#include <future>
 #include <string>
-#include <sstream>
+#include <vector>
 #include "LoadSaveHandler.h"
 
 class CCregLoadSaveHandler : public ILoadSaveHandler
@@ -18,8 +20,31 @@ public:
 	void LoadAIData() override;
 	void SaveGame(const std::string& path) override;
 
+	/// true if a snapshot was saved under <path> in this process
+	static bool HasSnapshot(const std::string& path);
+
+public:
+	// independent parts of a save, serialized concurrently and
+	// each stored as its own gzip member (in this order) after
+	// the header
+	enum {
+		SAVE_SECTION_LUA   = 0, // LuaGaia and LuaRules states
+		SAVE_SECTION_GAME  = 1, // creg game state
+		SAVE_SECTION_AI    = 2, // Skirmish AI data
+		SAVE_SECTION_COUNT = 3,
+	};
+
+protected:
+	bool LoadSnapshotStartInfo(const std::string& path);
+
+	std::vector<char> GetSection(unsigned int i);
+
 protected:
-	std::stringstream iss;
+	// filled in file order by <sectionReader>, which starts inflating
+	// in LoadGameStartInfo so sections are ready (or nearly so) when
+	// LoadGame and LoadAIData parse them
+	std::array<std::future<std::vector<char>>, SAVE_SECTION_COUNT> sections;
+	std::future<void> sectionReader;
 };
 
 #endif // CREG_LOAD_SAVE_HANDLER_H
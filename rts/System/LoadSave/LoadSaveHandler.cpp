@@ -16,6 +16,9 @@ ILoadSaveHandler* ILoadSaveHandler::CreateHandler(const std::string& saveFile)
 
 	if (ext == "ssf")
 		return (new CCregLoadSaveHandler());
+	// in-memory snapshot, never written to disk
+	if (ext == "ssnap")
+		return (new CCregLoadSaveHandler());
 	if (ext == "slsf")
 		return (new CLuaLoadSaveHandler());
 
@@ -0,0 +1,262 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef RING_DEQUE_H
+#define RING_DEQUE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace spring {
+	// double-ended queue stored in a single power-of-two sized ring-buffer
+	//
+	// compared to std::deque, elements are contiguous (save for one wrap
+	// around) and inserting or erasing in the middle moves the elements on
+	// the nearer side only; iterators hold absolute positions and stay valid
+	// under push_* and pop_* (except for popped elements), while references
+	// additionally become invalid when the buffer grows
+	//
+	// slots outside [head, head + count) hold default-constructed elements
+	template<typename T>
+	class ring_deque {
+	public:
+		typedef T value_type;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T& reference;
+		typedef const T& const_reference;
+
+		template<typename Q, typename V>
+		class iterator_base {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef T value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef V* pointer;
+			typedef V& reference;
+
+			iterator_base() = default;
+			iterator_base(Q* q, size_type p): queue(q), pos(p) {}
+
+			// iterator to const_iterator
+			template<typename OQ, typename OV>
+			iterator_base(const iterator_base<OQ, OV>& i): queue(i.queue), pos(i.pos) {}
+
+			reference operator * () const { return (queue->slot(pos)); }
+			pointer operator -> () const { return &(queue->slot(pos)); }
+			reference operator [] (difference_type n) const { return (queue->slot(pos + n)); }
+
+			iterator_base& operator ++ () { pos += 1; return *this; }
+			iterator_base& operator -- () { pos -= 1; return *this; }
+			iterator_base operator ++ (int) { iterator_base i = *this; pos += 1; return i; }
+			iterator_base operator -- (int) { iterator_base i = *this; pos -= 1; return i; }
+
+			iterator_base& operator += (difference_type n) { pos += n; return *this; }
+			iterator_base& operator -= (difference_type n) { pos -= n; return *this; }
+
+			iterator_base operator + (difference_type n) const { return {queue, pos + n}; }
+			iterator_base operator - (difference_type n) const { return {queue, pos - n}; }
+
+			friend iterator_base operator + (difference_type n, const iterator_base& i) { return (i + n); }
+
+			// positions wrap around, so compare their (signed) distance
+			template<typename OQ, typename OV>
+			difference_type operator - (const iterator_base<OQ, OV>& i) const { return (static_cast<difference_type>(pos - i.pos)); }
+
+			template<typename OQ, typename OV> bool operator == (const iterator_base<OQ, OV>& i) const { return (pos == i.pos); }
+			template<typename OQ, typename OV> bool operator != (const iterator_base<OQ, OV>& i) const { return (pos != i.pos); }
+			template<typename OQ, typename OV> bool operator <  (const iterator_base<OQ, OV>& i) const { return ((*this - i) <  0); }
+			template<typename OQ, typename OV> bool operator >  (const iterator_base<OQ, OV>& i) const { return ((*this - i) >  0); }
+			template<typename OQ, typename OV> bool operator <= (const iterator_base<OQ, OV>& i) const { return ((*this - i) <= 0); }
+			template<typename OQ, typename OV> bool operator >= (const iterator_base<OQ, OV>& i) const { return ((*this - i) >= 0); }
+
+		private:
+			template<typename, typename> friend class iterator_base;
+			friend class ring_deque;
+
+			Q* queue = nullptr;
+			size_type pos = 0;
+		};
+
+		typedef iterator_base<ring_deque, T> iterator;
+		typedef iterator_base<const ring_deque, const T> const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	public:
+		bool empty() const { return (count == 0); }
+
+		size_type size() const { return count; }
+		size_type capacity() const { return slots.size(); }
+
+		void reserve(size_type n) {
+			if (n <= slots.size())
+				return;
+
+			size_type newCapacity = std::max(slots.size(), size_type(MIN_CAPACITY));
+
+			while (newCapacity < n)
+				newCapacity <<= 1;
+
+			std::vector<T> newSlots(newCapacity);
+
+			// head is kept so outstanding iterators remain valid
+			for (size_type i = 0; i < count; i++) {
+				newSlots[(head + i) & (newCapacity - 1)] = std::move(slot(head + i));
+			}
+
+			slots.swap(newSlots);
+		}
+
+		void resize(size_type n) {
+			reserve(n);
+
+			while (count > n)
+				pop_back();
+
+			// slots past the end already hold default-constructed elements
+			count = n;
+		}
+
+		void clear() {
+			while (count > 0)
+				pop_back();
+
+			head = 0;
+		}
+
+		void push_back(const T& v) {
+			if (count == slots.size()) {
+				// <v> might refer to one of our own elements
+				const T tmp = v;
+				reserve(count + 1);
+				slot(head + count) = tmp;
+			} else {
+				slot(head + count) = v;
+			}
+
+			count += 1;
+		}
+		void push_front(const T& v) {
+			if (count == slots.size()) {
+				const T tmp = v;
+				reserve(count + 1);
+				slot(head - 1) = tmp;
+			} else {
+				slot(head - 1) = v;
+			}
+
+			head -= 1;
+			count += 1;
+		}
+
+		void pop_back() {
+			assert(count > 0);
+			slot(head + (count -= 1)) = T();
+		}
+		void pop_front() {
+			assert(count > 0);
+			slot(head) = T();
+
+			head += 1;
+			count -= 1;
+		}
+
+		iterator insert(const_iterator it, const T& v) {
+			const size_type idx = it - cbegin();
+			const T tmp = v;
+
+			assert(idx <= count);
+
+			if (idx < (count >> 1)) {
+				// shift the front part down by one
+				push_front(front());
+
+				for (size_type i = 1; i < idx; i++) {
+					slot(head + i) = slot(head + i + 1);
+				}
+			} else {
+				push_back(tmp);
+
+				for (size_type i = count - 1; i > idx; i--) {
+					slot(head + i) = slot(head + i - 1);
+				}
+			}
+
+			slot(head + idx) = tmp;
+			return (begin() + idx);
+		}
+
+		iterator erase(const_iterator it) { return (erase(it, it + 1)); }
+		iterator erase(const_iterator first, const_iterator last) {
+			const size_type idx = first - cbegin();
+			const size_type num = last - first;
+
+			assert((idx + num) <= count);
+
+			if (num == 0)
+				return (begin() + idx);
+
+			if (idx < ((count - num) >> 1)) {
+				// shift the front part up
+				for (size_type i = idx; i > 0; i--) {
+					slot(head + i - 1 + num) = slot(head + i - 1);
+				}
+				for (size_type i = 0; i < num; i++) {
+					pop_front();
+				}
+			} else {
+				for (size_type i = idx + num; i < count; i++) {
+					slot(head + i - num) = slot(head + i);
+				}
+				for (size_type i = 0; i < num; i++) {
+					pop_back();
+				}
+			}
+
+			return (begin() + idx);
+		}
+
+		iterator       begin()       { return {this, head}; }
+		const_iterator begin() const { return {this, head}; }
+		iterator       end()         { return {this, head + count}; }
+		const_iterator end()   const { return {this, head + count}; }
+
+		const_iterator cbegin() const { return {this, head}; }
+		const_iterator cend()   const { return {this, head + count}; }
+
+		reverse_iterator       rbegin()       { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator       rend()         { return reverse_iterator(begin()); }
+		const_reverse_iterator rend()   const { return const_reverse_iterator(begin()); }
+
+		      T& front()       { assert(count > 0); return (slot(head)); }
+		const T& front() const { assert(count > 0); return (slot(head)); }
+		      T& back()        { assert(count > 0); return (slot(head + count - 1)); }
+		const T& back()  const { assert(count > 0); return (slot(head + count - 1)); }
+
+		      T& operator [] (size_type i)       { assert(i < count); return (slot(head + i)); }
+		const T& operator [] (size_type i) const { assert(i < count); return (slot(head + i)); }
+
+		      T& at(size_type i)       { if (i >= count) throw std::out_of_range("ring_deque::at"); return (slot(head + i)); }
+		const T& at(size_type i) const { if (i >= count) throw std::out_of_range("ring_deque::at"); return (slot(head + i)); }
+
+	private:
+		      T& slot(size_type pos)       { return slots[pos & (slots.size() - 1)]; }
+		const T& slot(size_type pos) const { return slots[pos & (slots.size() - 1)]; }
+
+	private:
+		static constexpr size_type MIN_CAPACITY = 8;
+
+		std::vector<T> slots;
+
+		// absolute position of the first element, wraps around
+		size_type head = 0;
+		size_type count = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,52 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SLIDING_WINDOW_MAX_H
+#define SLIDING_WINDOW_MAX_H
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace spring {
+	// for every i in [b, e] writes the maximum of src[i - r, i + r] (clamped to [0, n - 1])
+	// into dst[i - b]; the candidates are kept in a monotonic deque so the cost per element
+	// is O(1) amortized rather than O(r)
+	//
+	// <indices> is scratch space for the deque, it is resized as needed and can be re-used
+	// between calls to avoid allocations
+	static inline void SlidingWindowMax(const float* src, int n, int r, int b, int e, float* dst, std::vector<int>& indices)
+	{
+		assert(b >= 0 && e < n);
+
+		if (b > e)
+			return;
+
+		const int pushBeg = std::max(b - r, 0);
+		const int pushEnd = std::min(e + r, n - 1);
+
+		// every index is pushed at most once, so no wrap-around is needed
+		indices.resize(pushEnd - pushBeg + 1);
+
+		int* deque = indices.data();
+		int head = 0;
+		int tail = 0;
+		int next = pushBeg;
+
+		for (int i = b; i <= e; i++) {
+			for (const int winEnd = std::min(i + r, n - 1); next <= winEnd; next++) {
+				// values dominated by the new one can never become the maximum again
+				while (tail > head && src[deque[tail - 1]] <= src[next])
+					tail--;
+
+				deque[tail++] = next;
+			}
+
+			while (deque[head] < (i - r))
+				head++;
+
+			dst[i - b] = src[deque[head]];
+		}
+	}
+}
+
+#endif
@@ -22,12 +22,14 @@ namespace ThreadPool {
 	static inline void SetDefaultThreadCount() {}
 	static inline void SetThreadCount(int num) {}
 	static inline int GetThreadNum() { return 0; }
+	static inline void SetAuxThreadNum() {}
 	static inline int GetMaxThreads() { return 1; }
 	static inline int GetNumThreads() { return 1; }
 	static inline void NotifyWorkerThreads(bool force, bool async) {}
 	static inline bool HasThreads() { return false; }
 
 	static constexpr int MAX_THREADS = 1;
+	static constexpr int AUX_THREAD_NUM = 0;
 }
 
 template <typename F>
@@ -104,6 +106,8 @@ namespace ThreadPool {
 	void SetDefaultThreadCount();
 	void SetThreadCount(int num);
 	int GetThreadNum();
+	/// gives the calling (non-pool) thread the index reserved for it in per-thread data
+	void SetAuxThreadNum();
 	bool HasThreads();
 	int GetMaxThreads();
 	int GetNumThreads();
@@ -112,6 +116,8 @@ namespace ThreadPool {
 	extern bool inMultiThreadedSection;
 
 	static constexpr int MAX_THREADS = 32;
+	// last index is never given to pool workers; kept for a single long-lived auxiliary thread
+	static constexpr int AUX_THREAD_NUM = MAX_THREADS - 1;
 }
 
 
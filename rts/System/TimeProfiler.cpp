@@ -190,7 +190,8 @@ void CTimeProfiler::ResetState() {
 	sortedProfiles.clear();
 	#ifdef THREADPOOL
 	threadProfiles.clear();
-	threadProfiles.resize(ThreadPool::GetMaxThreads());
+	// not GetMaxThreads, the auxiliary (async AI) thread also runs SCOPED_MT_TIMER
+	threadProfiles.resize(ThreadPool::MAX_THREADS);
 	#endif
 
 	profileColorRNG.Seed(spring_tomsecs(lastBigUpdate = spring_gettime()));
@@ -0,0 +1,101 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef CREG_MEMORY_STREAM_H
+#define CREG_MEMORY_STREAM_H
+
+#include <cstring>
+#include <streambuf>
+#include <vector>
+
+namespace creg {
+	// stream buffers for serializing packages straight into (and out of) memory
+	// without going through a std::stringstream; SavePackage and LoadPackage use
+	// offsets relative to the start of the stream, so both can be positioned
+	// anywhere within a larger image
+
+	// read-only seekable view of [beg, end)
+	class CMemoryReadBuf: public std::streambuf {
+	public:
+		CMemoryReadBuf(const char* beg, const char* end) {
+			setg(const_cast<char*>(beg), const_cast<char*>(beg), const_cast<char*>(end));
+		}
+
+	protected:
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			char* pos = nullptr;
+
+			switch (dir) {
+				case std::ios_base::beg: { pos = eback() + off; } break;
+				case std::ios_base::cur: { pos = gptr()  + off; } break;
+				case std::ios_base::end: { pos = egptr() + off; } break;
+				default: {} break;
+			}
+
+			if (pos == nullptr || pos < eback() || pos > egptr())
+				return pos_type(off_type(-1));
+
+			setg(eback(), pos, egptr());
+			return pos_type(pos - eback());
+		}
+
+		pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+			return (seekoff(off_type(pos), std::ios_base::beg, which));
+		}
+	};
+
+
+	// appends to <image>; the stream starts at the image's size on construction
+	// and seeking back (e.g. to patch a package header) overwrites in place
+	class CMemoryWriteBuf: public std::streambuf {
+	public:
+		CMemoryWriteBuf(std::vector<char>& _image): image(_image), base(_image.size()), pos(_image.size()) {}
+
+	protected:
+		std::streamsize xsputn(const char* s, std::streamsize n) override {
+			if ((pos + n) > image.size())
+				image.resize(pos + n);
+
+			std::memcpy(image.data() + pos, s, n);
+			pos += n;
+			return n;
+		}
+
+		int_type overflow(int_type c) override {
+			if (traits_type::eq_int_type(c, traits_type::eof()))
+				return (traits_type::not_eof(c));
+
+			const char ch = traits_type::to_char_type(c);
+			xsputn(&ch, 1);
+			return c;
+		}
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+			off_type rel = -1;
+
+			switch (dir) {
+				case std::ios_base::beg: { rel =                 off; } break;
+				case std::ios_base::cur: { rel = (pos - base)  + off; } break;
+				case std::ios_base::end: { rel = (image.size() - base) + off; } break;
+				default: {} break;
+			}
+
+			if (rel < 0 || (base + rel) > image.size())
+				return pos_type(off_type(-1));
+
+			pos = base + rel;
+			return pos_type(rel);
+		}
+
+		pos_type seekpos(pos_type p, std::ios_base::openmode which) override {
+			return (seekoff(off_type(p), std::ios_base::beg, which));
+		}
+
+	private:
+		std::vector<char>& image;
+
+		size_t base;
+		size_t pos;
+	};
+}
+
+#endif
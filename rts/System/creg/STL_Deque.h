@@ -4,6 +4,7 @@
 #define CR_DEQUE_TYPE_IMPL_H
 
 #include "creg_cond.h"
+#include "System/RingDeque.hpp"
 
 #include <deque>
 
@@ -18,6 +19,13 @@ namespace creg
 			return std::unique_ptr<IType>(new DynamicArrayType< std::deque<T> >());
 		}
 	};
+
+	template<typename T>
+	struct DeduceType< spring::ring_deque<T> > {
+		static std::unique_ptr<IType> Get() {
+			return std::unique_ptr<IType>(new DynamicArrayType< spring::ring_deque<T> >());
+		}
+	};
 }
 
 #endif // USING_CREG
@@ -0,0 +1,238 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/ResourceSpotFinder.h"
+#include "lib/streflop/streflop_cond.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// the incremental scan and refilled best-spot list CResourceMapAnalyzer used before
+static void ReferenceSpots(
+	const std::vector<unsigned char>& resourceMap,
+	int mapWidth,
+	int mapHeight,
+	int radius,
+	int minValue,
+	int maxSpots,
+	std::vector<CResourceSpotFinder::Spot>& spots
+) {
+	const int totalCells = mapWidth * mapHeight;
+	const int doubleRadius = radius * 2;
+
+	std::vector<int> xend(doubleRadius + 1);
+	std::vector<unsigned char> rexArrayA = resourceMap;
+	std::vector<unsigned char> rexArrayB(totalCells);
+	std::vector<int> tempAverage(totalCells);
+
+	for (int a = 0; a < doubleRadius + 1; a++) {
+		const float z = a - radius;
+		const float squareRadius = radius * radius;
+		xend[a] = int(math::sqrt(squareRadius - z * z));
+	}
+
+	const auto CalcDiscSum = [&](int x, int y) {
+		int totalResources = 0;
+
+		if (x == 0 && y == 0) {
+			for (int sy = y - radius, a = 0; sy <= y + radius; sy++, a++) {
+				if (sy < 0 || sy >= mapHeight)
+					continue;
+
+				for (int sx = std::max(x - xend[a], 0); sx <= std::min(x + xend[a], mapWidth - 1); sx++) {
+					totalResources += rexArrayA[sy * mapWidth + sx];
+				}
+			}
+		}
+
+		if (x > 0) {
+			totalResources = tempAverage[y * mapWidth + x - 1];
+
+			for (int sy = y - radius, a = 0; sy <= y + radius; sy++, a++) {
+				if (sy < 0 || sy >= mapHeight)
+					continue;
+
+				if ((x + xend[a]) < mapWidth)
+					totalResources += rexArrayA[sy * mapWidth + x + xend[a]];
+				if ((x - xend[a] - 1) >= 0)
+					totalResources -= rexArrayA[sy * mapWidth + x - xend[a] - 1];
+			}
+		} else if (y > 0) {
+			totalResources = tempAverage[(y - 1) * mapWidth];
+
+			for (int sx = 0, a = radius; sx <= radius && sx < mapWidth; sx++, a++) {
+				if ((y - xend[a] - 1) >= 0)
+					totalResources -= rexArrayA[(y - xend[a] - 1) * mapWidth + sx];
+				if ((y + xend[a]) < mapHeight)
+					totalResources += rexArrayA[(y + xend[a]) * mapWidth + sx];
+			}
+		}
+
+		return (tempAverage[y * mapWidth + x] = totalResources);
+	};
+
+	int maxResource = 0;
+
+	for (int y = 0; y < mapHeight; y++) {
+		for (int x = 0; x < mapWidth; x++) {
+			maxResource = std::max(maxResource, CalcDiscSum(x, y));
+		}
+	}
+
+	if (maxResource == 0)
+		return;
+
+	for (int i = 0; i < totalCells; i++) {
+		rexArrayB[i] = tempAverage[i] * 255 / maxResource;
+	}
+
+	std::vector<int> bestSpotList;
+
+	int bestValue = 0;
+	int usedSpots = 0;
+
+	for (int n = 0; n < maxSpots; n++) {
+		int spotIndex = -1;
+
+		while (spotIndex < 0) {
+			if (usedSpots == int(bestSpotList.size())) {
+				// the list is empty now, refill it with (at most 256 of) the best spots
+				bestValue = *std::max_element(rexArrayB.begin(), rexArrayB.end());
+				usedSpots = 0;
+
+				bestSpotList.clear();
+
+				for (int i = 0; i < totalCells && bestSpotList.size() < 256; i++) {
+					if (rexArrayB[i] == bestValue)
+						bestSpotList.push_back(i);
+				}
+			}
+
+			if (rexArrayB[bestSpotList[usedSpots]] == bestValue)
+				spotIndex = bestSpotList[usedSpots];
+
+			usedSpots++;
+		}
+
+		if (bestValue < minValue)
+			break;
+
+		const int coordX = spotIndex % mapWidth;
+		const int coordZ = spotIndex / mapWidth;
+
+		spots.push_back({coordX, coordZ, bestValue});
+
+		for (int sy = coordZ - radius, a = 0; sy <= coordZ + radius; sy++, a++) {
+			if (sy < 0 || sy >= mapHeight)
+				continue;
+
+			for (int sx = std::max(coordX - xend[a], 0); sx <= std::min(coordX + xend[a], mapWidth - 1); sx++) {
+				rexArrayA[sy * mapWidth + sx] = 0;
+				rexArrayB[sy * mapWidth + sx] = 0;
+				tempAverage[sy * mapWidth + sx] = 0;
+			}
+		}
+
+		for (int y = std::max(coordZ - doubleRadius, 0); y <= std::min(coordZ + doubleRadius, mapHeight - 1); y++) {
+			for (int x = std::max(coordX - doubleRadius, 0); x <= std::min(coordX + doubleRadius, mapWidth - 1); x++) {
+				rexArrayB[y * mapWidth + x] = CalcDiscSum(x, y) * 255 / maxResource;
+			}
+		}
+	}
+}
+
+
+static std::vector<unsigned char> GenResourceMap(std::mt19937& rng, int mapWidth, int mapHeight, int numBlobs, int noise)
+{
+	std::vector<unsigned char> resourceMap(mapWidth * mapHeight, 0);
+
+	for (int n = 0; n < numBlobs; n++) {
+		const int bx = rng() % mapWidth;
+		const int bz = rng() % mapHeight;
+		const int br = rng() % 4;
+		const int bv = 1 + rng() % 255;
+
+		for (int z = std::max(bz - br, 0); z <= std::min(bz + br, mapHeight - 1); z++) {
+			for (int x = std::max(bx - br, 0); x <= std::min(bx + br, mapWidth - 1); x++) {
+				resourceMap[z * mapWidth + x] = bv;
+			}
+		}
+	}
+
+	if (noise > 0) {
+		for (unsigned char& v: resourceMap) {
+			v = std::max(int(v), int(rng() % noise));
+		}
+	}
+
+	return resourceMap;
+}
+
+static bool operator == (const CResourceSpotFinder::Spot& a, const CResourceSpotFinder::Spot& b) {
+	return (a.x == b.x && a.z == b.z && a.value == b.value);
+}
+
+static void CheckSpots(const std::vector<unsigned char>& resourceMap, int mapWidth, int mapHeight, int radius, int minValue, int maxSpots)
+{
+	std::vector<CResourceSpotFinder::Spot> expSpots;
+	std::vector<CResourceSpotFinder::Spot> resSpots;
+
+	ReferenceSpots(resourceMap, mapWidth, mapHeight, radius, minValue, maxSpots, expSpots);
+
+	CResourceSpotFinder spotFinder(resourceMap.data(), mapWidth, mapHeight, radius);
+	spotFinder.FindSpots(minValue, maxSpots, resSpots);
+
+	INFO("map=" << mapWidth << "x" << mapHeight << " radius=" << radius);
+	CHECK(resSpots.size() == expSpots.size());
+	CHECK(resSpots == expSpots);
+}
+
+
+
+TEST_CASE("ResourceSpotFinder")
+{
+	std::mt19937 rng(1234);
+
+	SECTION("matches the incremental scan on sparse maps") {
+		for (int iter = 0; iter < 200; iter++) {
+			const int mapWidth = 1 + rng() % 96;
+			const int mapHeight = 1 + rng() % 96;
+			const int radius = rng() % 12;
+
+			CheckSpots(GenResourceMap(rng, mapWidth, mapHeight, 1 + rng() % 40, 0), mapWidth, mapHeight, radius, 50, 10000);
+		}
+	}
+
+	SECTION("matches the incremental scan on noisy maps") {
+		for (int iter = 0; iter < 100; iter++) {
+			const int mapWidth = 1 + rng() % 64;
+			const int mapHeight = 1 + rng() % 64;
+			const int radius = rng() % 8;
+
+			CheckSpots(GenResourceMap(rng, mapWidth, mapHeight, rng() % 10, 1 + rng() % 64), mapWidth, mapHeight, radius, rng() % 100, 10000);
+		}
+	}
+
+	SECTION("uniform maps (many ties) and the spot limit") {
+		const std::vector<unsigned char> resourceMap(128 * 96, 20);
+
+		CheckSpots(resourceMap, 128, 96, 3, 50, 10000);
+		CheckSpots(resourceMap, 128, 96, 3, 50, 100);
+		CheckSpots(resourceMap, 128, 96, 0, 50, 10000);
+	}
+
+	SECTION("empty maps have no spots") {
+		const std::vector<unsigned char> resourceMap(64 * 64, 0);
+		std::vector<CResourceSpotFinder::Spot> spots;
+
+		CResourceSpotFinder spotFinder(resourceMap.data(), 64, 64, 4);
+		spotFinder.FindSpots(0, 10000, spots);
+
+		CHECK(spotFinder.GetMaxResource() == 0);
+		CHECK(spots.empty());
+	}
+}
@@ -0,0 +1,265 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/creg/creg_cond.h"
+#include "System/creg/MemoryStream.h"
+#include "System/creg/Serializer.h"
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+// a tiny deterministic "sim": entities move around, chase each other
+// (through pointers that must survive a restore) and spawn or die
+struct Entity {
+	CR_DECLARE(Entity)
+
+	virtual ~Entity() {}
+
+	int id = 0;
+	int health = 0;
+	float pos[2] = {0.0f, 0.0f};
+	float vel[2] = {0.0f, 0.0f};
+
+	Entity* target = nullptr;
+};
+
+CR_BIND(Entity, )
+CR_REG_METADATA(Entity, (
+	CR_MEMBER(id),
+	CR_MEMBER(health),
+	CR_MEMBER(pos),
+	CR_MEMBER(vel),
+	CR_MEMBER(target)
+))
+
+
+struct World {
+	CR_DECLARE_STRUCT(World)
+
+	void Init(unsigned int seed, int numEntities) {
+		randSeed = seed;
+
+		for (int i = 0; i < numEntities; i++) {
+			Spawn();
+		}
+	}
+
+	void Kill() {
+		for (Entity* e: entities) {
+			delete e;
+		}
+
+		entities.clear();
+		frameNum = 0;
+		nextID = 0;
+		randSeed = 0;
+	}
+
+	unsigned int Rand() { return ((randSeed = randSeed * 214013u + 2531011u) >> 16) & 0x7FFF; }
+	float RandFloat() { return (Rand() / 32767.0f); }
+
+	void Spawn() {
+		Entity* e = new Entity();
+		e->id = nextID++;
+		e->health = 50 + Rand() % 50;
+		e->pos[0] = RandFloat() * 1000.0f;
+		e->pos[1] = RandFloat() * 1000.0f;
+		e->vel[0] = RandFloat() - 0.5f;
+		e->vel[1] = RandFloat() - 0.5f;
+		entities.push_back(e);
+	}
+
+	void Update() {
+		frameNum += 1;
+
+		for (Entity* e: entities) {
+			if (e->target == nullptr && !entities.empty())
+				e->target = entities[Rand() % entities.size()];
+
+			if (e->target != nullptr && e->target != e) {
+				e->vel[0] += (e->target->pos[0] - e->pos[0]) * 0.001f;
+				e->vel[1] += (e->target->pos[1] - e->pos[1]) * 0.001f;
+				e->target->health -= (Rand() % 3);
+			}
+
+			e->pos[0] += e->vel[0];
+			e->pos[1] += e->vel[1];
+		}
+
+		// remove the dead, clearing references to them first
+		for (Entity* e: entities) {
+			if (e->target != nullptr && e->target->health <= 0)
+				e->target = nullptr;
+		}
+		for (size_t i = 0; i < entities.size(); ) {
+			if (entities[i]->health > 0) {
+				i++;
+				continue;
+			}
+
+			delete entities[i];
+			entities[i] = entities.back();
+			entities.pop_back();
+		}
+
+		if ((frameNum % 7) == 0)
+			Spawn();
+	}
+
+	unsigned int GetChecksum() const {
+		unsigned int checksum = frameNum * 31 + randSeed;
+
+		const auto Add = [&](const void* data, size_t size) {
+			for (size_t i = 0; i < size; i++) {
+				checksum = checksum * 33 + static_cast<const unsigned char*>(data)[i];
+			}
+		};
+
+		for (const Entity* e: entities) {
+			const int targetID = (e->target != nullptr)? e->target->id: -1;
+
+			Add(&e->id, sizeof(e->id));
+			Add(&e->health, sizeof(e->health));
+			Add(&e->pos[0], sizeof(e->pos));
+			Add(&e->vel[0], sizeof(e->vel));
+			Add(&targetID, sizeof(targetID));
+		}
+
+		return checksum;
+	}
+
+	std::vector<Entity*> entities;
+
+	int frameNum = 0;
+	int nextID = 0;
+
+	unsigned int randSeed = 0;
+};
+
+CR_BIND(World, )
+CR_REG_METADATA(World, (
+	CR_MEMBER(entities),
+	CR_MEMBER(frameNum),
+	CR_MEMBER(nextID),
+	CR_MEMBER(randSeed)
+))
+
+static World world;
+
+
+// same role as CGameStateCollector: serializes the global instance in place
+struct WorldCollector {
+	CR_DECLARE_STRUCT(WorldCollector)
+
+	void Serialize(creg::ISerializer* s) { s->SerializeObjectInstance(&world, world.GetClass()); }
+};
+
+CR_BIND(WorldCollector, )
+CR_REG_METADATA(WorldCollector, (
+	CR_SERIALIZER(Serialize)
+))
+
+
+static void TakeSnapshot(std::vector<char>& image)
+{
+	image.clear();
+
+	creg::CMemoryWriteBuf buf(image);
+	std::ostream stream(&buf);
+
+	creg::COutputStreamSerializer os;
+	WorldCollector wc;
+	os.SavePackage(&stream, &wc, wc.GetClass());
+}
+
+static void RestoreSnapshot(const std::vector<char>& image)
+{
+	world.Kill();
+
+	creg::CMemoryReadBuf buf(image.data(), image.data() + image.size());
+	std::istream stream(&buf);
+
+	creg::CInputStreamSerializer is;
+
+	void* root = nullptr;
+	creg::Class* rootCls = nullptr;
+
+	is.LoadPackage(&stream, root, rootCls);
+
+	REQUIRE(rootCls == WorldCollector::StaticClass());
+	delete static_cast<WorldCollector*>(root);
+}
+
+static std::vector<unsigned int> RunFrames(int numFrames)
+{
+	std::vector<unsigned int> checksums;
+
+	for (int i = 0; i < numFrames; i++) {
+		world.Update();
+		checksums.push_back(world.GetChecksum());
+	}
+
+	return checksums;
+}
+
+
+
+TEST_CASE("SimSnapshot")
+{
+	constexpr int NUM_FRAMES = 200;
+
+	std::vector<char> image;
+
+	world.Init(1234, 100);
+	RunFrames(50);
+
+	SECTION("snapshot, run, restore and run again gives identical checksums") {
+		TakeSnapshot(image);
+
+		const unsigned int snapChecksum = world.GetChecksum();
+		const std::vector<unsigned int> checksums = RunFrames(NUM_FRAMES);
+
+		// restoring must discard the divergent state
+		CHECK(world.GetChecksum() != snapChecksum);
+
+		RestoreSnapshot(image);
+		CHECK(world.GetChecksum() == snapChecksum);
+		CHECK(RunFrames(NUM_FRAMES) == checksums);
+
+		// and remain restorable any number of times
+		RestoreSnapshot(image);
+		CHECK(RunFrames(NUM_FRAMES) == checksums);
+	}
+
+	SECTION("target pointers are fixed up") {
+		TakeSnapshot(image);
+		RestoreSnapshot(image);
+
+		for (const Entity* e: world.entities) {
+			if (e->target == nullptr)
+				continue;
+
+			CHECK(std::find(world.entities.begin(), world.entities.end(), e->target) != world.entities.end());
+		}
+	}
+
+	SECTION("snapshots can be taken into a re-used image") {
+		TakeSnapshot(image);
+		const std::vector<char> first = image;
+
+		RunFrames(10);
+		TakeSnapshot(image);
+		RestoreSnapshot(first);
+		RunFrames(10);
+
+		std::vector<char> second;
+		TakeSnapshot(second);
+		CHECK(second == image);
+	}
+
+	world.Kill();
+}
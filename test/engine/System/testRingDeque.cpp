@@ -0,0 +1,105 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/RingDeque.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+
+template<typename A, typename B>
+static bool Equal(const A& a, const B& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	return (std::equal(a.begin(), a.end(), b.begin()) && std::equal(a.rbegin(), a.rend(), b.rbegin()));
+}
+
+
+TEST_CASE("RingDequeEnds")
+{
+	spring::ring_deque<int> q;
+
+	CHECK(q.empty());
+
+	for (int i = 0; i < 20; i++) {
+		q.push_back(i);
+		q.push_front(-i);
+	}
+
+	CHECK(q.size() == 40);
+	CHECK(q.front() == -19);
+	CHECK(q.back() == 19);
+	CHECK(q[20] == 0);
+	CHECK((q.end() - q.begin()) == 40);
+
+	// iterators refer to the same element after popping others
+	const auto it = q.begin() + 10;
+	const int val = *it;
+
+	q.pop_front();
+	q.pop_back();
+	q.push_back(100);
+
+	CHECK(*it == val);
+
+	// pushing an own element while growing
+	while (q.size() < q.capacity())
+		q.push_back(q.back());
+
+	q.push_back(q.front());
+	CHECK(q.back() == q.front());
+
+	q.clear();
+	CHECK(q.empty());
+}
+
+TEST_CASE("RingDequeMatchesDeque")
+{
+	std::mt19937 rng(1234);
+
+	spring::ring_deque<int> q;
+	std::deque<int> r;
+
+	for (int n = 0; n < 20000; n++) {
+		const int v = rng();
+
+		switch (rng() % 8) {
+			case 0: { q.push_back(v); r.push_back(v); } break;
+			case 1: { q.push_front(v); r.push_front(v); } break;
+			case 2: { if (!r.empty()) { q.pop_back(); r.pop_back(); } } break;
+			case 3: { if (!r.empty()) { q.pop_front(); r.pop_front(); } } break;
+			case 4:
+			case 5: {
+				const size_t i = rng() % (r.size() + 1);
+				const auto qi = q.insert(q.begin() + i, v);
+				const auto ri = r.insert(r.begin() + i, v);
+
+				CHECK((qi - q.begin()) == (ri - r.begin()));
+			} break;
+			case 6: {
+				if (r.empty())
+					break;
+
+				const size_t i = rng() % r.size();
+				const size_t j = i + rng() % (std::min(r.size() - i, size_t(4)) + 1);
+				const auto qi = q.erase(q.begin() + i, q.begin() + j);
+				const auto ri = r.erase(r.begin() + i, r.begin() + j);
+
+				CHECK((qi - q.begin()) == (ri - r.begin()));
+			} break;
+			case 7: {
+				if (rng() % 64 == 0) {
+					q.clear();
+					r.clear();
+				}
+			} break;
+		}
+
+		REQUIRE(Equal(q, r));
+	}
+}
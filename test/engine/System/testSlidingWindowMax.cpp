@@ -0,0 +1,145 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <xmmintrin.h> //SSE1
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "System/SlidingWindowMax.hpp"
+#include "System/TimeProfiler.h"
+#include "System/Misc/SpringTime.h"
+
+#define CATCH_CONFIG_MAIN
+#include "lib/catch.hpp"
+
+InitSpringTime ist;
+
+
+static void BruteForceMax(const float* src, int n, int r, int b, int e, float* dst)
+{
+	for (int i = b; i <= e; i++) {
+		float m = -std::numeric_limits<float>::max();
+
+		for (int j = std::max(i - r, 0), k = std::min(i + r, n - 1); j <= k; j++) {
+			m = std::max(m, src[j]);
+		}
+
+		dst[i - b] = m;
+	}
+}
+
+// the SSE scan SmoothHeightMesh used before, only exact for windows of at least four values
+static void SSEScanMax(const float* src, int n, int r, int b, int e, float* dst)
+{
+	for (int x = b; x <= e; ++x) {
+		const int startx = std::max(x - r, 0);
+		const int endIdx = std::min(x + r, n - 1) - 3;
+
+		__m128 best = _mm_loadu_ps(&src[startx]);
+
+		for (int i = startx + 4; i < endIdx; i += 4) {
+			best = _mm_max_ps(best, _mm_loadu_ps(&src[i]));
+		}
+
+		best = _mm_max_ps(best, _mm_loadu_ps(&src[endIdx]));
+		best = _mm_max_ps(best, _mm_movehl_ps(best, best));
+		best = _mm_max_ss(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(0, 0, 0, 1)));
+
+		_mm_store_ss(&dst[x - b], best);
+	}
+}
+
+
+TEST_CASE("SlidingWindowMax")
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> heightDist(-100.0f, 500.0f);
+
+	std::vector<int> indices;
+
+	SECTION("matches a brute-force scan") {
+		for (int iter = 0; iter < 2000; iter++) {
+			const int n = 1 + rng() % 300;
+			const int r = rng() % 40;
+			const int b = rng() % n;
+			const int e = b + rng() % (n - b);
+
+			std::vector<float> src(n);
+			std::vector<float> exp(e - b + 1);
+			std::vector<float> res(e - b + 1);
+
+			// few distinct values so ties are common
+			for (float& v: src) {
+				v = ((iter & 1) != 0)? heightDist(rng): float(rng() % 8);
+			}
+
+			BruteForceMax(src.data(), n, r, b, e, exp.data());
+			spring::SlidingWindowMax(src.data(), n, r, b, e, res.data(), indices);
+
+			CHECK(res == exp);
+		}
+	}
+
+	SECTION("monotonic inputs") {
+		std::vector<float> src(100);
+		std::vector<float> res(100);
+		std::vector<float> exp(100);
+
+		for (int i = 0; i < 100; i++) { src[i] = i; }
+		BruteForceMax(src.data(), 100, 7, 0, 99, exp.data());
+		spring::SlidingWindowMax(src.data(), 100, 7, 0, 99, res.data(), indices);
+		CHECK(res == exp);
+
+		for (int i = 0; i < 100; i++) { src[i] = -i; }
+		BruteForceMax(src.data(), 100, 7, 0, 99, exp.data());
+		spring::SlidingWindowMax(src.data(), 100, 7, 0, 99, res.data(), indices);
+		CHECK(res == exp);
+	}
+}
+
+
+TEST_CASE("SlidingWindowMaxBenchmark")
+{
+	// one row of a 32x32 map's smooth-mesh at default resolution
+	constexpr int n = 32 * 64 / 2;
+	constexpr int numRows = 4096;
+
+	std::mt19937 rng(5678);
+	std::uniform_real_distribution<float> heightDist(-100.0f, 500.0f);
+
+	std::vector<float> src(n);
+	std::vector<float> sseRes(n);
+	std::vector<float> dqRes(n);
+	std::vector<int> indices;
+
+	for (float& v: src) {
+		v = heightDist(rng);
+	}
+
+	for (const int r: {4, 20, 80}) {
+		float sseSum = 0.0f;
+		float dqSum = 0.0f;
+
+		{
+			ScopedOnceTimer timer("SlidingWindowMax: SSE scan, r=" + std::to_string(r));
+
+			for (int row = 0; row < numRows; row++) {
+				SSEScanMax(src.data(), n, r, 0, n - 1, sseRes.data());
+				sseSum += sseRes[row % n];
+			}
+		}
+		{
+			ScopedOnceTimer timer("SlidingWindowMax: monotonic deque, r=" + std::to_string(r));
+
+			for (int row = 0; row < numRows; row++) {
+				spring::SlidingWindowMax(src.data(), n, r, 0, n - 1, dqRes.data(), indices);
+				dqSum += dqRes[row % n];
+			}
+		}
+
+		CHECK(sseRes == dqRes);
+		CHECK(sseSum == dqSum);
+	}
+}
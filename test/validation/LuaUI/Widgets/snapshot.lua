@@ -0,0 +1,86 @@
+function widget:GetInfo()
+return {
+	name    = "Snapshot-Test-Widget",
+	desc    = "Checks that /restoresnapshot replays the same sync checksums, needs modoption validatesnapshot=1",
+	author  = "Spring developers",
+	date    = "Oct. 2026",
+	license = "GNU GPL, v2 or later",
+	layer   = 0,
+	enabled = true,
+}
+end
+
+local snapshotFrame = 3600
+-- the running sync checksum is reset after frame 4096, from then on it only depends on the simulated state
+local firstFrame = 4097
+local lastFrame = firstFrame + 600
+
+local phaseKey = "SnapshotValidationPhase"
+local checksumsKey = "SnapshotValidationChecksums"
+
+local restored
+local checksums = {}
+
+local function Fail(msg)
+	Spring.Log("snapshot.lua", LOG.ERROR, msg)
+	Spring.SendCommands("quitforce")
+end
+
+function widget:Initialize()
+	if Spring.GetModOptions().validatesnapshot ~= "1" then
+		widgetHandler:RemoveWidget(self)
+		return
+	end
+	if Spring.GetSyncChecksum() == nil then
+		Fail("Engine was built without sync checks, can't validate snapshots!")
+		return
+	end
+
+	-- widgets are re-created by the restore, the config overlay lives as long as the process
+	restored = (Spring.GetConfigString(phaseKey, "") == "restored")
+
+	Spring.SendCommands("setmaxspeed " .. 1000,
+		"setminspeed " .. 1000,
+		"setminspeed 1")
+end
+
+function widget:GameFrame(n)
+	if n == snapshotFrame and not restored then
+		Spring.SendCommands("snapshot validation")
+	end
+
+	if n >= firstFrame and n <= lastFrame then
+		checksums[#checksums + 1] = Spring.GetSyncChecksum()
+	end
+
+	if n ~= lastFrame then
+		return
+	end
+
+	if not restored then
+		Spring.SetConfigString(checksumsKey, table.concat(checksums, ","), true)
+		Spring.SetConfigString(phaseKey, "restored", true)
+		Spring.SendCommands("restoresnapshot validation")
+		return
+	end
+
+	local expected = {}
+	for checksum in string.gmatch(Spring.GetConfigString(checksumsKey, ""), "[^,]+") do
+		expected[#expected + 1] = checksum
+	end
+
+	if #expected ~= #checksums then
+		Fail(string.format("Recorded %i checksums before and %i after the restore!", #expected, #checksums))
+		return
+	end
+
+	for i = 1, #checksums do
+		if checksums[i] ~= expected[i] then
+			Fail(string.format("Sync checksum mismatch at frame %i after the restore: %s, expected %s", firstFrame + i - 1, checksums[i], expected[i]))
+			return
+		end
+	end
+
+	Spring.Echo(string.format("Snapshot test passed: %i frames", #checksums))
+	Spring.SendCommands("quitforce")
+end
@@ -0,0 +1,79 @@
+#!/bin/sh
+
+set -e #abort on error
+
+if [ $# -lt 4 ]; then
+	echo "Usage: $0 Game Map AI AIversion"
+	exit 1
+fi
+GAME="$1"
+MAP="$2"
+AI="$3"
+AIVERSION="$4"
+
+cat <<EOD
+// a validation script for /snapshot + /restoresnapshot, see LuaUI/Widgets/snapshot.lua
+// runs $GAME with $AI $AIVERSION vs $AI $AIVERSION on $MAP, without a client since restoring reloads the host
+[GAME]
+{
+	IsHost=1;
+	MyPlayerName=TestMonkey;
+
+	Mapname=$MAP;
+	GameType=$GAME;
+
+	StartPosType=0;
+	[mapoptions]
+	{
+	}
+	[modoptions]
+	{
+		validatesnapshot=1;
+	}
+	NumRestrictions=0;
+	[RESTRICT]
+	{
+	}
+	[PLAYER0]
+	{
+		Name=TestMonkey;
+		Spectator=1;
+	}
+	[AI0]
+	{
+		Name=Bot1;
+		ShortName=$AI;
+		Version=$AIVERSION;
+		Team=0;
+		Host=0;
+	}
+	[AI1]
+	{
+		Name=Bot2;
+		ShortName=$AI;
+		Version=$AIVERSION;
+		Team=1;
+		Host=0;
+	}
+
+	[TEAM0]
+	{
+		TeamLeader=0;
+		AllyTeam=0;
+	}
+	[TEAM1]
+	{
+		TeamLeader=0;
+		AllyTeam=1;
+	}
+
+	[ALLYTEAM0]
+	{
+		NumAllies=0;
+	}
+	[ALLYTEAM1]
+	{
+		NumAllies=0;
+	}
+}
+EOD
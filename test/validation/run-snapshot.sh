@@ -0,0 +1,32 @@
+#!/bin/sh
+
+# runs a script made by prepare-snapshot.sh and checks the result logged by LuaUI/Widgets/snapshot.lua
+
+if [ $# -ne 2 ]; then
+	echo "Usage: $0 /path/to/spring-headless script.txt"
+	exit 1
+fi
+
+if [ ! -x "$1" ]; then
+	echo "Parameter 1 $1 isn't executable!"
+	exit 1
+fi
+
+# max 5 min cpu time
+ulimit -t 300
+
+"$1" --nocolor "$2"
+EXIT=$?
+
+if [ $EXIT -ne 0 ]; then
+	echo Spring exited with $EXIT
+	exit $EXIT
+fi
+
+if ! grep -q "Snapshot test passed" ~/.config/spring/infolog.txt; then
+	echo "Snapshot test failed, see infolog.txt"
+	exit 1
+fi
+
+echo Snapshot test passed
+exit 0